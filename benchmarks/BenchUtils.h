@@ -0,0 +1,116 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include "utils/AllocationTracker.h"
+#include "utils/PerfCounters.h"
+
+#include <algorithm>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace Bench
+{
+    /**
+     * @brief Stream buffer that discards everything written to it.
+     */
+    class NullBuffer : public std::streambuf
+    {
+        protected:
+            int overflow(int c) override { return c; }
+            std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+    };
+
+    /**
+     * @brief Redirects std::cout to a null buffer for the lifetime of the object,
+     * so benchmarks measure the engine and not the terminal.
+     */
+    class ScopedDiscardOutput
+    {
+        public:
+            ScopedDiscardOutput() : m_original(std::cout.rdbuf(&m_null)) {}
+            ~ScopedDiscardOutput() { std::cout.rdbuf(m_original); }
+
+            ScopedDiscardOutput(const ScopedDiscardOutput&) = delete;
+            ScopedDiscardOutput& operator=(const ScopedDiscardOutput&) = delete;
+
+        private:
+            NullBuffer m_null;
+            std::streambuf* m_original;
+    };
+
+    /**
+     * @brief Adds `allocs/iter` and `bytes/iter` counters to a benchmark, measured from
+     * construction until Report is called. Adds nothing unless built with USER_MGMT_TRACK_ALLOCATIONS.
+     */
+    class AllocationCounter
+    {
+        public:
+            AllocationCounter() : m_before(Utils::AllocationTracker::Snapshot().Total()) {}
+
+            void Report(benchmark::State& state) const
+            {
+                if (!Utils::AllocationTracker::IsEnabled())
+                    return;
+
+                const auto after = Utils::AllocationTracker::Snapshot().Total();
+                const double iterations = static_cast<double>(std::max<benchmark::IterationCount>(state.iterations(), 1));
+                state.counters["allocs/iter"] = static_cast<double>(after.allocations - m_before.allocations) / iterations;
+                state.counters["bytes/iter"] = static_cast<double>(after.bytes - m_before.bytes) / iterations;
+            }
+
+        private:
+            Utils::AllocationCounters m_before;
+    };
+
+    /**
+     * @brief Adds `cycles/iter`, `instructions/iter`, `IPC`, `cache-misses/iter` and
+     * `branch-misses/iter` counters to a benchmark, measured on the benchmark thread from
+     * construction until Report is called. Adds nothing where hardware counters are unavailable.
+     */
+    class PerfCounter
+    {
+        public:
+            PerfCounter() : m_before(Utils::PerfCounterGroup::ForCurrentThread().Read()) {}
+
+            void Report(benchmark::State& state) const
+            {
+                using Utils::PerfEvent;
+                const auto delta = Utils::PerfCounterGroup::ForCurrentThread().Read() - m_before;
+                const double iterations = static_cast<double>(std::max<benchmark::IterationCount>(state.iterations(), 1));
+                for (size_t event = 0; event < Utils::PerfCounts::EVENT_COUNT; ++event)
+                {
+                    if (delta.available[event])
+                    {
+                        const std::string name = Utils::PerfCounterGroup::EventName(static_cast<PerfEvent>(event));
+                        state.counters[name + "/iter"] = static_cast<double>(delta.values[event]) / iterations;
+                    }
+                }
+                if (delta.Has(PerfEvent::Cycles) && delta.Has(PerfEvent::Instructions))
+                    state.counters["IPC"] = delta.InstructionsPerCycle();
+            }
+
+        private:
+            Utils::PerfCounts m_before;
+    };
+
+    /**
+     * @brief Builds a task file body that creates users and exercises the mutating commands.
+     * Every line succeeds when run once against an empty state.
+     */
+    inline std::vector<std::string> MakeMixedTaskLines(size_t users)
+    {
+        std::vector<std::string> lines;
+        lines.reserve(users * 4);
+        for (size_t i = 0; i < users; ++i)
+        {
+            const std::string name = "user" + std::to_string(i);
+            lines.push_back("CREATE USER " + name);
+            lines.push_back("SEND MESSAGE " + name + " \"hello " + name + "\"");
+            lines.push_back("ADD USER " + name + " TO GROUP group" + std::to_string(i % 16));
+            lines.push_back("PING " + name + " 1");
+        }
+        return lines;
+    }
+}
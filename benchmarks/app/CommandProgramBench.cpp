@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>
+#include "BenchUtils.h"
+#include "app/CommandRegistry.h"
+#include "app/TasksParser.h"
+#include "app/TaskManager.h"
+#include "domain/SystemState.h"
+
+using namespace App;
+using namespace TasksTypes;
+
+// Executes a file through the legacy vector<unique_ptr<ICommand>> representation.
+static void BM_ExecuteCommandList(benchmark::State& state)
+{
+    Bench::ScopedDiscardOutput discard;
+    CommandRegistry registry;
+    TasksParser parser(registry);
+    const auto lines = Bench::MakeMixedTaskLines(static_cast<size_t>(state.range(0)));
+
+    size_t executed = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Domain::SystemState systemState;
+        ParsedTasks parsed = parser.ParseTasks("bench", lines);
+        state.ResumeTiming();
+
+        for (auto& command : parsed[0].second.commands)
+        {
+            command->execute(systemState);
+        }
+        executed += parsed[0].second.commands.size();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(executed));
+}
+BENCHMARK(BM_ExecuteCommandList)->Arg(1 << 10)->Arg(1 << 14)->Unit(benchmark::kMicrosecond);
+
+// Executes the same file through the contiguous CommandProgram and TaskManager's dispatch loop.
+static void BM_ExecuteCommandProgram(benchmark::State& state)
+{
+    Bench::ScopedDiscardOutput discard;
+    CommandRegistry registry;
+    TasksParser parser(registry);
+    TaskManager manager("");
+    const auto lines = Bench::MakeMixedTaskLines(static_cast<size_t>(state.range(0)));
+
+    size_t executed = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        manager.SetState(std::make_shared<Domain::SystemState>());
+        ParsedProgram parsed = parser.ParseProgram("bench", lines);
+        state.ResumeTiming();
+
+        manager.ExecuteProgram(parsed[0].second);
+        executed += parsed[0].second.records.size();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(executed));
+}
+BENCHMARK(BM_ExecuteCommandProgram)->Arg(1 << 10)->Arg(1 << 14)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,145 @@
+#include <benchmark/benchmark.h>
+#include "BenchUtils.h"
+#include "app/CommandRegistry.h"
+#include "app/TaskFileCompiler.h"
+#include "app/TaskFileLoader.h"
+#include "app/TasksParser.h"
+
+#include <malloc.h>
+
+#include <filesystem>
+#include <fstream>
+
+using namespace App;
+namespace fs = std::filesystem;
+
+namespace
+{
+    fs::path WriteTaskDirectory(const std::string& name, size_t users, bool compile)
+    {
+        auto dir = fs::temp_directory_path() / name;
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+
+        std::ofstream out(dir / "task.txt", std::ios::binary);
+        for (const auto& line : Bench::MakeMixedTaskLines(users))
+            out << line << "   # generated\n";
+        out.close();
+
+        if (compile)
+        {
+            CommandRegistry registry;
+            TaskFileCompiler(registry).CompileDirectory(dir.string());
+        }
+        return dir;
+    }
+
+    void LoadAndParse(benchmark::State& state, bool compiled)
+    {
+        const auto users = static_cast<size_t>(state.range(0));
+        auto dir = WriteTaskDirectory(compiled ? "umts_bench_binary" : "umts_bench_text", users, compiled);
+        CommandRegistry registry;
+        TasksParser parser(registry);
+        TaskFileLoader loader(dir.string());
+
+        for (auto _ : state)
+        {
+            for (const auto& source : loader.LoadAllSources())
+            {
+                auto parsed = source.compiled ? parser.BuildProgram(source.fileName, *source.compiled)
+                                              : parser.ParseProgram(source.fileName, source.lines);
+                benchmark::DoNotOptimize(parsed);
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(users * 4));
+        fs::remove_all(dir);
+    }
+
+    fs::path WriteManyTaskFiles(const std::string& name, size_t files, size_t users)
+    {
+        auto dir = fs::temp_directory_path() / name;
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        const auto lines = Bench::MakeMixedTaskLines(users);
+        for (size_t file = 0; file < files; ++file)
+        {
+            std::ofstream out(dir / ("task_" + std::to_string(1000 + file) + ".txt"), std::ios::binary);
+            for (const auto& line : lines)
+                out << line << "   # generated\n";
+        }
+        return dir;
+    }
+}
+
+// Load + parse of a text task file through TasksParser.
+static void BM_LoadParseTextTaskFile(benchmark::State& state)
+{
+    LoadAndParse(state, false);
+}
+BENCHMARK(BM_LoadParseTextTaskFile)->Arg(1 << 8)->Arg(1 << 12)->Unit(benchmark::kMicrosecond);
+
+// Load + build of the same file from its precompiled binary form.
+static void BM_LoadParseCompiledTaskFile(benchmark::State& state)
+{
+    LoadAndParse(state, true);
+}
+BENCHMARK(BM_LoadParseCompiledTaskFile)->Arg(1 << 8)->Arg(1 << 12)->Unit(benchmark::kMicrosecond);
+
+// Loads and parses a directory file by file like TaskManager does, keeping every program (as the
+// program cache would) and dropping each source once its file is done. Reports the parse
+// throughput and the heap left behind: bytes in use and free bytes trapped between them
+// (fragmentation). Arg 1 loads through TaskFileLoader::LoadSource, whose lines live in a per-file
+// arena; arg 0 uses one std::string per line as before.
+static void BM_ParseFragmentation(benchmark::State& state)
+{
+    const bool arena = state.range(0) != 0;
+    constexpr size_t files = 32;
+    constexpr size_t users = 1 << 10;
+    auto dir = WriteManyTaskFiles("umts_bench_fragmentation", files, users);
+    CommandRegistry registry;
+    TasksParser parser(registry);
+    TaskFileLoader loader(dir.string());
+    const auto entries = loader.ScanTaskFiles();
+
+    Bench::AllocationCounter allocations;
+    size_t inUse = 0;
+    size_t trapped = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        const auto baseline = mallinfo2();
+        state.ResumeTiming();
+
+        std::vector<TasksTypes::CommandProgram> programs;
+        for (const auto& entry : entries)
+        {
+            if (arena)
+            {
+                auto source = loader.LoadSource(entry);
+                programs.push_back(parser.CreateProgram(source->lines));
+            }
+            else
+            {
+                std::string content;
+                TaskFileLoader::ReadWholeFile(entry.path, content);
+                const auto lines = TaskFileLoader::SplitTaskLines(content);
+                programs.push_back(parser.CreateProgram(lines));
+            }
+        }
+
+        state.PauseTiming();
+        const auto after = mallinfo2();
+        inUse = after.uordblks - baseline.uordblks;
+        trapped = after.fordblks;
+        programs.clear();
+        malloc_trim(0);
+        state.ResumeTiming();
+    }
+    allocations.Report(state);
+    state.counters["heap_in_use_KiB"] = static_cast<double>(inUse) / 1024.0;
+    state.counters["heap_free_KiB"] = static_cast<double>(trapped) / 1024.0;
+    state.SetLabel(arena ? "arena" : "heap");
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(files * users * 4));
+    fs::remove_all(dir);
+}
+BENCHMARK(BM_ParseFragmentation)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
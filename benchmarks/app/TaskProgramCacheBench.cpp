@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+#include "BenchUtils.h"
+#include "app/TaskManager.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace App;
+namespace fs = std::filesystem;
+
+namespace
+{
+    constexpr size_t FILE_COUNT = 10000;
+
+    // Builds (once) a directory of small task files whose commands can be re-executed on every run.
+    const fs::path& TenThousandFileDirectory()
+    {
+        static const fs::path dir = []
+        {
+            auto path = fs::temp_directory_path() / "umts_bench_10k_files";
+            fs::remove_all(path);
+            fs::create_directories(path);
+            for (size_t i = 0; i < FILE_COUNT; ++i)
+            {
+                std::ofstream out(path / ("task" + std::to_string(i) + ".txt"), std::ios::binary);
+                out << "# generated task " << i << "\n"
+                    << "PING user" << i << " 1\n"
+                    << "GET GROUPS\n";
+            }
+            return path;
+        }();
+        return dir;
+    }
+
+    void SecondRun(benchmark::State& state, size_t cacheCapacity)
+    {
+        Bench::ScopedDiscardOutput discard;
+        TaskManager manager(TenThousandFileDirectory().string());
+        manager.SetState(std::make_shared<Domain::SystemState>());
+        manager.SetProgramCacheCapacity(cacheCapacity);
+        manager.RunTasksFromFiles();
+
+        for (auto _ : state)
+        {
+            manager.RunTasksFromFiles();
+        }
+        auto stats = manager.GetProgramCacheStats();
+        state.counters["cache_entries"] = static_cast<double>(stats.entries);
+        state.counters["cache_bytes"] = static_cast<double>(stats.bytes);
+        state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(FILE_COUNT));
+    }
+}
+
+// Re-run of an unchanged 10k-file directory with every program served from the cache.
+static void BM_SecondRunWithProgramCache(benchmark::State& state)
+{
+    SecondRun(state, TaskProgramCache::DEFAULT_CAPACITY_BYTES);
+}
+BENCHMARK(BM_SecondRunWithProgramCache)->Unit(benchmark::kMillisecond);
+
+// Same re-run with caching disabled, so every file is loaded and parsed again.
+static void BM_SecondRunWithoutProgramCache(benchmark::State& state)
+{
+    SecondRun(state, 0);
+}
+BENCHMARK(BM_SecondRunWithoutProgramCache)->Unit(benchmark::kMillisecond);
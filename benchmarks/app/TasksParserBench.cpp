@@ -0,0 +1,137 @@
+#include <benchmark/benchmark.h>
+#include "BenchUtils.h"
+#include "app/CommandRegistry.h"
+#include "app/TasksParser.h"
+
+#include <array>
+#include <string_view>
+#include <vector>
+
+using namespace App;
+
+namespace
+{
+    struct LineKind
+    {
+        const char* label;
+        const char* line;
+    };
+
+    // One representative line per command shape of the task grammar.
+    constexpr std::array<LineKind, 8> LINE_KINDS = {{
+        {"single_word", "GET USERS"},
+        {"one_arg", "CREATE USER alice"},
+        {"two_args", "PING alice 3"},
+        {"quoted_short", "SEND MESSAGE alice \"Hello\""},
+        {"quoted_long", "SEND MESSAGE alice \"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt\""},
+        {"group", "ADD USER alice TO GROUP administrators"},
+        {"group_remove", "REMOVE USER alice FROM GROUP administrators"},
+        {"history", "GET MESSAGE HISTORY alice"},
+    }};
+}
+
+// Parses one line of each shape with the parser combinator grammar.
+static void BM_ExtractCommandAndArgs(benchmark::State& state)
+{
+    const auto& kind = LINE_KINDS[static_cast<size_t>(state.range(0))];
+    const std::string line = kind.line;
+    state.SetLabel(kind.label);
+
+    Bench::AllocationCounter allocations;
+    Bench::PerfCounter perf;
+    for (auto _ : state)
+    {
+        auto parser = ExtractCommandAndArgs();
+        auto result = parser(line, 0);
+        benchmark::DoNotOptimize(result);
+    }
+    allocations.Report(state);
+    perf.Report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * line.size()));
+}
+BENCHMARK(BM_ExtractCommandAndArgs)->DenseRange(0, LINE_KINDS.size() - 1);
+
+// Parses a file of 1024 lines of each shape into a command program, the path task files take.
+// `allocs/line` is what a line costs once the per-file buffers (records, argument pool) are taken.
+static void BM_CreateProgram(benchmark::State& state)
+{
+    const auto& kind = LINE_KINDS[static_cast<size_t>(state.range(0))];
+    const std::vector<std::string_view> lines(1024, kind.line);
+    CommandRegistry registry;
+    TasksParser parser(registry);
+    state.SetLabel(kind.label);
+
+    Bench::AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        auto program = parser.CreateProgram(lines);
+        benchmark::DoNotOptimize(program);
+    }
+    allocations.Report(state);
+    if (Utils::AllocationTracker::IsEnabled())
+        state.counters["allocs/line"] = state.counters["allocs/iter"].value / static_cast<double>(lines.size());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * lines.size()));
+}
+BENCHMARK(BM_CreateProgram)->DenseRange(0, LINE_KINDS.size() - 1)->Unit(benchmark::kMicrosecond);
+
+// Trims and strips comments from typical task file lines.
+static void BM_CleanLine(benchmark::State& state)
+{
+    const std::array<std::string, 4> lines = {
+        "CREATE USER alice",
+        "   ADD USER alice TO GROUP admins   # trailing comment",
+        "# full comment line",
+        "\tSEND MESSAGE alice \"Hello\"\r",
+    };
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        auto cleaned = TasksParser::CleanLine(lines[i++ & 3]);
+        benchmark::DoNotOptimize(cleaned);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_CleanLine);
+
+// Looks up a command factory and builds the command object.
+static void BM_CreateCommand(benchmark::State& state)
+{
+    CommandRegistry registry;
+    const std::array<std::pair<std::string_view, std::vector<std::string_view>>, 4> commands = {{
+        {"CREATE USER", {"alice"}},
+        {"SEND MESSAGE", {"alice", "Hello"}},
+        {"ADD USER TO GROUP", {"alice", "admins"}},
+        {"GET USERS", {}},
+    }};
+
+    size_t i = 0;
+    Bench::AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        const auto& [name, args] = commands[i++ & 3];
+        auto command = registry.createCommand(name, args);
+        benchmark::DoNotOptimize(command);
+    }
+    allocations.Report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_CreateCommand);
+
+// Same lookup, producing the by-value command record used by CommandProgram.
+static void BM_CreateRecord(benchmark::State& state)
+{
+    CommandRegistry registry;
+    const std::array<std::string_view, 2> args = {"alice", "admins"};
+
+    Bench::AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        auto record = registry.createRecord("ADD USER TO GROUP", args);
+        benchmark::DoNotOptimize(record);
+    }
+    allocations.Report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_CreateRecord);
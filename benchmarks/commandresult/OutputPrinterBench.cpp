@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+#include "BenchUtils.h"
+#include "commandresult/OutputPrinter.h"
+
+#include <sstream>
+
+using CommandResult::OutputPrinter;
+
+namespace
+{
+    /**
+     * @brief Points OutputPrinter at the given stream for the lifetime of the object.
+     */
+    class ScopedPrinterStream
+    {
+        public:
+            explicit ScopedPrinterStream(std::ostream* stream) { OutputPrinter::SetOutputStream(stream); }
+            ~ScopedPrinterStream() { OutputPrinter::SetOutputStream(&std::cout); }
+    };
+}
+
+// Formats success lines into a stream whose buffer discards the bytes (formatting cost only).
+static void BM_OutputPrinter_SuccessToNullBuffer(benchmark::State& state)
+{
+    Bench::NullBuffer null;
+    std::ostream sink(&null);
+    ScopedPrinterStream scoped(&sink);
+    const std::string line = "CREATE USER alice";
+
+    for (auto _ : state)
+        OutputPrinter::PrintCommandSuccess(line);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_OutputPrinter_SuccessToNullBuffer);
+
+// Formats failure lines into an in-memory stream, reset every 4096 lines.
+static void BM_OutputPrinter_FailureToStringStream(benchmark::State& state)
+{
+    std::ostringstream sink;
+    ScopedPrinterStream scoped(&sink);
+    const std::string line = "ADD USER alice TO GROUP admins";
+    const std::string reason = "User already belong in that group";
+
+    size_t lines = 0;
+    for (auto _ : state)
+    {
+        OutputPrinter::PrintCommandFailure(line, reason);
+        if ((++lines & 4095) == 0)
+            sink.str({});
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_OutputPrinter_FailureToStringStream);
+
+// Result lines (GET USERS / GET MESSAGE HISTORY output) with the printer's discard sink.
+static void BM_OutputPrinter_ResultDiscarded(benchmark::State& state)
+{
+    ScopedPrinterStream scoped(nullptr);
+    const std::string line = "alice, bob, carol, dave";
+
+    for (auto _ : state)
+        OutputPrinter::PrintCommandResult(line);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_OutputPrinter_ResultDiscarded);
@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+#include "BenchUtils.h"
+#include "domain/Group.h"
+#include "domain/User.h"
+#include "domain/Message.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Domain;
+
+namespace
+{
+    std::vector<std::shared_ptr<User>> MakeUsers(size_t count)
+    {
+        std::vector<std::shared_ptr<User>> users;
+        users.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            users.push_back(std::make_shared<User>("member" + std::to_string(i)));
+        return users;
+    }
+
+    std::shared_ptr<Group> MakeGroup(const std::vector<std::shared_ptr<User>>& users)
+    {
+        auto group = std::make_shared<Group>("large");
+        for (const auto& user : users)
+            group->AddMembers(user);
+        return group;
+    }
+
+    void GroupSizes(benchmark::internal::Benchmark* bench)
+    {
+        bench->RangeMultiplier(4)->Range(1 << 8, 1 << 14);
+    }
+}
+
+// Checks membership of the last member (worst case) and of a non member.
+static void BM_Group_HasMember(benchmark::State& state)
+{
+    const auto users = MakeUsers(static_cast<size_t>(state.range(0)));
+    const auto group = MakeGroup(users);
+    const std::string_view last = users.back()->getUsername();
+
+    Bench::PerfCounter perf;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(group->hasMember(last));
+        benchmark::DoNotOptimize(group->hasMember("outsider"));
+    }
+    perf.Report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 2));
+}
+BENCHMARK(BM_Group_HasMember)->Apply(GroupSizes);
+
+// Adds one member to a large group and removes it again.
+static void BM_Group_AddRemoveMember(benchmark::State& state)
+{
+    const auto users = MakeUsers(static_cast<size_t>(state.range(0)));
+    const auto group = MakeGroup(users);
+    const auto newcomer = std::make_shared<User>("newcomer");
+
+    for (auto _ : state)
+    {
+        group->AddMembers(newcomer);
+        group->RemoveMember(newcomer);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 2));
+}
+BENCHMARK(BM_Group_AddRemoveMember)->Apply(GroupSizes);
+
+// Builds a group of N members from scratch.
+static void BM_Group_Fill(benchmark::State& state)
+{
+    const auto users = MakeUsers(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        auto group = MakeGroup(users);
+        benchmark::DoNotOptimize(group.get());
+        state.PauseTiming();
+        for (const auto& user : users)
+            group->RemoveMember(user);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * users.size()));
+}
+BENCHMARK(BM_Group_Fill)->Apply(GroupSizes)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+#include "domain/SystemState.h"
+#include "BenchUtils.h"
+
+#include <malloc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace Domain;
+
+namespace
+{
+    constexpr size_t GROUPS = 64;
+    constexpr size_t GROUP_MEMBERS = 32;
+
+    const char* ResourceName(int64_t kind)
+    {
+        switch (kind)
+        {
+            case 1: return "unsynchronized pool";
+            case 2: return "synchronized pool";
+            default: return "default";
+        }
+    }
+
+    // Heap in use, including the large chunks malloc maps directly (pool resources ask for those).
+    size_t HeapInUse()
+    {
+        const auto info = mallinfo2();
+        return info.uordblks + info.hblkhd;
+    }
+
+    double Milliseconds(std::chrono::steady_clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
+// Builds a whole state (users, 64 groups of 32 members and a message stream, one in 64 sent to a
+// group) on the default resource or on a pool resource, then destroys it. Reports the heap in use
+// once built, the global allocations per iteration (a pool takes whole chunks from the heap) and the
+// build and teardown times separately.
+static void BM_MemoryResource_Workload(benchmark::State& state)
+{
+    const int64_t kind = state.range(0);
+    const auto users = static_cast<size_t>(state.range(1));
+    const auto messages = static_cast<size_t>(state.range(2));
+    std::vector<std::string> names;
+    names.reserve(users);
+    for (size_t i = 0; i < users; ++i)
+        names.push_back("user" + std::to_string(i));
+    std::vector<std::string> groups;
+    for (size_t i = 0; i < GROUPS; ++i)
+        groups.push_back("group" + std::to_string(i));
+    state.SetLabel(ResourceName(kind));
+
+    Bench::AllocationCounter allocations;
+    double buildMs = 0;
+    double teardownMs = 0;
+    double heapMb = 0;
+    for (auto _ : state)
+    {
+        const size_t heapBefore = HeapInUse();
+        const auto start = std::chrono::steady_clock::now();
+        std::optional<std::pmr::unsynchronized_pool_resource> unsynchronized;
+        std::optional<std::pmr::synchronized_pool_resource> synchronized;
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource();
+        if (kind == 1)
+            resource = &unsynchronized.emplace();
+        else if (kind == 2)
+            resource = &synchronized.emplace();
+        std::chrono::steady_clock::time_point built;
+        {
+            SystemState systemState(resource);
+            for (const auto& name : names)
+                systemState.AddUser(systemState.NewUser(name));
+            for (size_t i = 0; i < std::min(users, GROUPS * GROUP_MEMBERS); ++i)
+                systemState.AddUserToGroup(names[i], groups[i % GROUPS]);
+            for (size_t i = 0; i < messages; ++i)
+            {
+                if (i % 64 == 0)
+                    systemState.SendMessageToGroup(groups[(i / 64) % GROUPS], Message("to the group " + std::to_string(i)));
+                else
+                    systemState.SendMessage(names[(i * 7919) % users], Message("hello there, message " + std::to_string(i)));
+            }
+            benchmark::DoNotOptimize(systemState.GetEpoch());
+
+            built = std::chrono::steady_clock::now();
+            heapMb += static_cast<double>(HeapInUse() - heapBefore) / (1024.0 * 1024.0);
+        }
+        unsynchronized.reset();
+        synchronized.reset();
+        buildMs += Milliseconds(built - start);
+        teardownMs += Milliseconds(std::chrono::steady_clock::now() - built);
+    }
+    const double iterations = static_cast<double>(std::max<benchmark::IterationCount>(state.iterations(), 1));
+    state.counters["build ms"] = buildMs / iterations;
+    state.counters["teardown ms"] = teardownMs / iterations;
+    state.counters["heap MB"] = heapMb / iterations;
+    allocations.Report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (users + messages)));
+}
+BENCHMARK(BM_MemoryResource_Workload)
+    ->ArgsProduct({{0, 1, 2}, {100000}, {1000000}})
+    ->ArgsProduct({{0, 1, 2}, {1000000}, {10000000}})
+    ->Iterations(1)->Unit(benchmark::kMillisecond);
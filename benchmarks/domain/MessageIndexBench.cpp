@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+#include "BenchUtils.h"
+#include "domain/SystemState.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Domain;
+
+namespace
+{
+    constexpr size_t USER_COUNT = 10000;
+
+    // Messages of 8 words drawn (skewed) from a 2000 word vocabulary.
+    std::vector<std::string> MakeTexts(size_t count)
+    {
+        std::mt19937 random(1);
+        std::vector<std::string> texts;
+        texts.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::string text;
+            for (int word = 0; word < 8; ++word)
+            {
+                const auto rank = static_cast<unsigned>(std::min(random() % 2000, random() % 2000));
+                text += (word ? " word" : "Word") + std::to_string(rank);
+            }
+            texts.push_back(std::move(text));
+        }
+        return texts;
+    }
+
+    void Populate(SystemState& state)
+    {
+        for (size_t i = 0; i < USER_COUNT; ++i)
+            state.AddUser(std::make_shared<User>("user" + std::to_string(i)));
+    }
+
+    const char* IndexLabel(bool indexed) { return indexed ? "indexed" : "no index"; }
+}
+
+// Ingest throughput of SEND MESSAGE with and without the inverted index, and the index size per message.
+static void BM_MessageIndex_Ingest(benchmark::State& state)
+{
+    const bool indexed = state.range(0) != 0;
+    const auto texts = MakeTexts(1024);
+    SystemState systemState;
+    Populate(systemState);
+    systemState.SetMessageIndexEnabled(indexed);
+    state.SetLabel(IndexLabel(indexed));
+
+    size_t i = 0;
+    size_t textBytes = 0;
+    for (auto _ : state)
+    {
+        const auto& text = texts[i % texts.size()];
+        systemState.SendMessage("user" + std::to_string(i % USER_COUNT), Message(text));
+        textBytes += text.size();
+        ++i;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    if (const auto* index = systemState.GetMessageIndex())
+    {
+        state.counters["index bytes/msg"] = static_cast<double>(index->MemoryUsage()) / static_cast<double>(i);
+        state.counters["index/text"] = static_cast<double>(index->MemoryUsage()) / static_cast<double>(textBytes);
+    }
+}
+BENCHMARK(BM_MessageIndex_Ingest)->Arg(0)->Arg(1);
+
+// Two-term AND query over 100k messages: postings intersection vs scanning every history.
+static void BM_MessageIndex_Search(benchmark::State& state)
+{
+    const bool indexed = state.range(0) != 0;
+    const auto texts = MakeTexts(100000);
+    SystemState systemState;
+    Populate(systemState);
+    systemState.SetMessageIndexEnabled(indexed);
+    for (size_t i = 0; i < texts.size(); ++i)
+        systemState.SendMessage("user" + std::to_string(i % USER_COUNT), Message(texts[i]));
+    state.SetLabel(IndexLabel(indexed));
+
+    size_t found = 0;
+    for (auto _ : state)
+    {
+        auto matches = systemState.SearchMessages("word3 word40");
+        found = matches.size();
+        benchmark::DoNotOptimize(matches.data());
+    }
+    state.counters["matches"] = static_cast<double>(found);
+}
+BENCHMARK(BM_MessageIndex_Search)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+#include "domain/MessageLog.h"
+
+#include <malloc.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Domain;
+
+namespace
+{
+    // Chat-like messages of 6..14 words drawn (skewed) from a 2000 word vocabulary.
+    std::vector<std::string> MakeTexts(size_t count)
+    {
+        std::mt19937 random(3);
+        std::vector<std::string> texts;
+        texts.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::string text;
+            const int words = 6 + static_cast<int>(random() % 9);
+            for (int word = 0; word < words; ++word)
+            {
+                const auto rank = static_cast<unsigned>(std::min(random() % 2000, random() % 2000));
+                text += (word ? " word" : "Word") + std::to_string(rank);
+            }
+            texts.push_back(std::move(text));
+        }
+        return texts;
+    }
+
+    const char* CompressionLabel(bool compressed) { return compressed ? "cold blocks compressed" : "all hot"; }
+
+    // Heap bytes in use, as seen by the allocator.
+    size_t HeapInUse()
+    {
+        return mallinfo2().uordblks;
+    }
+}
+
+// Heap held by 1M direct messages spread over 1000 histories, with and without sealing cold blocks.
+static void BM_MessageLog_Memory(benchmark::State& state)
+{
+    const bool compressed = state.range(0) != 0;
+    constexpr size_t USERS = 1000;
+    constexpr size_t MESSAGES = 1000000;
+    const auto texts = MakeTexts(4096);
+    MessageLog::SetCompressionEnabled(compressed);
+    state.SetLabel(CompressionLabel(compressed));
+
+    size_t textBytes = 0;
+    for (const auto& text : texts)
+        textBytes += text.size();
+    for (auto _ : state)
+    {
+        const size_t before = HeapInUse();
+        auto logs = std::make_unique<MessageLog[]>(USERS);
+        for (size_t i = 0; i < MESSAGES; ++i)
+            logs[i % USERS].Append(Message(texts[(i * 7) % texts.size()]), i);
+        const size_t used = HeapInUse() - before;
+
+        state.counters["heap bytes/msg"] = static_cast<double>(used) / MESSAGES;
+        state.counters["text bytes/msg"] = static_cast<double>(textBytes) / static_cast<double>(texts.size());
+        state.PauseTiming();
+        logs.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * MESSAGES));
+    MessageLog::SetCompressionEnabled(false);
+}
+BENCHMARK(BM_MessageLog_Memory)->Arg(0)->Arg(1)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+// Reads a 10k message history: all of it, its 20 newest (hot tail) or its 20 oldest (sealed) messages.
+static void BM_MessageLog_ReadHistory(benchmark::State& state)
+{
+    const bool compressed = state.range(0) != 0;
+    const auto range = state.range(1);
+    constexpr size_t MESSAGES = 10000;
+    constexpr size_t PAGE = 20;
+    const auto texts = MakeTexts(MESSAGES);
+    MessageLog::SetCompressionEnabled(compressed);
+    MessageLog log;
+    for (size_t i = 0; i < MESSAGES; ++i)
+        log.Append(Message(texts[i]), i);
+    MessageLog::SetCompressionEnabled(false);
+    state.SetLabel(std::string(CompressionLabel(compressed)) + (range == 0 ? ", all" : range == 1 ? ", newest 20" : ", oldest 20"));
+
+    const size_t first = range == 0 ? 0 : range == 1 ? MESSAGES - PAGE : 0;
+    const size_t last = range == 0 ? MESSAGES : first + PAGE;
+    for (auto _ : state)
+    {
+        size_t bytes = 0;
+        auto it = log.begin();
+        for (size_t i = 0; i < first; ++i)
+            ++it;
+        for (size_t i = first; i < last; ++i, ++it)
+            bytes += (*it).getContent().size();
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (last - first)));
+}
+BENCHMARK(BM_MessageLog_ReadHistory)->ArgsProduct({{0, 1}, {0, 1, 2}});
@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include "domain/SystemState.h"
+
+#include <malloc.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Domain;
+
+namespace
+{
+    constexpr size_t USERS = 10000;
+    constexpr size_t CHECKPOINT = 1000000;
+
+    double Megabytes(size_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); }
+
+    // Chat-like messages of 6..14 words drawn (skewed) from a 2000 word vocabulary.
+    std::vector<std::string> MakeTexts(size_t count)
+    {
+        std::mt19937 random(5);
+        std::vector<std::string> texts;
+        texts.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::string text;
+            const int words = 6 + static_cast<int>(random() % 9);
+            for (int word = 0; word < words; ++word)
+            {
+                const auto rank = static_cast<unsigned>(std::min(random() % 2000, random() % 2000));
+                text += (word ? " word" : "Word") + std::to_string(rank);
+            }
+            texts.push_back(std::move(text));
+        }
+        return texts;
+    }
+}
+
+// Soak: a steady stream of SEND MESSAGE to 10k users, without retention and keeping the newest
+// 50 messages per user. Heap in use is sampled every 1M messages (process RSS is not, as the
+// allocator keeps freed pages of earlier runs); with retention it stays bounded once every
+// history is full, moving with the block each history is filling.
+static void BM_Retention_Soak(benchmark::State& state)
+{
+    const bool retained = state.range(0) != 0;
+    const auto messages = static_cast<size_t>(state.range(1));
+    const auto texts = MakeTexts(65536);
+    std::vector<std::string> names;
+    for (size_t i = 0; i < USERS; ++i)
+        names.push_back("user" + std::to_string(i));
+    state.SetLabel(retained ? "keep newest 50" : "unbounded");
+
+    for (auto _ : state)
+    {
+        const size_t heapBefore = mallinfo2().uordblks;
+        SystemState systemState;
+        for (const auto& name : names)
+            systemState.AddUser(std::make_shared<User>(name));
+        if (retained)
+            systemState.SetRetentionPolicy({50, 0});
+
+        for (size_t i = 0; i < messages; ++i)
+        {
+            systemState.SendMessage(names[(i * 7919) % USERS], Message(texts[i % texts.size()]));
+            if ((i + 1) % CHECKPOINT == 0)
+                state.counters["heap MB @" + std::to_string((i + 1) / CHECKPOINT) + "M"] = Megabytes(mallinfo2().uordblks - heapBefore);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * messages));
+}
+BENCHMARK(BM_Retention_Soak)->ArgsProduct({{0, 1}, {5000000}})->Iterations(1)->Unit(benchmark::kMillisecond);
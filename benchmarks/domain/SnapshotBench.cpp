@@ -0,0 +1,119 @@
+#include <benchmark/benchmark.h>
+#include "domain/SystemState.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Domain;
+
+namespace
+{
+    std::vector<std::string> MakeNames(size_t count)
+    {
+        std::vector<std::string> names;
+        names.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            names.push_back("user" + std::to_string(i));
+        return names;
+    }
+
+    // One write of the background load: user churn plus messages to existing users.
+    void WriteOnce(SystemState& state, const std::vector<std::string>& names, size_t i)
+    {
+        if (i % 4 == 0)
+        {
+            const std::string name = "churn" + std::to_string(i % 64);
+            if (state.isUserExists(name))
+                state.DeleteUser(name);
+            else
+                state.AddUser(std::make_shared<User>(name));
+        }
+        else
+        {
+            state.SendMessage(names[(i * 7919) % names.size()], Message("load"));
+        }
+    }
+
+    void ReportWrites(benchmark::State& state, size_t writes, std::chrono::steady_clock::time_point start)
+    {
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        state.counters["writes/s"] = benchmark::Counter(static_cast<double>(writes) / seconds);
+    }
+}
+
+// Point reads (user lookup + history size) from the latest published version while a writer
+// thread mutates the state and publishes every 16 writes.
+static void BM_Snapshot_ReadUnderWriteLoad(benchmark::State& state)
+{
+    const auto names = MakeNames(static_cast<size_t>(state.range(0)));
+    SystemState systemState;
+    for (const auto& name : names)
+        systemState.AddUser(std::make_shared<User>(name));
+    systemState.Snapshot();
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> writes{0};
+    const auto start = std::chrono::steady_clock::now();
+    std::thread writer([&]()
+    {
+        size_t i = 0;
+        for (; !stop.load(std::memory_order_relaxed); ++i)
+        {
+            WriteOnce(systemState, names, i);
+            if (i % 16 == 15)
+                systemState.PublishPending();
+        }
+        writes = i;
+    });
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        const auto snapshot = systemState.LatestSnapshot();
+        benchmark::DoNotOptimize(snapshot->getMessageHistory(names[i++ % names.size()]).size());
+    }
+    stop = true;
+    writer.join();
+    ReportWrites(state, writes, start);
+}
+BENCHMARK(BM_Snapshot_ReadUnderWriteLoad)->Arg(10000)->Arg(100000)->UseRealTime();
+
+// Same reads and writes against the live state guarded by a reader/writer lock.
+static void BM_Locked_ReadUnderWriteLoad(benchmark::State& state)
+{
+    const auto names = MakeNames(static_cast<size_t>(state.range(0)));
+    SystemState systemState;
+    for (const auto& name : names)
+        systemState.AddUser(std::make_shared<User>(name));
+
+    std::shared_mutex mutex;
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> writes{0};
+    const auto start = std::chrono::steady_clock::now();
+    std::thread writer([&]()
+    {
+        size_t i = 0;
+        for (; !stop.load(std::memory_order_relaxed); ++i)
+        {
+            std::unique_lock lock(mutex);
+            WriteOnce(systemState, names, i);
+        }
+        writes = i;
+    });
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        std::shared_lock lock(mutex);
+        benchmark::DoNotOptimize(systemState.getMessageHistory(names[i++ % names.size()]).size());
+    }
+    stop = true;
+    writer.join();
+    ReportWrites(state, writes, start);
+}
+BENCHMARK(BM_Locked_ReadUnderWriteLoad)->Arg(10000)->Arg(100000)->UseRealTime();
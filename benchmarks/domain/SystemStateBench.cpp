@@ -0,0 +1,249 @@
+#include <benchmark/benchmark.h>
+#include "BenchUtils.h"
+#include "domain/SystemState.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Domain;
+
+namespace
+{
+    std::vector<std::string> MakeNames(size_t count)
+    {
+        std::vector<std::string> names;
+        names.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            names.push_back("user" + std::to_string(i));
+        return names;
+    }
+
+    void Populate(SystemState& state, const std::vector<std::string>& names)
+    {
+        for (const auto& name : names)
+            state.AddUser(std::make_shared<User>(name));
+    }
+
+    // Users added or deleted between two pauses of the timer.
+    constexpr size_t BATCH = 256;
+
+    // Every SystemState benchmark runs at 10^3 .. 10^6 existing users.
+    void UserCounts(benchmark::internal::Benchmark* bench)
+    {
+        bench->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kNanosecond);
+    }
+}
+
+// Adds a batch of extra users to a populated state. Building them and removing them again is
+// untimed, with one pause per batch so the timer overhead stays out of the per-user cost.
+static void BM_SystemState_AddUser(benchmark::State& state)
+{
+    const auto names = MakeNames(static_cast<size_t>(state.range(0)));
+    SystemState systemState;
+    Populate(systemState, names);
+
+    std::vector<std::string> newcomers;
+    for (size_t i = 0; i < BATCH; ++i)
+        newcomers.push_back("newcomer" + std::to_string(i));
+    auto makeBatch = [&]()
+    {
+        std::vector<std::shared_ptr<User>> users;
+        users.reserve(BATCH);
+        for (const auto& name : newcomers)
+            users.push_back(std::make_shared<User>(name));
+        return users;
+    };
+
+    auto batch = makeBatch();
+    while (state.KeepRunningBatch(BATCH))
+    {
+        for (const auto& user : batch)
+            systemState.AddUser(user);
+        state.PauseTiming();
+        for (const auto& name : newcomers)
+            systemState.DeleteUser(name);
+        batch = makeBatch();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_SystemState_AddUser)->Apply(UserCounts);
+
+// Looks up existing and missing users alternately.
+static void BM_SystemState_IsUserExists(benchmark::State& state)
+{
+    const auto names = MakeNames(static_cast<size_t>(state.range(0)));
+    SystemState systemState;
+    Populate(systemState, names);
+
+    size_t i = 0;
+    Bench::PerfCounter perf;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(systemState.isUserExists(names[i % names.size()]));
+        benchmark::DoNotOptimize(systemState.isUserExists("missing"));
+        ++i;
+    }
+    perf.Report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 2));
+}
+BENCHMARK(BM_SystemState_IsUserExists)->Apply(UserCounts);
+
+// Deletes a batch of users from a populated state. Re-adding them is untimed, with one pause
+// per batch.
+static void BM_SystemState_DeleteUser(benchmark::State& state)
+{
+    const auto names = MakeNames(static_cast<size_t>(state.range(0)));
+    SystemState systemState;
+    Populate(systemState, names);
+
+    size_t first = 0;
+    while (state.KeepRunningBatch(BATCH))
+    {
+        for (size_t i = 0; i < BATCH; ++i)
+            systemState.DeleteUser(names[(first + i) % names.size()]);
+        state.PauseTiming();
+        for (size_t i = 0; i < BATCH; ++i)
+            systemState.AddUser(std::make_shared<User>(names[(first + i) % names.size()]));
+        first += BATCH;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_SystemState_DeleteUser)->Apply(UserCounts);
+
+// Disables users of a populated state.
+static void BM_SystemState_DisableUser(benchmark::State& state)
+{
+    const auto names = MakeNames(static_cast<size_t>(state.range(0)));
+    SystemState systemState;
+    Populate(systemState, names);
+
+    size_t i = 0;
+    for (auto _ : state)
+        systemState.DisableUser(names[i++ % names.size()]);
+}
+BENCHMARK(BM_SystemState_DisableUser)->Apply(UserCounts);
+
+// Copies the whole user list, as GET USERS does.
+static void BM_SystemState_GetUsers(benchmark::State& state)
+{
+    const auto names = MakeNames(static_cast<size_t>(state.range(0)));
+    SystemState systemState;
+    Populate(systemState, names);
+
+    for (auto _ : state)
+    {
+        auto users = systemState.getUsers();
+        benchmark::DoNotOptimize(users.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * names.size()));
+}
+BENCHMARK(BM_SystemState_GetUsers)->Apply(UserCounts);
+
+// Copies the group list when every 16 users share a group.
+static void BM_SystemState_GetGroups(benchmark::State& state)
+{
+    const auto names = MakeNames(static_cast<size_t>(state.range(0)));
+    SystemState systemState;
+    Populate(systemState, names);
+    for (size_t i = 0; i < names.size(); ++i)
+        systemState.AddUserToGroup(names[i], "group" + std::to_string(i / 16));
+
+    for (auto _ : state)
+    {
+        auto groups = systemState.getGroups();
+        benchmark::DoNotOptimize(groups.data());
+    }
+}
+BENCHMARK(BM_SystemState_GetGroups)->Apply(UserCounts);
+
+// Adds and removes a user to and from a small group; state size is the number of users.
+static void BM_SystemState_AddRemoveGroupMember(benchmark::State& state)
+{
+    const auto names = MakeNames(static_cast<size_t>(state.range(0)));
+    SystemState systemState;
+    Populate(systemState, names);
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        const auto& name = names[i++ % names.size()];
+        systemState.AddUserToGroup(name, "admins");
+        systemState.RemoveUserFromGroup(name, "admins");
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 2));
+}
+BENCHMARK(BM_SystemState_AddRemoveGroupMember)->Apply(UserCounts);
+
+// Sends messages to random users of a populated state.
+static void BM_SystemState_SendMessage(benchmark::State& state)
+{
+    const auto names = MakeNames(static_cast<size_t>(state.range(0)));
+    SystemState systemState;
+    Populate(systemState, names);
+
+    size_t i = 0;
+    for (auto _ : state)
+        systemState.SendMessage(names[(i++ * 7919) % names.size()], Message("Hello there"));
+}
+BENCHMARK(BM_SystemState_SendMessage)->Apply(UserCounts);
+
+// Reads the message history of a user.
+static void BM_SystemState_GetMessageHistory(benchmark::State& state)
+{
+    const auto names = MakeNames(static_cast<size_t>(state.range(0)));
+    SystemState systemState;
+    Populate(systemState, names);
+    systemState.SendMessage(names.front(), Message("Hello there"));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(systemState.getMessageHistory(names.front()).size());
+}
+BENCHMARK(BM_SystemState_GetMessageHistory)->Apply(UserCounts);
+
+namespace
+{
+    const std::string BROADCAST_TEXT = "Maintenance window tonight from 22:00 to 23:30, please save your work";
+
+    void PopulateGroup(SystemState& state, const std::vector<std::string>& names, const std::string& groupName)
+    {
+        Populate(state, names);
+        for (const auto& name : names)
+            state.AddUserToGroup(name, groupName);
+    }
+}
+
+// Notifies a 10k member group the old way: one SEND MESSAGE per member, one body copy each.
+static void BM_SystemState_SendMessagePerMember(benchmark::State& state)
+{
+    const auto names = MakeNames(static_cast<size_t>(state.range(0)));
+    SystemState systemState;
+    PopulateGroup(systemState, names, "everyone");
+
+    Bench::AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        for (const auto& name : names)
+            systemState.SendMessage(name, Message(BROADCAST_TEXT));
+    }
+    allocations.Report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_SystemState_SendMessagePerMember)->Arg(10000)->Iterations(100)->Unit(benchmark::kMicrosecond);
+
+// Notifies the same group with SEND MESSAGE TO GROUP: the body is shared by every member.
+static void BM_SystemState_SendMessageToGroup(benchmark::State& state)
+{
+    const auto names = MakeNames(static_cast<size_t>(state.range(0)));
+    SystemState systemState;
+    PopulateGroup(systemState, names, "everyone");
+
+    Bench::AllocationCounter allocations;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(systemState.SendMessageToGroup("everyone", Message(BROADCAST_TEXT)));
+    allocations.Report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_SystemState_SendMessageToGroup)->Arg(10000)->Iterations(100)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,140 @@
+#include <benchmark/benchmark.h>
+#include "BenchUtils.h"
+#include "domain/UsernameIndex.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace Domain;
+
+namespace
+{
+    std::vector<std::string> MakeNames(size_t count)
+    {
+        std::vector<std::string> names;
+        names.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            names.push_back("user" + std::to_string(i));
+        return names;
+    }
+
+    // 10^3 .. 10^6 users; the prefix "user12" matches ~1% of them or fewer.
+    void UserCounts(benchmark::internal::Benchmark* bench)
+    {
+        bench->RangeMultiplier(10)->Range(1000, 1000000);
+    }
+
+    constexpr std::string_view PREFIX = "user12";
+    constexpr size_t PAGE_SIZE = 50;
+}
+
+// Prefix query through the ordered index: O(log n + k).
+static void BM_UsernameIndex_Prefix(benchmark::State& state)
+{
+    UsernameIndex index;
+    for (const auto& name : MakeNames(static_cast<size_t>(state.range(0))))
+        index.Insert(name);
+
+    Bench::AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        size_t matches = 0;
+        index.ForEachFrom(PREFIX, [&](std::string_view name) {
+            if (!name.starts_with(PREFIX))
+                return false;
+            ++matches;
+            return true;
+        });
+        benchmark::DoNotOptimize(matches);
+    }
+    allocations.Report(state);
+}
+BENCHMARK(BM_UsernameIndex_Prefix)->Apply(UserCounts);
+
+// The same query as it was answered before the index: scan the user map, filter, sort.
+static void BM_FullScanSort_Prefix(benchmark::State& state)
+{
+    std::unordered_map<std::string, int> users;
+    for (const auto& name : MakeNames(static_cast<size_t>(state.range(0))))
+        users.emplace(name, 0);
+
+    Bench::AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        std::vector<std::string_view> matches;
+        for (const auto& [name, user] : users)
+        {
+            if (std::string_view(name).starts_with(PREFIX))
+                matches.push_back(name);
+        }
+        std::sort(matches.begin(), matches.end());
+        benchmark::DoNotOptimize(matches.data());
+    }
+    allocations.Report(state);
+}
+BENCHMARK(BM_FullScanSort_Prefix)->Apply(UserCounts);
+
+// One page of a sorted listing starting after a name in the middle.
+static void BM_UsernameIndex_Page(benchmark::State& state)
+{
+    const auto names = MakeNames(static_cast<size_t>(state.range(0)));
+    UsernameIndex index;
+    for (const auto& name : names)
+        index.Insert(name);
+    const std::string after = names[names.size() / 2];
+
+    for (auto _ : state)
+    {
+        size_t listed = 0;
+        index.ForEachFrom(after, [&](std::string_view name) { return name == after || ++listed < PAGE_SIZE; });
+        benchmark::DoNotOptimize(listed);
+    }
+}
+BENCHMARK(BM_UsernameIndex_Page)->Apply(UserCounts);
+
+// The same page from a full scan: partial sort of every name after the cursor.
+static void BM_FullScanSort_Page(benchmark::State& state)
+{
+    const auto names = MakeNames(static_cast<size_t>(state.range(0)));
+    std::unordered_map<std::string, int> users;
+    for (const auto& name : names)
+        users.emplace(name, 0);
+    const std::string after = names[names.size() / 2];
+
+    for (auto _ : state)
+    {
+        std::vector<std::string_view> candidates;
+        for (const auto& [name, user] : users)
+        {
+            if (name > after)
+                candidates.push_back(name);
+        }
+        const size_t page = std::min(PAGE_SIZE, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(page), candidates.end());
+        benchmark::DoNotOptimize(candidates.data());
+    }
+}
+BENCHMARK(BM_FullScanSort_Page)->Apply(UserCounts);
+
+// Insert plus erase of one name, with and without a frozen version to copy from.
+static void BM_UsernameIndex_InsertErase(benchmark::State& state)
+{
+    UsernameIndex index;
+    for (const auto& name : MakeNames(static_cast<size_t>(state.range(0))))
+        index.Insert(name);
+    const bool freezeEachTime = state.range(1) != 0;
+    state.SetLabel(freezeEachTime ? "frozen" : "owned");
+
+    std::shared_ptr<const UsernameIndex> frozen;
+    for (auto _ : state)
+    {
+        if (freezeEachTime)
+            frozen = index.Freeze();
+        index.Insert("newcomer");
+        index.Erase("newcomer");
+    }
+}
+BENCHMARK(BM_UsernameIndex_InsertErase)->ArgsProduct({{1000, 1000000}, {0, 1}});
@@ -0,0 +1,144 @@
+#include <benchmark/benchmark.h>
+#include "BenchUtils.h"
+#include "utils/FlatStringMap.h"
+#include "utils/Hash.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    using Entry = std::shared_ptr<int>;
+
+    // The node-based map SystemState used before: lookups from a view build a std::string key.
+    struct NodeMap
+    {
+        std::unordered_map<std::string, Entry> map;
+
+        void Insert(std::string_view key, const Entry& value) { map.try_emplace(std::string(key), value); }
+        bool Contains(std::string_view key) const { return map.find(std::string(key)) != map.end(); }
+        void Erase(std::string_view key) { map.erase(std::string(key)); }
+    };
+
+    // The same node-based table with transparent hashing: no key is built, a node is still chased.
+    struct TransparentNodeMap
+    {
+        std::unordered_map<std::string, Entry, Utils::TransparentStringHash, Utils::TransparentStringEqual> map;
+
+        void Insert(std::string_view key, const Entry& value) { map.try_emplace(std::string(key), value); }
+        bool Contains(std::string_view key) const { return map.find(key) != map.end(); }
+        void Erase(std::string_view key) { map.erase(map.find(key)); }
+    };
+
+    struct FlatMap
+    {
+        Utils::FlatStringMap<Entry> map;
+
+        void Insert(std::string_view key, const Entry& value) { map.try_emplace(key, value); }
+        bool Contains(std::string_view key) const { return map.contains(key); }
+        void Erase(std::string_view key) { map.erase(key); }
+    };
+
+    std::vector<std::string> MakeKeys(size_t count, const std::string& prefix)
+    {
+        std::vector<std::string> keys;
+        keys.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            keys.push_back(prefix + std::to_string(i));
+        return keys;
+    }
+
+    // Shuffled views of present keys, replaced by absent ones at a rate of 100 - hit%.
+    std::vector<std::string_view> MakeQueries(const std::vector<std::string>& present, const std::vector<std::string>& absent, int64_t hitPercent)
+    {
+        std::mt19937 random(3);
+        std::vector<std::string_view> queries;
+        queries.reserve(present.size());
+        for (size_t i = 0; i < present.size(); ++i)
+        {
+            const size_t pick = random() % present.size();
+            queries.emplace_back(static_cast<int64_t>(random() % 100) < hitPercent ? present[pick] : absent[pick]);
+        }
+        return queries;
+    }
+}
+
+// Looks up string_view keys in a map of `range(0)` users with `range(1)`% hits.
+template <typename Map>
+static void BM_NameMap_Lookup(benchmark::State& state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto keys = MakeKeys(count, "user");
+    const auto missing = MakeKeys(count, "missing");
+    const auto queries = MakeQueries(keys, missing, state.range(1));
+    Map map;
+    const auto value = std::make_shared<int>(0);
+    for (const auto& key : keys)
+        map.Insert(key, value);
+
+    Bench::AllocationCounter allocations;
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(map.Contains(queries[next]));
+        next = next + 1 == queries.size() ? 0 : next + 1;
+    }
+    allocations.Report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_NameMap_Lookup, NodeMap)->ArgsProduct({{1000000}, {100, 50, 0}});
+BENCHMARK_TEMPLATE(BM_NameMap_Lookup, TransparentNodeMap)->ArgsProduct({{1000000}, {100, 50, 0}});
+BENCHMARK_TEMPLATE(BM_NameMap_Lookup, FlatMap)->ArgsProduct({{1000000}, {100, 50, 0}});
+
+// Fills an empty map with `range(0)` users, growing it from empty.
+template <typename Map>
+static void BM_NameMap_Insert(benchmark::State& state)
+{
+    const auto keys = MakeKeys(static_cast<size_t>(state.range(0)), "user");
+    const auto value = std::make_shared<int>(0);
+
+    Bench::AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        Map map;
+        for (const auto& key : keys)
+            map.Insert(key, value);
+        benchmark::DoNotOptimize(map);
+    }
+    allocations.Report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size()));
+}
+BENCHMARK_TEMPLATE(BM_NameMap_Insert, NodeMap)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_NameMap_Insert, TransparentNodeMap)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_NameMap_Insert, FlatMap)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+// Steady churn on a map of `range(0)` users: erases a random user and inserts it back.
+template <typename Map>
+static void BM_NameMap_EraseInsert(benchmark::State& state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto keys = MakeKeys(count, "user");
+    const auto queries = MakeQueries(keys, keys, 100);
+    Map map;
+    const auto value = std::make_shared<int>(0);
+    for (const auto& key : keys)
+        map.Insert(key, value);
+
+    Bench::AllocationCounter allocations;
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        map.Erase(queries[next]);
+        map.Insert(queries[next], value);
+        next = next + 1 == queries.size() ? 0 : next + 1;
+    }
+    allocations.Report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_NameMap_EraseInsert, NodeMap)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_NameMap_EraseInsert, TransparentNodeMap)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_NameMap_EraseInsert, FlatMap)->Arg(1000000);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+#include "app/LatencyMetrics.h"
+#include "utils/AllocationTracker.h"
+#include "utils/PerfCounters.h"
+
+namespace App
+{
+    /**
+     * @brief Options of a headless (non-interactive) run.
+     */
+    struct BatchOptions
+    {
+        std::string tasksPath = "../tasks";
+        std::string output = "-";
+        std::string tracePath;
+        unsigned threads = 1;
+        unsigned repeat = 1;
+        bool useCache = true;
+        bool compile = false;
+        bool watch = false;
+        bool atomicFiles = false;
+        bool indexMessages = false;
+        bool compressMessages = false;
+        size_t retainMessages = 0;
+        size_t retainBytes = 0;
+        bool perfCounters = false;
+        bool verbosePing = false;
+        bool help = false;
+    };
+
+    /**
+     * @brief Totals of a headless run, over every repetition.
+     */
+    struct BatchSummary
+    {
+        std::chrono::nanoseconds wallTime{0};
+        size_t files = 0;
+        size_t failedFiles = 0;
+        size_t rolledBackFiles = 0;
+        size_t commands = 0;
+        size_t peakResidentBytes = 0;
+        LatencyReport executeLatency;
+        LatencyReport parseLatency;
+        Utils::AllocationReport allocations;
+        std::optional<Utils::PerfReport> perf;
+    };
+
+    /**
+     * @brief Runs the task directory to completion without prompts, for batch jobs and measurements.
+     */
+    class BatchRunner
+    {
+        public:
+            static constexpr int EXIT_TASK_FAILURE = 1;
+            static constexpr int EXIT_USAGE_ERROR = 2;
+
+            explicit BatchRunner(BatchOptions options);
+
+            static BatchOptions ParseArguments(const std::vector<std::string>& arguments);
+            static void PrintUsage(std::ostream& out);
+            static void PrintSummary(std::ostream& out, const BatchSummary& summary);
+            static void PrintLatencyReport(std::ostream& out, const std::string& title, const LatencyReport& report);
+            static void PrintAllocationReport(std::ostream& out, const Utils::AllocationReport& report, size_t commands);
+            static void PrintPerfReport(std::ostream& out, const Utils::PerfReport& report);
+
+            int Run(const std::atomic<bool>& stopRequested);
+            const BatchSummary& GetSummary() const;
+
+        private:
+            BatchOptions m_options;
+            BatchSummary m_summary;
+    };
+}
@@ -4,13 +4,23 @@
 #include <memory>
 #include <unordered_map>
 #include <functional>
+#include <span>
+#include <string_view>
 #include <vector>
 
 #include "commands/ICommand.h"
+#include "commands/CommandRecord.h"
+#include "utils/Hash.h"
 
 namespace App
 {
-    using CommandFactory = std::function<std::unique_ptr<Commands::ICommand>(const std::vector<std::string>&)>;
+    /**
+     * @brief Arguments of a command line. The views stay valid as long as the program the
+     * command is created for (they point into its ArgumentPool), so commands may keep them.
+     */
+    using CommandArgs = std::span<const std::string_view>;
+    using CommandFactory = std::function<std::unique_ptr<Commands::ICommand>(CommandArgs)>;
+    using RecordFactory = std::function<Commands::CommandRecord(CommandArgs)>;
 
     class CommandRegistry
     {
@@ -20,9 +30,13 @@ namespace App
             ~CommandRegistry() = default;
 
             void registerCommand(const std::string& commandKey, CommandFactory command_task);
-            std::unique_ptr<Commands::ICommand> createCommand(const std::string& commandName, const std::vector<std::string>& args) const;
+            std::unique_ptr<Commands::ICommand> createCommand(std::string_view commandName, CommandArgs args) const;
+            Commands::CommandRecord createRecord(std::string_view commandName, CommandArgs args) const;
+            const RecordFactory& findRecordFactory(std::string_view commandName) const;
             std::vector<std::string> GetAllCommandRegistry() const;
         private:
-            std::unordered_map<std::string, CommandFactory> m_registryMap;
+            void registerBuiltin(const std::string& commandKey, RecordFactory record_task);
+
+            std::unordered_map<std::string, RecordFactory, Utils::TransparentStringHash, Utils::TransparentStringEqual> m_registryMap;
     };
 }
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "utils/Types.h"
+
+namespace App::CompiledTaskFormat
+{
+    inline constexpr const char* EXTENSION = ".umtb";
+    inline constexpr char MAGIC[4] = {'U', 'M', 'T', 'B'};
+    inline constexpr uint16_t VERSION = 1;
+
+    using TasksTypes::CompiledTasks;
+
+    std::string Serialize(const TasksTypes::CompiledCommands& commands, uint64_t sourceChecksum);
+    CompiledTasks Deserialize(std::string_view bytes);
+    uint64_t ReadSourceChecksum(std::string_view bytes);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <variant>
+#include "commands/CommandRecord.h"
+#include "utils/LatencyHistogram.h"
+
+namespace App
+{
+    /**
+     * @brief Latency summary per command (or line) type.
+     */
+    using LatencyReport = std::map<std::string, Utils::LatencySummary>;
+
+    /**
+     * @brief Line types told apart by LatencyMetrics: the index of each command record
+     * alternative (see Commands::COMMAND_RECORD_NAMES), then comment or blank lines.
+     */
+    inline constexpr size_t COMMENT_LINE_TYPE = std::variant_size_v<Commands::CommandRecord>;
+    inline constexpr size_t LINE_TYPE_COUNT = COMMENT_LINE_TYPE + 1;
+
+    /**
+     * @brief Latency histograms in a fixed array indexed by line type, so recording and merging
+     * never look up or allocate.
+     * Record is meant for a single thread; Merge may be called from several threads at once.
+     */
+    class LatencyMetrics
+    {
+        public:
+            LatencyMetrics() = default;
+            LatencyMetrics(const LatencyMetrics& other);
+            LatencyMetrics& operator=(const LatencyMetrics& other);
+
+            void Record(size_t type, std::chrono::nanoseconds latency) { m_histograms[type].Record(latency); }
+            void Merge(const LatencyMetrics& other);
+            void Reset();
+            LatencyReport GetReport() const;
+
+            static const char* TypeName(size_t type);
+
+        private:
+            std::array<Utils::LatencyHistogram, LINE_TYPE_COUNT> m_histograms;
+            mutable std::mutex m_mutex;
+    };
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "app/TaskManager.h"
+
+namespace App
+{
+    /**
+     * @brief Latency of a task file picked up by the watcher.
+     */
+    struct WatchedTaskReport
+    {
+        std::string fileName;
+        std::chrono::nanoseconds detectedToApplied{0};
+        std::chrono::nanoseconds writtenToApplied{0};
+        std::chrono::nanoseconds runTime{0};
+        RunStats stats;
+    };
+
+    /**
+     * @brief Watches the task directory with inotify and executes `.txt` task files as soon as
+     * they are closed after writing (or moved into the directory). Only available on Linux.
+     */
+    class TaskDirectoryWatcher
+    {
+        public:
+            TaskDirectoryWatcher(TaskManager& manager, std::string directoryPath);
+            ~TaskDirectoryWatcher();
+            TaskDirectoryWatcher(const TaskDirectoryWatcher&) = delete;
+            TaskDirectoryWatcher& operator=(const TaskDirectoryWatcher&) = delete;
+
+            bool Start();
+            void MarkProcessed(const std::vector<ExecutedTaskFile>& files);
+            size_t PollOnce(int timeoutMs);
+            void Run(const std::atomic<bool>& stopRequested);
+            const std::vector<WatchedTaskReport>& GetReports() const;
+
+        private:
+            bool ProcessFile(const std::string& fileName, std::chrono::steady_clock::time_point detectedAt);
+
+            TaskManager& m_manager;
+            std::string m_directoryPath;
+            int m_inotifyFd = -1;
+            std::unordered_map<std::string, uint64_t> m_processed;
+            std::vector<WatchedTaskReport> m_reports;
+    };
+}
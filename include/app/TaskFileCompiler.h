@@ -0,0 +1,22 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include "app/TasksParser.h"
+#include "app/CommandRegistry.h"
+
+namespace App
+{
+    class TaskFileCompiler
+    {
+        public:
+            explicit TaskFileCompiler(const CommandRegistry& registry);
+
+            bool CompileFile(const std::filesystem::path& sourcePath) const;
+            size_t CompileDirectory(const std::string& directoryPath) const;
+
+        private:
+            const CommandRegistry& m_registry;
+            TasksParser m_parser;
+    };
+}
@@ -3,6 +3,7 @@
 #include<string>
 #include<vector>
 #include<utility>
+#include<filesystem>
 
 namespace App
 {
@@ -11,8 +12,18 @@ namespace App
         public:
             explicit TaskFileLoader(const std::string& directoryPath_);
             TasksTypes::ListOfTaskFiles LoadAllTasks() const;
+            TasksTypes::ListOfTaskSources LoadAllSources() const;
+            TasksTypes::ListOfTaskFileEntries ScanTaskFiles() const;
+            std::optional<TasksTypes::TaskSource> LoadSource(const TasksTypes::TaskFileEntry& entry) const;
+            const std::string& GetDirectoryPath() const;
+
+            static std::optional<TasksTypes::TaskFileEntry> DescribeFile(const std::filesystem::path& path);
+            static std::vector<std::string> SplitTaskLines(std::string_view content);
+            static TasksTypes::TaskLines SplitTaskLineViews(std::string_view content, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+            static bool ReadWholeFile(const std::filesystem::path& path, std::string& content);
+            static bool ReadWholeFile(const std::filesystem::path& path, std::pmr::string& content);
 
         private:
             std::string m_directoryPath;
     };
-}
\ No newline at end of file
+}
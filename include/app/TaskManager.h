@@ -3,14 +3,39 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <exception>
+#include <optional>
 #include "domain/SystemState.h"
 #include "app/TaskFileLoader.h"
 #include "app/TasksParser.h"
+#include "app/TaskProgramCache.h"
+#include "app/LatencyMetrics.h"
 #include "commands/ICommand.h"
 #include "utils/Types.h"
+#include "utils/PerfCounters.h"
 
 namespace App
 {
+    /**
+     * @brief Counters of the last run.
+     */
+    struct RunStats
+    {
+        size_t files = 0;
+        size_t failedFiles = 0;
+        size_t rolledBackFiles = 0;
+        size_t commands = 0;
+    };
+
+    /**
+     * @brief A task file executed by the last run, with the hash of the contents that ran.
+     */
+    struct ExecutedTaskFile
+    {
+        std::string fileName;
+        uint64_t contentHash = 0;
+    };
+
     class TaskManager
     {
         public:
@@ -19,11 +44,46 @@ namespace App
             void SetState(std::shared_ptr<Domain::SystemState> state);
             void UpdateTasksPath(const std::string& newPath);
             void RunTasksFromFiles();
+            bool RunTaskFile(const std::filesystem::path& taskFilePath);
+            const std::string& GetTasksPath() const;
+            size_t CompileTaskFiles() const;
+            void SetProgramCacheCapacity(size_t capacityBytes);
+            ProgramCacheStats GetProgramCacheStats() const;
+            void SetWorkerThreads(unsigned threads);
+            void SetAtomicFiles(bool atomic);
+            const RunStats& GetLastRunStats() const;
+            const std::vector<ExecutedTaskFile>& GetLastRunFiles() const;
+            bool ExecuteProgram(TasksTypes::CommandProgram& program);
+            LatencyReport GetExecuteLatencyReport() const;
+            LatencyReport GetParseLatencyReport() const;
+            void ResetLatencyMetrics();
+            void SetPerfCountersEnabled(bool enabled);
+            const Utils::PerfReport& GetPerfReport() const;
 
         private:
+            struct PreparedTask
+            {
+                bool attempted = false;
+                std::optional<TasksTypes::TaskSource> source;
+                TasksTypes::CommandProgram program;
+                std::exception_ptr error;
+            };
+
+            void PrepareInParallel(const TasksTypes::ListOfTaskFileEntries& entries, std::vector<PreparedTask>& prepared);
+            bool RunTaskEntry(const TasksTypes::TaskFileEntry& entry, PreparedTask* prepared = nullptr);
+            Utils::PerfCounts* PerfTarget(Utils::PerfReport& report, Utils::PerfPhase phase);
+
             std::shared_ptr<Domain::SystemState> m_state;
             std::unique_ptr<App::TaskFileLoader> m_loader;
             std::unique_ptr<App::TasksParser> m_parser;
             App::CommandRegistry m_registry;
+            App::TaskProgramCache m_programCache;
+            unsigned m_workerThreads = 1;
+            bool m_atomicFiles = false;
+            RunStats m_lastRun;
+            std::vector<ExecutedTaskFile> m_lastRunFiles;
+            LatencyMetrics m_executeLatency;
+            bool m_perfEnabled = false;
+            Utils::PerfReport m_perfReport;
     };
 }
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "utils/Types.h"
+
+namespace App
+{
+    /**
+     * @brief Counters describing the parsed program cache.
+     */
+    struct ProgramCacheStats
+    {
+        size_t entries = 0;
+        size_t bytes = 0;
+        size_t capacityBytes = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+
+    /**
+     * @brief LRU cache of parsed command programs keyed by task file path.
+     * An entry is reused while the file keeps its size and last write time, or while its
+     * contents hash to the same value. Memory is bounded by an approximate byte budget.
+     */
+    class TaskProgramCache
+    {
+        public:
+            using ProgramPtr = std::shared_ptr<TasksTypes::CommandProgram>;
+
+            static constexpr size_t DEFAULT_CAPACITY_BYTES = 256u * 1024u * 1024u;
+
+            explicit TaskProgramCache(size_t capacityBytes = DEFAULT_CAPACITY_BYTES);
+
+            ProgramPtr Find(const TasksTypes::TaskFileEntry& entry, uint64_t* contentHash = nullptr);
+            bool Contains(const TasksTypes::TaskFileEntry& entry) const;
+            ProgramPtr FindByContent(const TasksTypes::TaskFileEntry& entry, uint64_t contentHash);
+            ProgramPtr Insert(const TasksTypes::TaskFileEntry& entry, uint64_t contentHash,
+                                TasksTypes::CommandProgram program, size_t sourceBytes);
+            void RetainOnly(const std::unordered_set<std::string>& paths);
+            void SetCapacity(size_t capacityBytes);
+            void Clear();
+            ProgramCacheStats GetStats() const;
+
+        private:
+            struct Entry
+            {
+                std::string path;
+                uintmax_t size = 0;
+                std::filesystem::file_time_type lastWrite{};
+                uint64_t contentHash = 0;
+                size_t bytes = 0;
+                ProgramPtr program;
+            };
+            using EntryList = std::list<Entry>;
+
+            void Touch(EntryList::iterator itr);
+            void Erase(EntryList::iterator itr);
+            void EvictToCapacity();
+
+            EntryList m_lru;
+            std::unordered_map<std::string, EntryList::iterator> m_index;
+            ProgramCacheStats m_stats;
+    };
+}
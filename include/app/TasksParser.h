@@ -1,6 +1,8 @@
 #pragma once
 
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <utility>
@@ -8,6 +10,7 @@
 #include "commands/ICommand.h"
 #include "CommandRegistry.h"
 #include "utils/Types.h"
+#include "app/LatencyMetrics.h"
 
 namespace App
 {
@@ -18,10 +21,21 @@ namespace App
             explicit TasksParser(const CommandRegistry& registry);
 
             TasksTypes::ParsedTasks ParseTasks(const std::string& fileName, const std::vector<std::string>& rawTasks) const;
+            TasksTypes::ParsedProgram ParseProgram(const std::string& fileName, const std::vector<std::string>& rawTasks) const;
+            TasksTypes::ParsedProgram ParseProgram(const std::string& fileName, std::span<const std::string_view> rawTasks) const;
+            TasksTypes::ParsedProgram BuildProgram(const std::string& fileName, const TasksTypes::CompiledTasks& compiled) const;
+            TasksTypes::CompiledCommands TokenizeTasks(std::span<const std::string_view> rawTasks) const;
+            TasksTypes::CommandProgram CreateProgram(const std::vector<std::string>& rawTasks) const;
+            TasksTypes::CommandProgram CreateProgram(std::span<const std::string_view> rawTasks) const;
+            TasksTypes::CommandProgram CreateProgram(const TasksTypes::CompiledTasks& compiled) const;
+            static std::string_view CleanLine(std::string_view line);
+            LatencyReport GetParseLatencyReport() const;
+            void ResetParseLatency();
 
         private:
             const CommandRegistry& m_registry;
-            std::string CleanLine(const std::string &line) const;
+            mutable LatencyMetrics m_parseLatency;
+            void TokenizeLine(std::string_view cleanLine, std::string& commandName, std::vector<std::string_view>& args) const;
     };
 
 
@@ -29,9 +43,9 @@ namespace App
     parsec::Parser<char> char_p_if(std::function<bool(char)> condition, std::string msg);
     parsec::Parser<std::string> spaces();
     parsec::Parser<std::string> spaces1();
-    parsec::Parser<std::string> word_parser();
-    parsec::Parser<std::string> quoted_string_parser();
+    parsec::Parser<std::string_view> word_parser();
+    parsec::Parser<std::string_view> quoted_string_parser();
     parsec::Parser<TasksTypes::TaskFile> ExtractCommandAndArgs();
-    parsec::Parser<std::string> uppercase_word_parser();
+    parsec::Parser<std::string_view> uppercase_word_parser();
     parsec::Parser<std::string> command_name_parser();
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <iostream>
+#include <chrono>
 
 namespace CommandResult
 {
@@ -13,6 +14,11 @@ namespace CommandResult
             static void PrintCommandFailure(const std::string& commandLine, const std::string& failure);
             static void PrintTaskStart(const std::string& taskName);
             static void PrintTaskFailure(const std::string& taskName);
+            static void PrintTaskRollback(const std::string& taskName, size_t changesUndone);
             static void PrintTaskSuccess(const std::string& taskName);
+            static void SetOutputStream(std::ostream* stream);
+            static std::ostream& Stream();
+            static void PrintWatchedTask(const std::string& taskName, std::chrono::nanoseconds detectedToApplied,
+                                            std::chrono::nanoseconds writtenToApplied);
     };
 }
\ No newline at end of file
@@ -1,20 +1,21 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include "commands/ICommand.h"
 #include "domain/SystemState.h"
 
 namespace Commands
 {
-    class AddUserToGroupCommand : public ICommand
+    class AddUserToGroupCommand final : public ICommand
     {
         public:
-            explicit AddUserToGroupCommand(std::string username_, std::string groupName_);
+            explicit AddUserToGroupCommand(std::string_view username_, std::string_view groupName_);
 
             void execute(Domain::SystemState& state) override;
 
         private:
-            std::string m_username;
-            std::string m_groupname;
+            std::string_view m_username;
+            std::string_view m_groupname;
     };
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <type_traits>
+#include <variant>
+
+#include "commands/ICommand.h"
+#include "commands/AddUserToGroupCommand.h"
+#include "commands/CreateUserCommand.h"
+#include "commands/DelateUserCommand.h"
+#include "commands/DisableUserCommand.h"
+#include "commands/ExitCommand.h"
+#include "commands/GetGroupsCommand.h"
+#include "commands/GetMessageHistoryCommand.h"
+#include "commands/GetPingStatsCommand.h"
+#include "commands/GetStatsCommand.h"
+#include "commands/GetUsersCommand.h"
+#include "commands/PingCommand.h"
+#include "commands/RemoveUserFromGroupCommand.h"
+#include "commands/SearchMessagesCommand.h"
+#include "commands/SendGroupMessageCommand.h"
+#include "commands/SendMessageCommand.h"
+#include "utils/CommandStrings.h"
+
+namespace Commands
+{
+    /**
+     * @brief Tagged, by-value representation of a parsed command.
+     * Built-in commands are stored inline so a program is one contiguous array; commands
+     * registered from outside the registry keep using the ICommand extension point.
+     */
+    using CommandRecord = std::variant<
+        AddUserToGroupCommand,
+        CreateUserCommand,
+        DeleteUserCommand,
+        DisableUserCommand,
+        ExitCommand,
+        GetGroupsCommand,
+        GetMessageHistoryCommand,
+        GetPingStatsCommand,
+        GetStatsCommand,
+        GetUsersCommand,
+        PingCommand,
+        RemoveUserFromGroupCommand,
+        SearchMessagesCommand,
+        SendGroupMessageCommand,
+        SendMessageCommand,
+        std::unique_ptr<ICommand>>;
+
+    /**
+     * @brief Command name of each CommandRecord alternative, indexed by CommandRecord::index().
+     */
+    inline constexpr std::array<const char*, std::variant_size_v<CommandRecord>> COMMAND_RECORD_NAMES = {
+        CMD::CMD_ADD_USER_TO_GROUP,
+        CMD::CMD_CREATE_USER,
+        CMD::CMD_DELETE_USER,
+        CMD::CMD_DISABLE_USER,
+        CMD::CMD_EXIT,
+        CMD::CMD_GET_GROUPS,
+        CMD::CMD_GET_MESSAGE_HISTORY,
+        CMD::CMD_GET_PING_STATS,
+        CMD::CMD_GET_STATS,
+        CMD::CMD_GET_USERS,
+        CMD::CMD_PING,
+        CMD::CMD_REMOVE_USER_FROM_GROUP,
+        CMD::CMD_SEARCH_MESSAGES,
+        CMD::CMD_SEND_MESSAGE_TO_GROUP,
+        CMD::CMD_SEND_MESSAGE,
+        "EXTENSION COMMAND"};
+
+    /**
+     * @brief Executes a command record against the given state.
+     * Built-in alternatives are final classes, so the call is resolved statically.
+     */
+    inline void ExecuteRecord(CommandRecord& record, Domain::SystemState& state)
+    {
+        std::visit([&state](auto& command)
+                {
+                    if constexpr (std::is_same_v<std::decay_t<decltype(command)>, std::unique_ptr<ICommand>>)
+                    {
+                        if (command)
+                            command->execute(state);
+                    }
+                    else
+                    {
+                        command.execute(state);
+                    }
+                }, record);
+    }
+
+    /**
+     * @brief Converts a command record into a heap allocated ICommand.
+     */
+    inline std::unique_ptr<ICommand> ToCommand(CommandRecord&& record)
+    {
+        return std::visit([](auto&& command) -> std::unique_ptr<ICommand>
+                {
+                    using T = std::decay_t<decltype(command)>;
+                    if constexpr (std::is_same_v<T, std::unique_ptr<ICommand>>)
+                        return std::move(command);
+                    else
+                        return std::make_unique<T>(std::move(command));
+                }, std::move(record));
+    }
+}
@@ -1,19 +1,20 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include "commands/ICommand.h"
 #include "domain/SystemState.h"
 
 namespace Commands
 {
-    class DeleteUserCommand : public ICommand
+    class DeleteUserCommand final : public ICommand
     {
         public:
-            explicit DeleteUserCommand(std::string username_);
+            explicit DeleteUserCommand(std::string_view username_);
 
             void execute(Domain::SystemState& state) override;
 
         private:
-            std::string m_username;
+            std::string_view m_username;
     };
 }
\ No newline at end of file
@@ -1,19 +1,20 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include "commands/ICommand.h"
 #include "domain/SystemState.h"
 
 namespace Commands
 {
-    class DisableUserCommand : public ICommand
+    class DisableUserCommand final : public ICommand
     {
         public:
-            explicit DisableUserCommand(std::string username_);
+            explicit DisableUserCommand(std::string_view username_);
 
             void execute(Domain::SystemState& state) override;
 
         private:
-            std::string m_username;
+            std::string_view m_username;
     };
 }
\ No newline at end of file
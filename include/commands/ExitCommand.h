@@ -6,7 +6,7 @@
 
 namespace Commands
 {
-    class ExitCommand : public ICommand
+    class ExitCommand final : public ICommand
     {
         public:
             ExitCommand() = default;
@@ -6,7 +6,7 @@
 
 namespace Commands
 {
-    class GetGroupsCommand : public ICommand
+    class GetGroupsCommand final : public ICommand
     {
         public:
             GetGroupsCommand() = default;
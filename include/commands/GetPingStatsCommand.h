@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+#include "commands/ICommand.h"
+#include "domain/SystemState.h"
+
+namespace Commands
+{
+    class GetPingStatsCommand final : public ICommand
+    {
+        public:
+            GetPingStatsCommand() = default;
+
+            void execute(Domain::SystemState& state) override;
+    };
+}
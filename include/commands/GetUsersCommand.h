@@ -1,16 +1,37 @@
 #pragma once
 
+#include <cstddef>
+#include <limits>
 #include <string>
+#include <string_view>
 #include "commands/ICommand.h"
 #include "domain/SystemState.h"
 
 namespace Commands
 {
-    class GetUsersCommand : public ICommand
+    /**
+     * @brief Which users GET USERS lists, always in username order.
+     * Prefix lists names starting with the key; After lists names greater than the key (paging).
+     */
+    enum class UserQuery
+    {
+        All,
+        Prefix,
+        After
+    };
+
+    class GetUsersCommand final : public ICommand
     {
         public:
             GetUsersCommand() = default;
+            GetUsersCommand(UserQuery query, std::string_view key);
+            GetUsersCommand(UserQuery query, std::string_view key, std::string_view limit);
 
             void execute(Domain::SystemState& state) override;
+
+        private:
+            UserQuery m_query = UserQuery::All;
+            std::string_view m_key;
+            size_t m_limit = std::numeric_limits<size_t>::max();
     };
-}
\ No newline at end of file
+}
@@ -1,20 +1,36 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <cstdint>
 #include "commands/ICommand.h"
 #include "domain/SystemState.h"
 
 namespace Commands
 {
-    class PingCommand : public ICommand
+    /**
+     * @brief How PING reports its result.
+     * Summary prints one line per command; Verbose keeps the historical two lines per ping.
+     */
+    enum class PingOutputMode
+    {
+        Summary,
+        Verbose
+    };
+
+    class PingCommand final : public ICommand
     {
         public:
-            explicit PingCommand(std::string toUsername_, std::string times_);
+            explicit PingCommand(std::string_view toUsername_, std::string_view times_);
 
             void execute(Domain::SystemState& state) override;
 
+            static void SetOutputMode(PingOutputMode mode);
+            static PingOutputMode GetOutputMode();
+
         private:
-            std::string m_toUsername;
-            int m_times = 1;
+            std::string_view m_toUsername;
+            uint64_t m_times = 1;
+            inline static PingOutputMode s_outputMode = PingOutputMode::Summary;
     };
-}
\ No newline at end of file
+}
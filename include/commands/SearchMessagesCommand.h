@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include "commands/ICommand.h"
+#include "domain/SystemState.h"
+
+namespace Commands
+{
+    class SearchMessagesCommand final : public ICommand
+    {
+        public:
+            explicit SearchMessagesCommand(std::string_view query_);
+
+            void execute(Domain::SystemState& state) override;
+
+        private:
+            std::string_view m_query;
+    };
+}
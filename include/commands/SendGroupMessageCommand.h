@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include "commands/ICommand.h"
+#include "domain/SystemState.h"
+
+namespace Commands
+{
+    class SendGroupMessageCommand final : public ICommand
+    {
+        public:
+            explicit SendGroupMessageCommand(std::string_view groupName_, std::string_view message_);
+
+            void execute(Domain::SystemState& state) override;
+
+        private:
+            std::string_view m_groupName;
+            Domain::Message m_message;
+    };
+}
@@ -1,20 +1,22 @@
 #pragma once
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include "commands/ICommand.h"
 #include "domain/SystemState.h"
 
 namespace Commands
 {
-    class SendMessageCommand : public ICommand
+    class SendMessageCommand final : public ICommand
     {
         public:
-            explicit SendMessageCommand(std::string toUsername_, std::string message_);
+            explicit SendMessageCommand(std::string_view toUsername_, std::string_view message_);
 
             void execute(Domain::SystemState& state) override;
 
         private:
-            std::string m_toUsername;
-            std::string m_message;
+            std::string_view m_toUsername;
+            Domain::Message m_message;
     };
-}
\ No newline at end of file
+}
@@ -1,6 +1,8 @@
 #pragma once
 
+#include<memory_resource>
 #include<string>
+#include<string_view>
 #include<vector>
 #include<memory>
 
@@ -10,19 +12,20 @@ namespace Domain
     class Group: public std::enable_shared_from_this<Group>
     {
         public:
-            explicit Group(std::string groupName_);
+            explicit Group(std::string_view groupName_, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
-            const std::string& getGroupName() const;
-            const std::vector<std::shared_ptr<User>>& getMembers() const;
+            std::string_view getGroupName() const;
+            const std::pmr::vector<std::shared_ptr<User>>& getMembers() const;
 
             void AddMembers(const std::shared_ptr<User>& user);
-            void RemoveMember(const std::shared_ptr<User>& user);
-            bool hasMember(const std::string& username) const;
+            size_t RemoveMember(const std::shared_ptr<User>& user);
+            void RestoreMember(const std::shared_ptr<User>& user, size_t position);
+            bool hasMember(std::string_view username) const;
             int getMemberCount() const;
 
         private:
             int m_memberCount = 0;
-            std::string m_groupName;
-            std::vector<std::shared_ptr<User>> m_groupMembers;
+            std::pmr::string m_groupName;
+            std::pmr::vector<std::shared_ptr<User>> m_groupMembers;
     };
 }
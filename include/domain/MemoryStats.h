@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace Domain
+{
+    /**
+     * @brief Live counts and approximate heap bytes of a SystemState, by component.
+     *
+     * Bytes are estimates from object sizes and container capacities, not allocator
+     * measurements: they leave out allocator overhead, and a group message body is counted in
+     * every hot history that holds it.
+     */
+    struct MemoryStats
+    {
+        size_t users = 0;
+        size_t groups = 0;
+        size_t memberships = 0;
+        size_t messages = 0;
+
+        size_t nameBytes = 0;           ///< Usernames and group names beyond the small-string buffer, per copy.
+        size_t userObjectBytes = 0;     ///< User objects and their control blocks.
+        size_t groupObjectBytes = 0;    ///< Group objects and their control blocks.
+        size_t membershipBytes = 0;     ///< Group member vectors and the group lists of the users.
+        size_t messageBodyBytes = 0;    ///< Message bodies held as handles (hot blocks, shared bodies).
+        size_t messageStorageBytes = 0; ///< Block directories, hot slots and compressed sealed blocks.
+        size_t hashTableBytes = 0;      ///< Slot and control arrays of the user and group maps.
+        size_t indexBytes = 0;          ///< Username index nodes and the message index, if enabled.
+
+        size_t TotalBytes() const
+        {
+            return nameBytes + userObjectBytes + groupObjectBytes + membershipBytes + messageBodyBytes
+                 + messageStorageBytes + hashTableBytes + indexBytes;
+        }
+
+        /**
+         * @brief Approximate size of the control block make_shared adds to an object.
+         */
+        static constexpr size_t CONTROL_BLOCK_BYTES = 2 * sizeof(void*);
+
+        /**
+         * @brief Gets the heap bytes of a string's own buffer (0 while it fits the small-string buffer).
+         */
+        static size_t HeapBytes(const std::string& text)
+        {
+            return text.capacity() > std::string().capacity() ? text.capacity() + 1 : 0;
+        }
+
+        /**
+         * @brief Gets the heap bytes of an exact-size copy of `text`, as the state keeps its names.
+         */
+        static size_t HeapBytes(std::string_view text)
+        {
+            return text.size() > std::string().capacity() ? text.size() + 1 : 0;
+        }
+    };
+}
@@ -1,17 +1,24 @@
 #pragma once
 
+#include <memory>
 #include <string>
 
 namespace Domain
 {
+    /**
+     * @brief Handle to an immutable message body.
+     * Copies share the body, so a message fanned out to many users stores its text once.
+     */
     class Message
     {
         public:
             explicit Message( std::string content_);
+            explicit Message(std::shared_ptr<const std::string> body_);
 
             const std::string& getContent() const;
+            const std::shared_ptr<const std::string>& getBody() const;
 
         private:
-            std::string m_content;
+            std::shared_ptr<const std::string> m_body;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "User.h"
+
+namespace Domain
+{
+    /**
+     * @brief A message found by a search: the recipient and the position in its history.
+     */
+    struct MessageMatch
+    {
+        std::shared_ptr<const User> user;
+        size_t messageIndex;
+    };
+
+    /**
+     * @brief Inverted index from message terms to the messages that contain them.
+     *
+     * Every indexed message gets a sequential document id that points to (user, message index).
+     * The postings of a term are its ascending document ids, stored as varint-encoded deltas, so a
+     * term costs about one byte per message containing it. Terms are lowercase ASCII letter/digit
+     * runs; other bytes separate words, except non-ASCII bytes, which are kept inside words.
+     * Only the thread that owns the state may use it.
+     */
+    class MessageIndex
+    {
+        public:
+            static std::vector<std::string> Tokenize(std::string_view text);
+
+            void Add(const std::shared_ptr<User>& user, size_t messageIndex, const std::vector<std::string>& terms);
+            void RemoveLast(const std::vector<std::string>& terms);
+            std::vector<MessageMatch> Search(const std::vector<std::string>& terms) const;
+
+            size_t GetDocumentCount() const { return m_documents.size(); }
+            size_t GetTermCount() const { return m_postings.size(); }
+            size_t MemoryUsage() const;
+
+        private:
+            /**
+             * @brief Ascending document ids as varint deltas from the previous id.
+             */
+            struct PostingList
+            {
+                std::vector<uint8_t> bytes;
+                uint32_t last = 0;
+                uint32_t count = 0;
+
+                void Append(uint32_t document);
+                void PopBack();
+                std::vector<uint32_t> Decode() const;
+            };
+
+            struct Document
+            {
+                uint32_t user;
+                uint32_t message;
+            };
+
+            struct TermHash
+            {
+                using is_transparent = void;
+                size_t operator()(std::string_view term) const { return std::hash<std::string_view>{}(term); }
+            };
+
+            uint32_t UserId(const std::shared_ptr<User>& user);
+
+            std::unordered_map<std::string, PostingList, TermHash, std::equal_to<>> m_postings;
+            std::vector<Document> m_documents;
+            std::vector<std::weak_ptr<User>> m_users;
+            std::unordered_map<const User*, uint32_t> m_userIds;
+    };
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "Message.h"
+#include "RetentionPolicy.h"
+
+namespace Domain
+{
+    /**
+     * @brief Append-only message history of a user, stored in blocks of BLOCK_SIZE messages.
+     *
+     * The last HOT_BLOCKS blocks keep message handles. With compression enabled (it is off by
+     * default), older full blocks are sealed: their texts are packed, compressed with LZ4
+     * (Utils::CompressBlock) and decompressed on demand when read.
+     *
+     * Blocks are immutable for readers: growing, sealing or unsealing a block publishes a new
+     * one in its slot, and readers keep the block they loaded alive. The slot directory is
+     * replaced the same way when it fills, so snapshot readers on other threads can read every
+     * entry below a published size while the single writer keeps appending. Each entry is
+     * stamped with the state epoch it was written in, which lets a snapshot ignore messages sent
+     * after it was taken.
+     *
+     * PopBack undoes the latest appends (see SystemState::RollbackTransaction), unsealing a block
+     * if needed. A reader still searching with an older size only ever reads the atomic epoch of
+     * a slot that is being rewritten.
+     *
+     * Positions are absolute and stable. Trim (retention) only moves FirstIndex() forward; the
+     * blocks below it are dropped later by ReleaseTrimmed, once no published version older than
+     * the trim is alive. A replacement directory starts at the first block still held, so its
+     * size follows the retained history rather than every message ever sent.
+     *
+     * BodyBytes() and StorageBytes() keep the approximate heap footprint of the log up to date
+     * as blocks are written, sealed and released, so reading them is O(1).
+     *
+     * Blocks, directories and the owner's bookkeeping come from the memory resource given at
+     * construction; message bodies keep their own allocation, since they are shared with the
+     * commands that sent them. Readers may drop the last reference to a replaced block, so the
+     * resource must be thread-safe when snapshots are read from other threads.
+     */
+    class MessageLog
+    {
+        public:
+            static constexpr size_t BLOCK_SIZE = 64;
+            static constexpr size_t HOT_BLOCKS = 2;
+
+            class Block;
+            struct DecodedBlock;
+
+            /**
+             * @brief Input iterator over a log. Messages are returned by value; a sealed block is
+             * decompressed once when the iterator enters it.
+             */
+            class const_iterator
+            {
+                public:
+                    using iterator_category = std::input_iterator_tag;
+                    using value_type = Message;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = void;
+                    using reference = Message;
+
+                    const_iterator() = default;
+                    const_iterator(const MessageLog* log, size_t index) : m_log(log), m_index(index) {}
+
+                    Message operator*() const;
+                    const_iterator& operator++() { ++m_index; return *this; }
+                    const_iterator operator++(int) { auto copy = *this; ++m_index; return copy; }
+                    bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+
+                private:
+                    const MessageLog* m_log = nullptr;
+                    size_t m_index = 0;
+                    mutable size_t m_blockIndex = SIZE_MAX;
+                    mutable std::shared_ptr<const Block> m_block;
+                    mutable std::shared_ptr<const std::vector<std::string>> m_texts;
+            };
+
+            explicit MessageLog(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+            ~MessageLog() = default;
+            MessageLog(const MessageLog&) = delete;
+            MessageLog& operator=(const MessageLog&) = delete;
+
+            void Append(Message message, uint64_t epoch);
+            void PopBack();
+
+            size_t size() const { return m_size.load(std::memory_order_acquire); }
+            size_t FirstIndex() const { return m_first.load(std::memory_order_acquire); }
+            bool empty() const { return size() == FirstIndex(); }
+            Message operator[](size_t index) const;
+            size_t CountUpTo(uint64_t epoch) const;
+            size_t CountUpTo(uint64_t epoch, size_t first) const;
+            size_t SealedBlockCount() const;
+            uint64_t RetainedBytes() const;
+            size_t BodyBytes() const { return m_bodyBytes; }
+            size_t StorageBytes() const { return m_storageBytes; }
+
+            size_t Trim(const RetentionPolicy& policy, uint64_t epoch);
+            void RestoreFirst(size_t first);
+            size_t ReleaseTrimmed(uint64_t oldestVisibleEpoch);
+            bool HasPendingReleases() const { return !m_pendingReleases.empty(); }
+
+            const_iterator begin() const { return {this, FirstIndex()}; }
+            const_iterator end() const { return {this, size()}; }
+
+            static void SetCompressionEnabled(bool enabled);
+            static bool IsCompressionEnabled();
+
+        private:
+            using Slot = std::atomic<std::shared_ptr<const Block>>;
+
+            /**
+             * @brief Slots of blocks [base, base + capacity). Replaced, never resized, when it fills.
+             */
+            struct Directory
+            {
+                Directory(size_t base_, size_t capacity_, std::pmr::memory_resource* resource)
+                    : base(base_), capacity(capacity_), slots(capacity_, resource) {}
+
+                size_t base = 0;
+                size_t capacity = 0;
+                mutable std::pmr::vector<Slot> slots; ///< Written by the owner through published directories.
+            };
+
+            static constexpr size_t FIRST_HOT_CAPACITY = 4;
+
+            std::shared_ptr<const Block> LoadBlock(size_t block) const;
+            Slot& WritableSlot(size_t block);
+            Block& WritableBlock(size_t block, size_t offset);
+            void StoreBlock(Slot& slot, std::shared_ptr<const Block> block);
+            void Seal(size_t block);
+            size_t LengthAt(size_t index);
+
+            std::pmr::memory_resource* m_resource;
+            std::atomic<std::shared_ptr<const Directory>> m_directory;
+            std::atomic<size_t> m_size{0};
+            std::atomic<size_t> m_first{0};
+            size_t m_sealedBlocks = 0;
+            size_t m_releasedBlocks = 0;
+            uint64_t m_bytes = 0;
+            size_t m_bodyBytes = 0;
+            size_t m_storageBytes = 0;
+            std::pmr::vector<std::pair<uint64_t, size_t>> m_pendingReleases;
+            std::pmr::vector<uint32_t> m_lengths;
+            size_t m_lengthsBlock = SIZE_MAX;
+            mutable std::atomic<std::shared_ptr<const DecodedBlock>> m_decoded;
+            inline static std::atomic<bool> s_compressionEnabled{false};
+    };
+}
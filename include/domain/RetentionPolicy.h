@@ -0,0 +1,27 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+namespace Domain
+{
+    /**
+     * @brief Bounds on the message history kept per user. A bound of 0 means unlimited.
+     */
+    struct RetentionPolicy
+    {
+        size_t maxMessages = 0;
+        size_t maxBytes = 0;
+
+        bool IsUnlimited() const { return maxMessages == 0 && maxBytes == 0; }
+
+        /**
+         * @brief Combines two policies, keeping the stricter bound of each kind.
+         */
+        static RetentionPolicy Tighter(const RetentionPolicy& lhs, const RetentionPolicy& rhs)
+        {
+            auto tighter = [](size_t a, size_t b) { return a == 0 ? b : b == 0 ? a : std::min(a, b); };
+            return {tighter(lhs.maxMessages, rhs.maxMessages), tighter(lhs.maxBytes, rhs.maxBytes)};
+        }
+    };
+}
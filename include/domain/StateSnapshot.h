@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "User.h"
+#include "Group.h"
+#include "MessageLog.h"
+#include "UsernameIndex.h"
+
+namespace Domain
+{
+    /**
+     * @brief Messages a user had received when a snapshot was taken, from the first one still
+     * retained. Keeps the user (and therefore its log) alive while the view exists, and the
+     * version it was read from, which keeps trimmed blocks it may still read from being released.
+     */
+    class MessageHistoryView
+    {
+        public:
+            MessageHistoryView(std::shared_ptr<const void> version, std::shared_ptr<const User> user, size_t first, size_t end)
+                : m_version(std::move(version)), m_user(std::move(user)), m_first(first), m_end(std::max(first, end)) {}
+
+            size_t size() const { return m_end - m_first; }
+            bool empty() const { return m_end == m_first; }
+            Message operator[](size_t index) const { return m_user->getMessages()[m_first + index]; }
+            MessageLog::const_iterator begin() const { return {&m_user->getMessages(), m_first}; }
+            MessageLog::const_iterator end() const { return {&m_user->getMessages(), m_end}; }
+
+        private:
+            std::shared_ptr<const void> m_version;
+            std::shared_ptr<const User> m_user;
+            size_t m_first;
+            size_t m_end;
+    };
+
+    /**
+     * @brief Immutable version of the users and groups of a SystemState.
+     *
+     * Users and groups are split into shards by name hash. A new version copies only the shards
+     * that changed and shares the rest with the previous one, and message histories are shared
+     * append-only logs cut at the snapshot epoch, so publishing is proportional to what changed.
+     * A version is freed when the last reader drops it. Usernames are also kept in order in a
+     * frozen UsernameIndex, for sorted listing, prefix and range queries.
+     */
+    class StateSnapshot : public std::enable_shared_from_this<StateSnapshot>
+    {
+        public:
+            static constexpr size_t SHARD_COUNT = 256;
+
+            /**
+             * @brief A user as of this version. The User object is the live one, still mutated by
+             * the writer, so an entry only exposes its name, which never changes, and the fields
+             * copied when the entry was published. Messages are read through getMessageHistory,
+             * which cuts the shared log at this version.
+             */
+            class UserEntry
+            {
+                public:
+                    UserEntry(std::shared_ptr<const User> user, bool disabled_, size_t firstMessage_)
+                        : disabled(disabled_), firstMessage(firstMessage_), m_user(std::move(user)) {}
+
+                    std::string_view GetName() const { return m_user->getUsername(); }
+
+                    bool disabled;
+                    size_t firstMessage; ///< FirstIndex() of the history when the entry was published.
+
+                private:
+                    friend class StateSnapshot;
+                    std::shared_ptr<const User> m_user;
+            };
+
+            /**
+             * @brief A group as of this version. Like UserEntry, it only exposes the name of the
+             * live Group and the member count copied when the entry was published; the member
+             * list itself is not safe to read from other threads.
+             */
+            class GroupEntry
+            {
+                public:
+                    GroupEntry(std::shared_ptr<const Group> group, int memberCount_)
+                        : memberCount(memberCount_), m_group(std::move(group)) {}
+
+                    std::string_view GetName() const { return m_group->getGroupName(); }
+
+                    int memberCount;
+
+                private:
+                    std::shared_ptr<const Group> m_group;
+            };
+
+            using UserShard = std::vector<UserEntry>;
+            using GroupShard = std::vector<GroupEntry>;
+
+            uint64_t GetEpoch() const { return m_epoch; }
+            size_t GetUserCount() const { return m_userCount; }
+            size_t GetGroupCount() const { return m_groupCount; }
+
+            const UserEntry* FindUser(std::string_view username) const;
+            const GroupEntry* FindGroup(std::string_view groupName) const;
+            bool isUserExists(std::string_view username) const { return FindUser(username) != nullptr; }
+            MessageHistoryView getMessageHistory(std::string_view username) const;
+            const UsernameIndex& GetUsernameIndex() const { return *m_usernames; }
+
+            template <typename Visit>
+            void ForEachUser(Visit&& visit) const
+            {
+                for (const auto& shard : m_userShards)
+                    for (const auto& entry : *shard)
+                        visit(entry);
+            }
+
+            template <typename Visit>
+            void ForEachGroup(Visit&& visit) const
+            {
+                for (const auto& shard : m_groupShards)
+                    for (const auto& entry : *shard)
+                        visit(entry);
+            }
+
+            static size_t ShardOf(std::string_view name);
+
+        private:
+            friend class SystemState;
+
+            uint64_t m_epoch = 0;
+            size_t m_userCount = 0;
+            size_t m_groupCount = 0;
+            std::array<std::shared_ptr<const UserShard>, SHARD_COUNT> m_userShards;
+            std::array<std::shared_ptr<const GroupShard>, SHARD_COUNT> m_groupShards;
+            std::shared_ptr<const UsernameIndex> m_usernames = std::make_shared<const UsernameIndex>();
+    };
+}
@@ -1,45 +1,185 @@
 #pragma once
 
-#include <unordered_map>
+#include <atomic>
+#include <deque>
+#include <memory_resource>
 #include <vector>
 #include <string>
 #include <optional>
 
 #include "User.h"
 #include "Group.h"
+#include "MemoryStats.h"
 #include "Message.h"
+#include "MessageIndex.h"
+#include "RetentionPolicy.h"
+#include "StateSnapshot.h"
+#include "utils/FlatStringMap.h"
 
 namespace Domain
 {
+    /**
+     * @brief Ping counters of a system state.
+     */
+    struct PingStats
+    {
+        uint64_t pingsSent = 0;
+        uint64_t pingsToUnknownUsers = 0;
+        std::vector<std::pair<std::string, uint64_t>> receivedByUser;
+    };
+
+    /**
+     * @brief The live users, groups and messages, owned and written by a single thread.
+     *
+     * Everything the state owns (users and groups with their names, member lists and message
+     * blocks, the maps, the username index and the change and undo logs) is allocated from the
+     * memory resource given at construction. Snapshot shards, the message index and message bodies
+     * use the default heap.
+     */
     class SystemState
     {
         public:
-            SystemState() = default;
+            explicit SystemState(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
             SystemState(const SystemState&) = delete;
             SystemState& operator=(const SystemState&) = delete;
             SystemState(SystemState&&) noexcept = default;
             SystemState& operator=(SystemState&&) noexcept = default;
             ~SystemState() = default;
 
+            std::pmr::memory_resource* GetMemoryResource() const;
+            std::shared_ptr<User> NewUser(std::string_view username) const;
             void AddUser(const std::shared_ptr<User>& user);
-            bool isUserExists(const std::string& username) const;
-            void DeleteUser(const std::string& username);
-            void DisableUser(const std::string& username);
+            bool isUserExists(std::string_view username) const;
+            void DeleteUser(std::string_view username);
+            void DisableUser(std::string_view username);
             std::vector<std::shared_ptr<User>> getUsers() const;
             std::vector<std::shared_ptr<Group>> getGroups() const;
 
-            void AddUserToGroup(const std::string& username, const std::string& groupName);
-            void RemoveUserFromGroup(const std::string& username, const std::string& groupName);
+            void AddUserToGroup(std::string_view username, std::string_view groupName);
+            void RemoveUserFromGroup(std::string_view username, std::string_view groupName);
+
+            void SendMessage(std::string_view toUser, Message message);
+            size_t SendMessageToGroup(std::string_view groupName, const Message& message);
+            MessageHistoryView getMessageHistory(std::string_view username) const;
+
+            void SetRetentionPolicy(const RetentionPolicy& policy);
+            const RetentionPolicy& GetRetentionPolicy() const;
+            void SetGroupRetentionPolicy(std::string_view groupName, const RetentionPolicy& policy);
 
-            void SendMessage(const std::string& toUser, std::unique_ptr<Message> message);
-            const std::vector<std::unique_ptr<Message>>& getMessageHistory(const std::string& username) const;
+            void SetMessageIndexEnabled(bool enabled);
+            const MessageIndex* GetMessageIndex() const;
+            std::vector<MessageMatch> SearchMessages(std::string_view query) const;
+
+            std::optional<uint64_t> RecordPing(std::string_view username, uint64_t times);
+            PingStats GetPingStats() const;
+            MemoryStats GetMemoryStats() const;
+
+            std::shared_ptr<const StateSnapshot> Snapshot();
+            std::shared_ptr<const StateSnapshot> LatestSnapshot() const;
+            void PublishPending();
+            uint64_t GetEpoch() const;
+
+            void BeginTransaction();
+            void CommitTransaction();
+            size_t RollbackTransaction();
+            bool InTransaction() const;
 
         private:
-            bool isGroupExists(const std::string& groupName) const;
-            bool isUserInGroup(const std::string& username, const std::string& groupName) const;
+            /**
+             * @brief Inverse operations recorded in the undo log while a transaction is open.
+             */
+            enum class UndoAction
+            {
+                RemoveUser,
+                RestoreUser,
+                EnableUser,
+                RemoveMessage,
+                RestoreMessages,
+                LeaveGroup,
+                RejoinGroup,
+                RemovePings
+            };
+
+            /**
+             * @brief One undo log record. `value` is the member position for RejoinGroup, the first
+             * retained message for RestoreMessages and the ping count for RemovePings (whose user
+             * is null for pings to unknown users).
+             */
+            struct UndoEntry
+            {
+                UndoAction action;
+                std::shared_ptr<User> user;
+                std::shared_ptr<Group> group;
+                uint64_t value = 0;
+            };
+
+            /**
+             * @brief Holder of the latest published version, read by any thread.
+             * Moving it is not thread-safe, like moving the rest of the state.
+             */
+            class PublishedSnapshot
+            {
+                public:
+                    PublishedSnapshot() = default;
+                    PublishedSnapshot(PublishedSnapshot&& other) noexcept : m_snapshot(other.m_snapshot.load()) {}
+                    PublishedSnapshot& operator=(PublishedSnapshot&& other) noexcept
+                    {
+                        m_snapshot.store(other.m_snapshot.load());
+                        return *this;
+                    }
+
+                    std::shared_ptr<const StateSnapshot> Load() const { return m_snapshot.load(std::memory_order_acquire); }
+                    void Store(std::shared_ptr<const StateSnapshot> snapshot) { m_snapshot.store(std::move(snapshot), std::memory_order_release); }
+
+                private:
+                    std::atomic<std::shared_ptr<const StateSnapshot>> m_snapshot;
+            };
+
+            void MarkUserChanged(std::string_view username);
+            void MarkGroupChanged(std::string_view groupName);
+            void Publish();
+            void Undo(const UndoEntry& entry);
+            void EndTransaction();
+            void EnforceRetention(const std::shared_ptr<User>& user, const RetentionPolicy& policy);
+            void ReleaseTrimmedMessages();
+            void CompactMessageIndex();
+            uint64_t OldestVisibleEpoch();
+            void AccountUser(const User& user, bool add);
+            void AccountGroup(const Group& group, bool add);
+
+            bool isGroupExists(std::string_view groupName) const;
+            bool isUserInGroup(std::string_view username, std::string_view groupName) const;
             void CreateNewGroup(const std::shared_ptr<Group>& group);
 
-            std::unordered_map<std::string, std::shared_ptr<User>> m_userMap;
-            std::unordered_map<std::string, std::shared_ptr<Group>> m_groupMap;
+            template <typename Value>
+            using NameMap = Utils::FlatStringMap<Value>;
+
+            std::pmr::memory_resource* m_resource;
+            NameMap<std::shared_ptr<User>> m_userMap;
+            NameMap<std::shared_ptr<Group>> m_groupMap;
+            UsernameIndex m_usernameIndex;
+            std::unique_ptr<MessageIndex> m_messageIndex;
+            size_t m_trimmedSinceIndexBuild = 0;
+            RetentionPolicy m_retention;
+            NameMap<RetentionPolicy> m_groupRetention;
+            std::pmr::vector<std::shared_ptr<User>> m_releaseQueue; ///< Users with trimmed blocks not freed yet.
+            size_t m_releaseQueueSwept = 0;
+            uint64_t m_releaseEpoch = UINT64_MAX;
+            uint64_t m_pingsSent = 0;
+            uint64_t m_pingsToUnknownUsers = 0;
+            MemoryStats m_memory;
+
+            bool m_snapshotsEnabled = false;
+            bool m_hasPendingChanges = false;
+            uint64_t m_epoch = 0;
+            std::pmr::vector<std::pmr::string> m_changedUsers;
+            std::pmr::vector<std::pmr::string> m_changedGroups;
+            std::shared_ptr<const StateSnapshot> m_current;
+            std::deque<std::pair<uint64_t, std::weak_ptr<const StateSnapshot>>> m_olderVersions;
+            PublishedSnapshot m_published;
+
+            bool m_inTransaction = false;
+            bool m_publishHeldBack = false;
+            std::pmr::vector<UndoEntry> m_undoLog;
     };
 }
\ No newline at end of file
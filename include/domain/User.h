@@ -1,37 +1,49 @@
 #pragma once
 
+#include<memory_resource>
 #include<string>
+#include<string_view>
 #include<vector>
 #include<algorithm>
 #include<memory>
+#include<cstdint>
+#include "MessageLog.h"
 
 namespace Domain
 {
     class Group;
-    class Message;
 
     class User: public std::enable_shared_from_this<User>
     {
         public:
-            explicit User(std::string username_);
+            explicit User(std::string_view username_, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
             ~User() = default;
 
-            const std::string& getUsername() const;
+            std::string_view getUsername() const;
             bool isDisabled() const;
             void disable();
-            const std::vector<std::weak_ptr<Group>>& getGroups() const;
-            const std::vector<std::unique_ptr<Message>>& getMessages() const;
+            void enable();
+            const std::pmr::vector<std::weak_ptr<Group>>& getGroups() const;
+            const MessageLog& getMessages() const;
+            uint64_t getPingsReceived() const;
 
             void JoinGroup(const std::shared_ptr<Group>& group);
             void RemoveGroup(const std::shared_ptr<Group>& group);
-            bool isInGroup(const std::string& group) const;
-            void AddMessage(std::unique_ptr<Message> message);
+            bool isInGroup(std::string_view group) const;
+            void AddMessage(Message message, uint64_t epoch = 0);
+            void RemoveLastMessage();
+            size_t TrimMessages(const RetentionPolicy& policy, uint64_t epoch);
+            void RestoreMessages(size_t first);
+            void ReleaseTrimmedMessages(uint64_t oldestVisibleEpoch);
+            uint64_t AddPings(uint64_t count);
+            void RemovePings(uint64_t count);
 
         private:
-            std::string m_userName;
+            std::pmr::string m_userName;
             bool m_disable = false;
-            std::vector<std::weak_ptr<Group>> m_groups;
-            std::vector<std::unique_ptr<Message>> m_messages;
+            uint64_t m_pingsReceived = 0;
+            std::pmr::vector<std::weak_ptr<Group>> m_groups;
+            MessageLog m_messages;
     };
 }
\ No newline at end of file
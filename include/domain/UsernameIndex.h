@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Domain
+{
+    /**
+     * @brief Ordered set of usernames kept as a copy-on-write B+tree.
+     *
+     * Nodes hold up to MAX_KEYS sorted names in one array, so a lookup touches O(log n) nodes and a
+     * range of k names is listed in O(log n + k). Freeze() returns an immutable version in O(1):
+     * nodes reachable from a frozen version are never modified again; later writes copy the nodes
+     * on the path they change (once per node and version) and share the rest. Only the owner
+     * thread may write; frozen versions can be read from any thread.
+     *
+     * Nodes and names come from the memory resource given at construction, which must outlive
+     * every frozen version (and be thread-safe if those are released on other threads).
+     */
+    class UsernameIndex
+    {
+        public:
+            static constexpr size_t MAX_KEYS = 32;
+            static constexpr size_t MIN_KEYS = MAX_KEYS / 2;
+
+            explicit UsernameIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : m_resource(resource) {}
+            UsernameIndex(const UsernameIndex&) = delete;
+            UsernameIndex& operator=(const UsernameIndex&) = delete;
+            UsernameIndex(UsernameIndex&&) noexcept = default;
+            UsernameIndex& operator=(UsernameIndex&&) noexcept = default;
+
+            bool Insert(std::string_view name);
+            bool Erase(std::string_view name);
+            bool Contains(std::string_view name) const;
+            size_t size() const { return m_size; }
+            bool empty() const { return m_size == 0; }
+            std::shared_ptr<const UsernameIndex> Freeze();
+            size_t MemoryUsage() const;
+
+            /**
+             * @brief Visits, in order, every name not less than `first` until `visit` returns false.
+             */
+            template <typename Visit>
+            void ForEachFrom(std::string_view first, Visit&& visit) const
+            {
+                if (m_root)
+                    VisitFrom(*m_root, first, visit);
+            }
+
+            template <typename Visit>
+            void ForEach(Visit&& visit) const
+            {
+                ForEachFrom({}, visit);
+            }
+
+        private:
+            /**
+             * @brief Leaves hold names; inner nodes hold separators, where keys[i] is not greater
+             * than any name of children[i + 1] and greater than every name of children[i].
+             */
+            struct Node
+            {
+                explicit Node(std::pmr::memory_resource* resource) : keys(resource), children(resource) {}
+                Node(const Node& other, std::pmr::memory_resource* resource)
+                    : generation(other.generation), keys(other.keys, resource), children(other.children, resource) {}
+
+                uint64_t generation = 0;
+                std::pmr::vector<std::pmr::string> keys;
+                std::pmr::vector<std::shared_ptr<Node>> children;
+
+                bool isLeaf() const { return children.empty(); }
+            };
+
+            struct Split
+            {
+                std::pmr::string separator;
+                std::shared_ptr<Node> right;
+            };
+
+            template <typename Visit>
+            static bool VisitFrom(const Node& node, std::string_view first, Visit& visit)
+            {
+                if (node.isLeaf())
+                {
+                    for (auto it = std::lower_bound(node.keys.begin(), node.keys.end(), first); it != node.keys.end(); ++it)
+                    {
+                        if (!visit(std::string_view(*it)))
+                            return false;
+                    }
+                    return true;
+                }
+
+                auto child = static_cast<size_t>(std::upper_bound(node.keys.begin(), node.keys.end(), first) - node.keys.begin());
+                for (; child < node.children.size(); ++child)
+                {
+                    if (!VisitFrom(*node.children[child], first, visit))
+                        return false;
+                    first = {};
+                }
+                return true;
+            }
+
+            static size_t ChildFor(const Node& node, std::string_view name);
+
+            std::shared_ptr<Node> NewNode();
+            Node& Mutable(std::shared_ptr<Node>& slot);
+            std::optional<Split> InsertInto(std::shared_ptr<Node>& slot, std::string_view name);
+            Split SplitNode(Node& node);
+            void EraseFrom(std::shared_ptr<Node>& slot, std::string_view name);
+            void Rebalance(Node& parent, size_t child);
+
+            std::pmr::memory_resource* m_resource;
+            std::shared_ptr<Node> m_root;
+            size_t m_size = 0;
+            size_t m_nodeCount = 0;
+            uint64_t m_generation = 1;
+    };
+}
@@ -1,3 +1,4 @@
+#pragma once
 #include "errorhandling/exceptions/AllExceptions.h"
 #include <functional>
 #include <unordered_map>
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Utils
+{
+    /**
+     * @brief Pipeline phase that allocations are attributed to.
+     */
+    enum class AllocationPhase : uint8_t
+    {
+        Other,
+        Load,
+        Parse,
+        CreateCommand,
+        Execute,
+        Print,
+        Count
+    };
+
+    /**
+     * @brief Allocation totals of one phase or command type.
+     */
+    struct AllocationCounters
+    {
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+        uint64_t deallocations = 0;
+    };
+
+    /**
+     * @brief Allocation totals of every thread, by phase and by command type.
+     */
+    struct AllocationReport
+    {
+        static constexpr size_t MAX_COMMAND_TYPES = 16;
+
+        std::array<AllocationCounters, static_cast<size_t>(AllocationPhase::Count)> phases{};
+        std::array<AllocationCounters, MAX_COMMAND_TYPES> commandTypes{};
+
+        const AllocationCounters& operator[](AllocationPhase phase) const { return phases[static_cast<size_t>(phase)]; }
+        AllocationCounters Total() const;
+        AllocationReport operator-(const AllocationReport& earlier) const;
+    };
+
+    /**
+     * @brief Counts every global operator new/delete per thread and attributes it to the phase
+     * (and command type) currently set on that thread.
+     *
+     * The hooks only exist in targets compiled with USER_MGMT_TRACK_ALLOCATIONS; elsewhere the
+     * scopes below compile to nothing and the report stays empty.
+     */
+    class AllocationTracker
+    {
+        public:
+            static constexpr size_t NO_COMMAND_TYPE = AllocationReport::MAX_COMMAND_TYPES;
+
+            static constexpr bool IsEnabled()
+            {
+#ifdef USER_MGMT_TRACK_ALLOCATIONS
+                return true;
+#else
+                return false;
+#endif
+            }
+
+            static AllocationReport Snapshot();
+            static const char* PhaseName(AllocationPhase phase);
+
+            static AllocationPhase SetPhase(AllocationPhase phase);
+            static size_t SetCommandType(size_t commandType);
+
+            static void RecordAllocation(size_t bytes);
+            static void RecordDeallocation();
+    };
+
+    /**
+     * @brief Sets the allocation phase of the current thread for the lifetime of the object.
+     */
+    class ScopedAllocationPhase
+    {
+        public:
+#ifdef USER_MGMT_TRACK_ALLOCATIONS
+            explicit ScopedAllocationPhase(AllocationPhase phase) : m_previous(AllocationTracker::SetPhase(phase)) {}
+            ~ScopedAllocationPhase() { AllocationTracker::SetPhase(m_previous); }
+#else
+            explicit ScopedAllocationPhase(AllocationPhase) {}
+#endif
+            ScopedAllocationPhase(const ScopedAllocationPhase&) = delete;
+            ScopedAllocationPhase& operator=(const ScopedAllocationPhase&) = delete;
+
+#ifdef USER_MGMT_TRACK_ALLOCATIONS
+        private:
+            AllocationPhase m_previous;
+#endif
+    };
+
+    /**
+     * @brief Sets the command type of the current thread for the lifetime of the object.
+     */
+    class ScopedAllocationCommand
+    {
+        public:
+#ifdef USER_MGMT_TRACK_ALLOCATIONS
+            explicit ScopedAllocationCommand(size_t commandType) : m_previous(AllocationTracker::SetCommandType(commandType)) {}
+            ~ScopedAllocationCommand() { AllocationTracker::SetCommandType(m_previous); }
+#else
+            explicit ScopedAllocationCommand(size_t) {}
+#endif
+            ScopedAllocationCommand(const ScopedAllocationCommand&) = delete;
+            ScopedAllocationCommand& operator=(const ScopedAllocationCommand&) = delete;
+
+#ifdef USER_MGMT_TRACK_ALLOCATIONS
+        private:
+            size_t m_previous;
+#endif
+    };
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Utils
+{
+    /**
+     * @brief Compresses a block of bytes with LZ4 (block format, default acceleration).
+     * @param input The bytes to compress.
+     * @return The compressed bytes; DecompressBlock needs input.size() to restore them.
+     * @throws std::runtime_error if the input is too large for an LZ4 block.
+     */
+    std::vector<uint8_t> CompressBlock(std::string_view input);
+
+    /**
+     * @brief Restores a block written by CompressBlock.
+     * @param input The compressed bytes.
+     * @param originalSize The size of the block before compression.
+     * @throws std::runtime_error if the input is malformed or does not restore originalSize bytes.
+     */
+    std::string DecompressBlock(std::span<const uint8_t> input, size_t originalSize);
+}
@@ -7,9 +7,15 @@ namespace CMD
     constexpr const char* CMD_DELETE_USER            = "DELETE USER";
     constexpr const char* CMD_DISABLE_USER           = "DISABLE USER";
     constexpr const char* CMD_SEND_MESSAGE           = "SEND MESSAGE";
+    constexpr const char* CMD_SEND_MESSAGE_TO_GROUP  = "SEND MESSAGE TO GROUP";
     constexpr const char* CMD_GET_USERS              = "GET USERS";
+    constexpr const char* CMD_GET_USERS_PREFIX       = "GET USERS PREFIX";
+    constexpr const char* CMD_GET_USERS_AFTER        = "GET USERS AFTER";
     constexpr const char* CMD_GET_GROUPS             = "GET GROUPS";
     constexpr const char* CMD_GET_MESSAGE_HISTORY    = "GET MESSAGE HISTORY";
+    constexpr const char* CMD_GET_PING_STATS         = "GET PING STATS";
+    constexpr const char* CMD_GET_STATS              = "GET STATS";
+    constexpr const char* CMD_SEARCH_MESSAGES        = "SEARCH MESSAGES";
     constexpr const char* CMD_REMOVE_USER_FROM_GROUP = "REMOVE USER FROM GROUP";
     constexpr const char* CMD_PING                   = "PING";
     constexpr const char* CMD_EXIT                   = "EXIT";
@@ -0,0 +1,379 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define USER_MGMT_FLAT_MAP_SSE2 1
+#endif
+
+namespace Utils
+{
+    /**
+     * @brief Open-addressing hash map from strings to values, laid out like a Swiss table.
+     *
+     * Entries live in one slot array, next to an array with a control byte per slot: the low 7
+     * bits of the hash of a full slot, or a marker for an empty or deleted one. A lookup probes
+     * groups of 16 control bytes at once (one SSE2 compare, or a portable loop) and only compares
+     * the keys whose 7 bits match, so a miss rarely touches a key. Groups are probed
+     * quadratically and the table grows at 7/8 load. Erasing leaves a tombstone unless the group
+     * still has an empty slot; tombstones are reclaimed when the table is rehashed.
+     *
+     * Lookups take std::string_view, so searching builds no key. Keys are std::pmr::string and,
+     * with both arrays, come from the memory resource given at construction. Keys must not be
+     * modified through an iterator. Inserting may rehash and invalidates every iterator and
+     * reference; erasing invalidates only those to the erased entry.
+     */
+    template <typename Value>
+    class FlatStringMap
+    {
+        public:
+            using key_type = std::pmr::string;
+            using mapped_type = Value;
+            using value_type = std::pair<std::pmr::string, Value>;
+            using size_type = size_t;
+
+            static constexpr size_t GROUP_WIDTH = 16;
+
+            template <bool Const>
+            class Iterator
+            {
+                public:
+                    using iterator_category = std::forward_iterator_tag;
+                    using value_type = FlatStringMap::value_type;
+                    using difference_type = std::ptrdiff_t;
+                    using reference = std::conditional_t<Const, const value_type&, value_type&>;
+                    using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+                    Iterator() = default;
+                    Iterator(const int8_t* ctrl, pointer slot) : m_ctrl(ctrl), m_slot(slot) { SkipFree(); }
+                    template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+                    Iterator(const Iterator<OtherConst>& other) : m_ctrl(other.m_ctrl), m_slot(other.m_slot) {}
+
+                    reference operator*() const { return *m_slot; }
+                    pointer operator->() const { return m_slot; }
+                    Iterator& operator++() { ++m_ctrl; ++m_slot; SkipFree(); return *this; }
+                    Iterator operator++(int) { auto copy = *this; ++*this; return copy; }
+                    bool operator==(const Iterator& other) const { return m_slot == other.m_slot; }
+
+                private:
+                    friend class FlatStringMap;
+                    template <bool> friend class Iterator;
+
+                    // Stops at a full slot or at the sentinel after the last slot.
+                    void SkipFree()
+                    {
+                        while (m_ctrl && *m_ctrl < 0 && *m_ctrl != SENTINEL)
+                        {
+                            ++m_ctrl;
+                            ++m_slot;
+                        }
+                    }
+
+                    const int8_t* m_ctrl = nullptr;
+                    pointer m_slot = nullptr;
+            };
+
+            using iterator = Iterator<false>;
+            using const_iterator = Iterator<true>;
+
+            explicit FlatStringMap(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : m_resource(resource) {}
+            FlatStringMap(const FlatStringMap&) = delete;
+            FlatStringMap& operator=(const FlatStringMap&) = delete;
+            FlatStringMap(FlatStringMap&& other) noexcept { Steal(other); }
+            FlatStringMap& operator=(FlatStringMap&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    Release();
+                    Steal(other);
+                }
+                return *this;
+            }
+            ~FlatStringMap() { Release(); }
+
+            size_t size() const { return m_size; }
+            bool empty() const { return m_size == 0; }
+            /**
+             * @brief Gets the number of slots (the bucket count of the table).
+             */
+            size_t capacity() const { return m_capacity; }
+            /**
+             * @brief Gets the bytes of the slot and control arrays, without the heap of the keys.
+             */
+            size_t MemoryUsage() const { return m_capacity ? m_capacity * (sizeof(value_type) + 1) + GROUP_WIDTH : 0; }
+
+            iterator begin() { return {m_ctrl, m_slots}; }
+            iterator end() { return {m_ctrl + m_capacity, m_slots + m_capacity}; }
+            const_iterator begin() const { return {m_ctrl, m_slots}; }
+            const_iterator end() const { return {m_ctrl + m_capacity, m_slots + m_capacity}; }
+
+            iterator find(std::string_view key)
+            {
+                const size_t index = FindIndex(key, Hash(key));
+                return index == NPOS ? end() : iterator(m_ctrl + index, m_slots + index);
+            }
+
+            const_iterator find(std::string_view key) const
+            {
+                const size_t index = FindIndex(key, Hash(key));
+                return index == NPOS ? end() : const_iterator(m_ctrl + index, m_slots + index);
+            }
+
+            bool contains(std::string_view key) const { return FindIndex(key, Hash(key)) != NPOS; }
+
+            /**
+             * @brief Inserts `key` with a value built from `args`, unless the key is present.
+             * @return The entry of the key and whether it was inserted.
+             */
+            template <typename... Args>
+            std::pair<iterator, bool> try_emplace(std::string_view key, Args&&... args)
+            {
+                const size_t hash = Hash(key);
+                if (const size_t found = FindIndex(key, hash); found != NPOS)
+                    return {iterator(m_ctrl + found, m_slots + found), false};
+
+                size_t index = m_capacity ? FindFree(hash) : NPOS;
+                if (index == NPOS || (m_growthLeft == 0 && m_ctrl[index] == EMPTY))
+                {
+                    Rehash(m_size + 1 > MaxLoad(m_capacity) / 2 ? std::max(m_capacity * 2, GROUP_WIDTH) : m_capacity);
+                    index = FindFree(hash);
+                }
+                ::new (static_cast<void*>(m_slots + index)) value_type(std::piecewise_construct,
+                                                                       std::forward_as_tuple(key, m_resource),
+                                                                       std::forward_as_tuple(std::forward<Args>(args)...));
+                if (m_ctrl[index] == EMPTY)
+                    --m_growthLeft;
+                m_ctrl[index] = H2(hash);
+                ++m_size;
+                return {iterator(m_ctrl + index, m_slots + index), true};
+            }
+
+            void erase(const_iterator position)
+            {
+                const auto index = static_cast<size_t>(position.m_slot - m_slots);
+                m_slots[index].~value_type();
+                --m_size;
+                // A probe only goes past a group that was full, so a group that still has an empty
+                // slot can get this one back as empty instead of a tombstone.
+                if (GroupAt(index & ~(GROUP_WIDTH - 1)).MatchEmpty())
+                {
+                    m_ctrl[index] = EMPTY;
+                    ++m_growthLeft;
+                }
+                else
+                    m_ctrl[index] = DELETED;
+            }
+
+            size_t erase(std::string_view key)
+            {
+                const auto it = find(key);
+                if (it == end())
+                    return 0;
+                erase(it);
+                return 1;
+            }
+
+            void clear()
+            {
+                DestroyAll();
+                if (m_capacity)
+                    std::memset(m_ctrl, EMPTY, m_capacity);
+                m_size = 0;
+                m_growthLeft = MaxLoad(m_capacity);
+            }
+
+            void reserve(size_t count)
+            {
+                if (count > MaxLoad(m_capacity))
+                    Rehash(CapacityFor(count));
+            }
+
+        private:
+            static constexpr int8_t EMPTY = -128;
+            static constexpr int8_t DELETED = -2;
+            static constexpr int8_t SENTINEL = -1;
+            static constexpr size_t NPOS = SIZE_MAX;
+            static constexpr size_t NEXT_GROUP = SIZE_MAX - 1;
+
+            /**
+             * @brief The control bytes of one group, with a bit mask per question.
+             */
+            class Group
+            {
+                public:
+#ifdef USER_MGMT_FLAT_MAP_SSE2
+                    explicit Group(const int8_t* ctrl) : m_ctrl(_mm_load_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+                    uint32_t Match(int8_t h2) const
+                    {
+                        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl)));
+                    }
+                    uint32_t MatchEmpty() const { return Match(EMPTY); }
+                    uint32_t MatchFree() const { return static_cast<uint32_t>(_mm_movemask_epi8(m_ctrl)); }
+
+                private:
+                    __m128i m_ctrl;
+#else
+                    explicit Group(const int8_t* ctrl) { std::memcpy(m_ctrl, ctrl, GROUP_WIDTH); }
+
+                    uint32_t Match(int8_t h2) const
+                    {
+                        uint32_t mask = 0;
+                        for (size_t i = 0; i < GROUP_WIDTH; ++i)
+                            mask |= static_cast<uint32_t>(m_ctrl[i] == h2) << i;
+                        return mask;
+                    }
+                    uint32_t MatchEmpty() const { return Match(EMPTY); }
+                    uint32_t MatchFree() const
+                    {
+                        uint32_t mask = 0;
+                        for (size_t i = 0; i < GROUP_WIDTH; ++i)
+                            mask |= static_cast<uint32_t>(m_ctrl[i] < 0) << i;
+                        return mask;
+                    }
+
+                private:
+                    int8_t m_ctrl[GROUP_WIDTH];
+#endif
+            };
+
+            static size_t Hash(std::string_view key) { return std::hash<std::string_view>{}(key); }
+            static int8_t H2(size_t hash) { return static_cast<int8_t>(hash & 0x7F); }
+            static size_t MaxLoad(size_t capacity) { return capacity - capacity / 8; }
+            static size_t CapacityFor(size_t count)
+            {
+                return std::bit_ceil(std::max(GROUP_WIDTH, count + count / 7 + 1));
+            }
+
+            Group GroupAt(size_t first) const { return Group(m_ctrl + first); }
+
+            /**
+             * @brief Visits the groups of a hash in probe order until `visit` returns an index
+             * (or NPOS) instead of NEXT_GROUP.
+             * With a power-of-two group count the triangular steps reach every group.
+             */
+            template <typename Visit>
+            size_t Probe(size_t hash, Visit&& visit) const
+            {
+                const size_t mask = m_capacity / GROUP_WIDTH - 1;
+                size_t group = (hash >> 7) & mask;
+                for (size_t step = 1; ; ++step)
+                {
+                    const size_t first = group * GROUP_WIDTH;
+                    if (const size_t index = visit(first, GroupAt(first)); index != NEXT_GROUP)
+                        return index;
+                    group = (group + step) & mask;
+                }
+            }
+
+            size_t FindIndex(std::string_view key, size_t hash) const
+            {
+                if (m_size == 0)
+                    return NPOS;
+                const int8_t h2 = H2(hash);
+                return Probe(hash, [&](size_t first, const Group& group) -> size_t
+                {
+                    for (uint32_t match = group.Match(h2); match; match &= match - 1)
+                    {
+                        const size_t index = first + static_cast<size_t>(std::countr_zero(match));
+                        if (std::string_view(m_slots[index].first) == key)
+                            return index;
+                    }
+                    return group.MatchEmpty() ? NPOS : NEXT_GROUP;
+                });
+            }
+
+            // Gets the first empty or deleted slot of a hash's probe sequence.
+            size_t FindFree(size_t hash) const
+            {
+                return Probe(hash, [](size_t first, const Group& group) -> size_t
+                {
+                    const uint32_t free = group.MatchFree();
+                    return free ? first + static_cast<size_t>(std::countr_zero(free)) : NEXT_GROUP;
+                });
+            }
+
+            /**
+             * @brief Moves every entry into new arrays of `capacity` slots, dropping tombstones.
+             */
+            void Rehash(size_t capacity)
+            {
+                auto* ctrl = static_cast<int8_t*>(m_resource->allocate(capacity + GROUP_WIDTH, GROUP_WIDTH));
+                auto* slots = static_cast<value_type*>(m_resource->allocate(capacity * sizeof(value_type), alignof(value_type)));
+                std::memset(ctrl, EMPTY, capacity);
+                std::memset(ctrl + capacity, SENTINEL, GROUP_WIDTH);
+
+                int8_t* oldCtrl = std::exchange(m_ctrl, ctrl);
+                value_type* oldSlots = std::exchange(m_slots, slots);
+                const size_t oldCapacity = std::exchange(m_capacity, capacity);
+                for (size_t i = 0; i < oldCapacity; ++i)
+                {
+                    if (oldCtrl[i] < 0)
+                        continue;
+                    const size_t hash = Hash(oldSlots[i].first);
+                    const size_t index = FindFree(hash);
+                    ::new (static_cast<void*>(m_slots + index)) value_type(std::move(oldSlots[i]));
+                    m_ctrl[index] = H2(hash);
+                    oldSlots[i].~value_type();
+                }
+                m_growthLeft = MaxLoad(m_capacity) - m_size;
+                if (oldCapacity)
+                {
+                    m_resource->deallocate(oldCtrl, oldCapacity + GROUP_WIDTH, GROUP_WIDTH);
+                    m_resource->deallocate(oldSlots, oldCapacity * sizeof(value_type), alignof(value_type));
+                }
+            }
+
+            void DestroyAll()
+            {
+                for (size_t i = 0; i < m_capacity; ++i)
+                {
+                    if (m_ctrl[i] >= 0)
+                        m_slots[i].~value_type();
+                }
+            }
+
+            void Release()
+            {
+                if (!m_capacity)
+                    return;
+                DestroyAll();
+                m_resource->deallocate(m_ctrl, m_capacity + GROUP_WIDTH, GROUP_WIDTH);
+                m_resource->deallocate(m_slots, m_capacity * sizeof(value_type), alignof(value_type));
+                m_ctrl = nullptr;
+                m_slots = nullptr;
+                m_capacity = m_size = m_growthLeft = 0;
+            }
+
+            void Steal(FlatStringMap& other)
+            {
+                m_resource = other.m_resource;
+                m_ctrl = std::exchange(other.m_ctrl, nullptr);
+                m_slots = std::exchange(other.m_slots, nullptr);
+                m_capacity = std::exchange(other.m_capacity, 0);
+                m_size = std::exchange(other.m_size, 0);
+                m_growthLeft = std::exchange(other.m_growthLeft, 0);
+            }
+
+            std::pmr::memory_resource* m_resource = std::pmr::get_default_resource();
+            int8_t* m_ctrl = nullptr;
+            value_type* m_slots = nullptr;
+            size_t m_capacity = 0;
+            size_t m_size = 0;
+            size_t m_growthLeft = 0;
+    };
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace Utils
+{
+    inline constexpr uint64_t FNV1A_OFFSET_BASIS = 14695981039346656037ull;
+    inline constexpr uint64_t FNV1A_PRIME        = 1099511628211ull;
+
+    /**
+     * @brief Computes the 64-bit FNV-1a hash of a byte sequence.
+     * @param data The bytes to hash.
+     * @param seed Previous hash value, to hash data incrementally.
+     */
+    inline uint64_t Fnv1a64(std::string_view data, uint64_t seed = FNV1A_OFFSET_BASIS)
+    {
+        uint64_t hash = seed;
+        for (unsigned char c : data)
+        {
+            hash ^= c;
+            hash *= FNV1A_PRIME;
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Hash for string-keyed unordered containers that enables lookups by any string type
+     * (std::string, std::pmr::string, std::string_view) without building a key.
+     * Use together with TransparentStringEqual.
+     */
+    struct TransparentStringHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view text) const noexcept
+        {
+            return std::hash<std::string_view>{}(text);
+        }
+    };
+
+    /**
+     * @brief Key equality matching TransparentStringHash; compares any string types by content.
+     */
+    struct TransparentStringEqual
+    {
+        using is_transparent = void;
+
+        bool operator()(std::string_view lhs, std::string_view rhs) const noexcept
+        {
+            return lhs == rhs;
+        }
+    };
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace Utils
+{
+    /**
+     * @brief Percentiles of a latency histogram, in nanoseconds.
+     */
+    struct LatencySummary
+    {
+        uint64_t count = 0;
+        uint64_t p50 = 0;
+        uint64_t p90 = 0;
+        uint64_t p99 = 0;
+        uint64_t max = 0;
+    };
+
+    /**
+     * @brief HDR-style log-linear histogram of nanosecond latencies.
+     *
+     * Values below 32 ns get one bucket each; above that every power of two is split in 32
+     * buckets, so any recorded value is reported within ~3% of its real value. Recording is a
+     * couple of bit operations and an increment, with no allocation.
+     */
+    class LatencyHistogram
+    {
+        public:
+            static constexpr unsigned SUB_BUCKET_BITS = 5;
+            static constexpr uint64_t SUB_BUCKETS = uint64_t{1} << SUB_BUCKET_BITS;
+            static constexpr unsigned MAX_SHIFT = 36;
+            static constexpr size_t BUCKET_COUNT = SUB_BUCKETS * (MAX_SHIFT + 2);
+
+            void Record(uint64_t nanoseconds);
+            void Record(std::chrono::nanoseconds latency);
+            void Merge(const LatencyHistogram& other);
+            void Reset();
+
+            uint64_t Count() const;
+            uint64_t Max() const;
+            uint64_t Percentile(double percentile) const;
+            LatencySummary Summarize() const;
+
+            static size_t BucketIndex(uint64_t nanoseconds);
+            static uint64_t BucketUpperBound(size_t index);
+
+        private:
+            std::array<uint64_t, BUCKET_COUNT> m_buckets{};
+            uint64_t m_count = 0;
+            uint64_t m_max = 0;
+    };
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Utils
+{
+    enum class PerfEvent
+    {
+        Cycles,
+        Instructions,
+        CacheMisses,
+        BranchMisses,
+        Count
+    };
+
+    enum class PerfPhase
+    {
+        Load,
+        Parse,
+        Execute,
+        Count
+    };
+
+    /**
+     * @brief Values of the hardware counters. A counter the kernel refused to open is marked
+     * unavailable and stays at 0.
+     */
+    struct PerfCounts
+    {
+        static constexpr size_t EVENT_COUNT = static_cast<size_t>(PerfEvent::Count);
+
+        std::array<uint64_t, EVENT_COUNT> values{};
+        std::array<bool, EVENT_COUNT> available{};
+
+        uint64_t operator[](PerfEvent event) const { return values[static_cast<size_t>(event)]; }
+        bool Has(PerfEvent event) const { return available[static_cast<size_t>(event)]; }
+        bool Any() const;
+        double InstructionsPerCycle() const;
+        PerfCounts operator-(const PerfCounts& earlier) const;
+        PerfCounts& operator+=(const PerfCounts& other);
+    };
+
+    /**
+     * @brief Counters accumulated per pipeline phase.
+     */
+    struct PerfReport
+    {
+        std::array<PerfCounts, static_cast<size_t>(PerfPhase::Count)> phases{};
+
+        PerfCounts& operator[](PerfPhase phase) { return phases[static_cast<size_t>(phase)]; }
+        const PerfCounts& operator[](PerfPhase phase) const { return phases[static_cast<size_t>(phase)]; }
+        PerfReport& operator+=(const PerfReport& other);
+    };
+
+    /**
+     * @brief User-space cycles, instructions, cache misses and branch misses of the calling thread,
+     * read through Linux perf_event_open.
+     *
+     * Each counter is opened on its own, so the others keep working when the PMU lacks one of them.
+     * Where perf events are unavailable (non-Linux, containers, perf_event_paranoid > 2) every
+     * counter is unavailable and Read returns zeros.
+     */
+    class PerfCounterGroup
+    {
+        public:
+            PerfCounterGroup();
+            ~PerfCounterGroup();
+            PerfCounterGroup(const PerfCounterGroup&) = delete;
+            PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+            bool IsAvailable() const;
+            PerfCounts Read() const;
+
+            static PerfCounterGroup& ForCurrentThread();
+            static const char* EventName(PerfEvent event);
+            static const char* PhaseName(PerfPhase phase);
+
+        private:
+            std::array<int, PerfCounts::EVENT_COUNT> m_descriptors;
+    };
+
+    /**
+     * @brief Adds the counters of the calling thread, from construction to destruction, to `target`.
+     * Does nothing when `target` is nullptr.
+     */
+    class ScopedPerfPhase
+    {
+        public:
+            explicit ScopedPerfPhase(PerfCounts* target)
+                : m_target(target)
+            {
+                if (m_target)
+                    m_start = PerfCounterGroup::ForCurrentThread().Read();
+            }
+            ~ScopedPerfPhase()
+            {
+                if (m_target)
+                    *m_target += PerfCounterGroup::ForCurrentThread().Read() - m_start;
+            }
+            ScopedPerfPhase(const ScopedPerfPhase&) = delete;
+            ScopedPerfPhase& operator=(const ScopedPerfPhase&) = delete;
+
+        private:
+            PerfCounts* m_target;
+            PerfCounts m_start;
+    };
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Utils
+{
+    size_t PeakResidentBytes();
+    size_t CurrentResidentBytes();
+}
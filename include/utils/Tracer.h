@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+
+namespace Utils
+{
+    /**
+     * @brief Records timed spans into per-thread buffers and writes them as Chrome trace-event JSON
+     * (viewable in Perfetto or chrome://tracing).
+     *
+     * Each thread appends to its own chunked buffer without locks; chunks are only allocated when
+     * the current one is full. The buffer of a thread that exits is reused by the next new thread.
+     * While tracing is stopped a span costs one relaxed atomic load.
+     * Start, Stop and WriteChromeTrace must not run concurrently with traced work.
+     */
+    class Tracer
+    {
+        public:
+            static constexpr size_t DEFAULT_MAX_EVENTS_PER_THREAD = size_t{1} << 20;
+
+            static void Start(size_t maxEventsPerThread = DEFAULT_MAX_EVENTS_PER_THREAD);
+            static void Stop();
+            static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+            static size_t EventCount();
+            static size_t DroppedEvents();
+            static void WriteChromeTrace(std::ostream& out);
+            static bool WriteChromeTrace(const std::string_view& path);
+
+            static void Record(const char* name, const char* category, std::string_view detail,
+                               std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+        private:
+            inline static std::atomic<bool> s_enabled{false};
+    };
+
+    /**
+     * @brief Records a complete ("X") event covering the lifetime of the object.
+     * `name` and `category` must be string literals (or otherwise outlive the trace);
+     * `detail` is copied (truncated) when the span ends.
+     */
+    class TraceSpan
+    {
+        public:
+            TraceSpan(const char* name, const char* category, std::string_view detail = {})
+                : m_name(name), m_category(category), m_detail(detail), m_enabled(Tracer::IsEnabled())
+            {
+                if (m_enabled)
+                    m_start = std::chrono::steady_clock::now();
+            }
+            ~TraceSpan()
+            {
+                if (m_enabled)
+                    Tracer::Record(m_name, m_category, m_detail, m_start, std::chrono::steady_clock::now());
+            }
+            TraceSpan(const TraceSpan&) = delete;
+            TraceSpan& operator=(const TraceSpan&) = delete;
+
+        private:
+            const char* m_name;
+            const char* m_category;
+            std::string_view m_detail;
+            bool m_enabled;
+            std::chrono::steady_clock::time_point m_start;
+    };
+}
@@ -1,14 +1,158 @@
 #pragma once
 #include "commands/ICommand.h"
+#include "commands/CommandRecord.h"
 #include <functional>
 #include<memory>
+#include <memory_resource>
 #include <vector>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
 
 namespace TasksTypes
 {
-    using CommandList = std::vector<std::unique_ptr<Commands::ICommand>>;
+    using CommandArgs = std::span<const std::string_view>;
+    using CommandFactory = std::function<std::unique_ptr<Commands::ICommand>(CommandArgs)>;
+    using RecordFactory = std::function<Commands::CommandRecord(CommandArgs)>;
+
+    /**
+     * @brief Immutable text of the arguments of one task file's commands.
+     *
+     * Each argument is copied once into a monotonic buffer sized after the file, and the
+     * commands keep std::string_view's into it, so a parsed line costs no string allocation.
+     * Nothing is freed until the pool is destroyed together with the commands that view it.
+     */
+    class ArgumentPool
+    {
+        public:
+            explicit ArgumentPool(size_t initialBytes)
+                : m_resource(initialBytes + 64) {}
+            ArgumentPool(const ArgumentPool&) = delete;
+            ArgumentPool& operator=(const ArgumentPool&) = delete;
+
+            std::string_view Store(std::string_view text)
+            {
+                if (text.empty())
+                    return {};
+
+                auto* copy = static_cast<char*>(m_resource.allocate(text.size(), 1));
+                std::memcpy(copy, text.data(), text.size());
+                m_bytes += text.size();
+                return {copy, text.size()};
+            }
+
+            size_t GetBytes() const { return m_bytes; }
+
+        private:
+            std::pmr::monotonic_buffer_resource m_resource;
+            size_t m_bytes = 0;
+    };
+
+    /**
+     * @brief The commands of one task file, created through the ICommand interface, with the
+     * pool their arguments point into.
+     */
+    struct CommandList
+    {
+        std::vector<std::unique_ptr<Commands::ICommand>> commands;
+        std::unique_ptr<ArgumentPool> arguments;
+    };
     using ParsedTasks = std::vector<std::pair<std::string, CommandList>>;
-    using CommandFactory = std::function<std::unique_ptr<Commands::ICommand>(const std::vector<std::string>&)>;
+
+    /**
+     * @brief The command records of one task file, with the pool their arguments point into.
+     * Moving the program keeps the views valid; the pool goes away with the records.
+     */
+    struct CommandProgram
+    {
+        std::vector<Commands::CommandRecord> records;
+        std::unique_ptr<ArgumentPool> arguments;
+    };
+    using ParsedProgram = std::vector<std::pair<std::string, CommandProgram>>;
     using TaskFile = std::pair<std::string, std::vector<std::string>>;
     using ListOfTaskFiles = std::vector<TaskFile>;
-}
\ No newline at end of file
+    using CompiledCommands = std::vector<TaskFile>;
+    using TaskLines = std::pmr::vector<std::string_view>;
+
+    /**
+     * @brief Memory of a task file on its way through load and parse.
+     *
+     * The file text (or compiled bytes) and the views of its lines are allocated from a monotonic
+     * buffer sized after the file, so loading a file costs a few upstream allocations instead of one
+     * per line, and everything is returned at once when the arena is destroyed (after the file ran).
+     */
+    struct TaskArena
+    {
+        explicit TaskArena(size_t initialBytes)
+            : resource(initialBytes + 256), content(&resource), lines(&resource) {}
+        TaskArena(const TaskArena&) = delete;
+        TaskArena& operator=(const TaskArena&) = delete;
+
+        std::pmr::monotonic_buffer_resource resource;
+        std::pmr::string content;
+        TaskLines lines;
+    };
+
+    /**
+     * @brief One command of a compiled task file: the id of its name in the string table and the
+     * range of its arguments.
+     */
+    struct CompiledCommand
+    {
+        uint32_t nameId = 0;
+        uint32_t firstArgument = 0;
+        uint32_t argumentCount = 0;
+    };
+
+    /**
+     * @brief The commands of a compiled task file, read in place.
+     * Every string is a view into `blob`, the interned strings of the file, so the views live as
+     * long as the bytes the file was read from.
+     */
+    struct CompiledTasks
+    {
+        uint64_t sourceChecksum = 0;
+        std::string_view blob;
+        std::vector<std::string_view> strings;
+        std::vector<CompiledCommand> commands;
+        std::vector<std::string_view> arguments;
+
+        std::string_view Name(const CompiledCommand& command) const { return strings[command.nameId]; }
+        std::span<const std::string_view> Arguments(const CompiledCommand& command) const
+        {
+            return std::span<const std::string_view>(arguments).subspan(command.firstArgument, command.argumentCount);
+        }
+    };
+
+    /**
+     * @brief A task file as found on disk: either its raw lines, or its already tokenized
+     * commands when a valid compiled file was loaded instead.
+     * The lines, or the compiled strings, are views into the bytes kept by `arena`, which lives
+     * as long as the source.
+     */
+    struct TaskSource
+    {
+        std::string fileName;
+        std::unique_ptr<TaskArena> arena;
+        std::span<const std::string_view> lines;
+        std::optional<CompiledTasks> compiled;
+        uint64_t contentHash = 0;
+    };
+    using ListOfTaskSources = std::vector<TaskSource>;
+
+    /**
+     * @brief A task file found while scanning the task directory, before it is read.
+     */
+    struct TaskFileEntry
+    {
+        std::filesystem::path path;
+        std::string fileName;
+        uintmax_t size = 0;
+        std::filesystem::file_time_type lastWrite{};
+    };
+    using ListOfTaskFileEntries = std::vector<TaskFileEntry>;
+}
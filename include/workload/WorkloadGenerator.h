@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace Workload
+{
+    /**
+     * @brief Relative weights of the commands written to the workload files.
+     */
+    struct CommandMix
+    {
+        double createUser = 4;
+        double deleteUser = 2;
+        double disableUser = 2;
+        double sendMessage = 40;
+        double addUserToGroup = 12;
+        double removeUserFromGroup = 6;
+        double ping = 10;
+        double getMessageHistory = 20;
+        double getUsers = 0.02;
+        double getGroups = 0.02;
+    };
+
+    /**
+     * @brief Shape of a synthetic task directory. The same spec and seed always produce the same files.
+     */
+    struct WorkloadSpec
+    {
+        uint64_t seed = 1;
+        size_t files = 10;
+        size_t linesPerFile = 1000;
+        size_t users = 1000;
+        size_t groups = 32;
+        size_t groupsPerUser = 1;
+        double userZipfExponent = 1.0;
+        double groupZipfExponent = 1.0;
+        size_t meanMessageLength = 32;
+        size_t maxMessageLength = 256;
+        double quotedMessageDensity = 0.8;
+        double commentLineDensity = 0.05;
+        double trailingCommentDensity = 0.05;
+        double failureRate = 0.0; ///< Chance per command of a failing one, which ends its file.
+        CommandMix mix;
+    };
+
+    /**
+     * @brief Totals of a generated workload.
+     */
+    struct WorkloadStats
+    {
+        size_t files = 0;
+        size_t lines = 0;
+        size_t commands = 0;
+        size_t injectedFailures = 0;
+        size_t bytes = 0;
+    };
+
+    /**
+     * @brief Samples ranks 0..n-1 with probability proportional to 1 / (rank + 1)^exponent.
+     */
+    class ZipfDistribution
+    {
+        public:
+            ZipfDistribution(size_t n, double exponent);
+            size_t operator()(uint64_t randomBits) const;
+            size_t size() const;
+
+        private:
+            std::vector<double> m_cdf;
+    };
+
+    /**
+     * @brief Writes reproducible task directories of any size.
+     *
+     * The first file (`task_000000.txt`) creates every user and their group memberships; each of
+     * the following `files` files holds `linesPerFile` lines drawn from the command mix. Files are
+     * generated in order because later files depend on the memberships added by earlier ones.
+     */
+    class WorkloadGenerator
+    {
+        public:
+            explicit WorkloadGenerator(WorkloadSpec spec);
+
+            WorkloadStats WriteDirectory(const std::filesystem::path& directory);
+            std::vector<std::string> GenerateFile(size_t fileIndex);
+            static std::string FileName(size_t fileIndex);
+            static std::string UserName(size_t userId);
+            static std::string GroupName(size_t groupId);
+            const WorkloadSpec& GetSpec() const;
+            const WorkloadStats& GetStats() const;
+
+        private:
+            template <typename Emit>
+            void GenerateInto(size_t fileIndex, Emit&& emit);
+            template <typename Emit>
+            void GenerateBootstrap(Emit&& emit);
+            template <typename Emit>
+            void GenerateCommands(size_t fileIndex, Emit&& emit);
+
+            WorkloadSpec m_spec;
+            ZipfDistribution m_userPopularity;
+            ZipfDistribution m_groupPopularity;
+            std::vector<double> m_mixCdf;
+            std::unordered_set<uint64_t> m_memberships;
+            WorkloadStats m_stats;
+    };
+}
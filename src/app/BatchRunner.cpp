@@ -0,0 +1,357 @@
+#include "app/BatchRunner.h"
+#include "app/TaskManager.h"
+#include "app/TaskDirectoryWatcher.h"
+#include "commandresult/OutputPrinter.h"
+#include "commands/PingCommand.h"
+#include "domain/MessageLog.h"
+#include "errorhandling/exceptions/InvalidArgumentException.h"
+#include "utils/ProcessStats.h"
+#include "utils/Tracer.h"
+
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace ErrorHandling::Exceptions;
+using CommandResult::OutputPrinter;
+namespace fs = std::filesystem;
+
+namespace App
+{
+    namespace
+    {
+        unsigned ParseCount(const std::string& option, const std::string& value)
+        {
+            unsigned count = 0;
+            auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), count);
+            if (error != std::errc() || end != value.data() + value.size() || count == 0)
+                throw InvalidArgumentException(option, "expects a positive number, got '" + value + "'");
+            return count;
+        }
+    }
+    /**
+     * @brief Constructs a runner with the given options.
+     */
+    BatchRunner::BatchRunner(BatchOptions options)
+        : m_options(std::move(options))
+    {
+    }
+    /**
+     * @brief Parses the command line of a headless run.
+     *
+     * @param arguments The arguments without the program name.
+     * @return The parsed options.
+     * @throws InvalidArgumentException If an option is unknown, lacks its value or has an invalid value.
+     */
+    BatchOptions BatchRunner::ParseArguments(const std::vector<std::string>& arguments)
+    {
+        BatchOptions options;
+        for (size_t i = 0; i < arguments.size(); ++i)
+        {
+            const std::string& option = arguments[i];
+            auto value = [&]() -> const std::string&
+            {
+                if (i + 1 >= arguments.size())
+                    throw InvalidArgumentException(option, "missing value");
+                return arguments[++i];
+            };
+
+            if (option == "--tasks")
+                options.tasksPath = value();
+            else if (option == "--output")
+                options.output = value();
+            else if (option == "--trace")
+                options.tracePath = value();
+            else if (option == "--threads")
+                options.threads = ParseCount(option, value());
+            else if (option == "--repeat")
+                options.repeat = ParseCount(option, value());
+            else if (option == "--no-cache")
+                options.useCache = false;
+            else if (option == "--compile")
+                options.compile = true;
+            else if (option == "--verbose-ping")
+                options.verbosePing = true;
+            else if (option == "--perf")
+                options.perfCounters = true;
+            else if (option == "--index-messages")
+                options.indexMessages = true;
+            else if (option == "--compress-messages")
+                options.compressMessages = true;
+            else if (option == "--retain-messages")
+                options.retainMessages = ParseCount(option, value());
+            else if (option == "--retain-bytes")
+                options.retainBytes = ParseCount(option, value());
+            else if (option == "--atomic-files")
+                options.atomicFiles = true;
+            else if (option == "--watch")
+                options.watch = true;
+            else if (option == "--help" || option == "-h")
+                options.help = true;
+            else
+                throw InvalidArgumentException(option, "unknown option");
+        }
+        return options;
+    }
+    /**
+     * @brief Prints the command line help.
+     */
+    void BatchRunner::PrintUsage(std::ostream& out)
+    {
+        out << "Usage: user_mgmt_system [options]\n"
+            << "Without options the interactive menu is shown.\n\n"
+            << "  --tasks DIR      Task directory (default: ../tasks)\n"
+            << "  --output SINK    Command output: '-' (stdout, default), 'null' or a file path\n"
+            << "  --trace FILE     Writes a Chrome trace-event timeline (Perfetto, chrome://tracing)\n"
+            << "  --threads N      Threads that load and parse task files (default: 1)\n"
+            << "  --repeat N       Runs the directory N times, each on a fresh system state (default: 1)\n"
+            << "  --no-cache       Re-parses every file on every repetition\n"
+            << "  --compile        Compiles the task files to .umtb before running\n"
+            << "  --verbose-ping   Prints two lines per ping instead of one summary line per PING\n"
+            << "  --perf           Collects cycles, instructions, cache and branch misses per phase (Linux)\n"
+            << "  --index-messages Keeps an inverted index of message terms for SEARCH MESSAGES\n"
+            << "  --compress-messages  Seals and compresses (LZ4) each history's older message blocks\n"
+            << "  --retain-messages N  Keeps only the newest N messages of each user\n"
+            << "  --retain-bytes N     Keeps only the newest messages of each user that fit in N bytes\n"
+            << "  --atomic-files   Undoes the changes of a task file when one of its commands fails\n"
+            << "  --watch          After running, executes new task files until SIGINT/SIGTERM\n"
+            << "  --help           Shows this help\n";
+    }
+    /**
+     * @brief Prints the timing summary of a run.
+     */
+    void BatchRunner::PrintSummary(std::ostream& out, const BatchSummary& summary)
+    {
+        const double seconds = std::chrono::duration<double>(summary.wallTime).count();
+        const double commandsPerSecond = seconds > 0 ? static_cast<double>(summary.commands) / seconds : 0.0;
+        out << std::fixed << std::setprecision(3)
+            << "[Summary] wall time: " << seconds * 1000.0 << " ms"
+            << ", files: " << summary.files
+            << ", failed: " << summary.failedFiles
+            << ", commands: " << summary.commands
+            << ", commands/sec: " << std::setprecision(0) << commandsPerSecond
+            << ", peak RSS: " << std::setprecision(1) << static_cast<double>(summary.peakResidentBytes) / (1024.0 * 1024.0) << " MiB\n"
+            << std::defaultfloat;
+        if (summary.rolledBackFiles > 0)
+            out << "[Summary] rolled back files: " << summary.rolledBackFiles << '\n';
+
+        PrintLatencyReport(out, "Execute latency", summary.executeLatency);
+        PrintLatencyReport(out, "Parse latency", summary.parseLatency);
+        if (Utils::AllocationTracker::IsEnabled())
+            PrintAllocationReport(out, summary.allocations, summary.commands);
+        if (summary.perf)
+            PrintPerfReport(out, *summary.perf);
+    }
+    /**
+     * @brief Prints p50/p90/p99/max per command (or line) type, in microseconds. Prints nothing for an empty report.
+     */
+    void BatchRunner::PrintLatencyReport(std::ostream& out, const std::string& title, const LatencyReport& report)
+    {
+        if (report.empty())
+            return;
+
+        auto micros = [](uint64_t nanoseconds) { return static_cast<double>(nanoseconds) / 1000.0; };
+        out << "[" << title << " (us)]\n"
+            << std::left << std::setw(26) << "  type" << std::right
+            << std::setw(10) << "count" << std::setw(10) << "p50" << std::setw(10) << "p90"
+            << std::setw(10) << "p99" << std::setw(12) << "max" << '\n'
+            << std::fixed << std::setprecision(2);
+        for (const auto& [type, summary] : report)
+        {
+            out << "  " << std::left << std::setw(24) << type << std::right
+                << std::setw(10) << summary.count << std::setw(10) << micros(summary.p50)
+                << std::setw(10) << micros(summary.p90) << std::setw(10) << micros(summary.p99)
+                << std::setw(12) << micros(summary.max) << '\n';
+        }
+        out << std::defaultfloat;
+    }
+    /**
+     * @brief Prints allocations and bytes per pipeline phase and per command type.
+     */
+    void BatchRunner::PrintAllocationReport(std::ostream& out, const Utils::AllocationReport& report, size_t commands)
+    {
+        using Utils::AllocationPhase;
+        using Utils::AllocationTracker;
+
+        auto row = [&](const std::string& name, const Utils::AllocationCounters& counters)
+        {
+            out << "  " << std::left << std::setw(24) << name << std::right
+                << std::setw(14) << counters.allocations << std::setw(16) << counters.bytes
+                << std::setw(14) << counters.deallocations << '\n';
+        };
+
+        const auto total = report.Total();
+        out << "[Allocations] " << total.allocations << " total, "
+            << std::fixed << std::setprecision(1)
+            << (commands ? static_cast<double>(total.allocations) / static_cast<double>(commands) : 0.0)
+            << " per command\n" << std::defaultfloat
+            << std::left << std::setw(26) << "  phase / command" << std::right
+            << std::setw(14) << "allocations" << std::setw(16) << "bytes" << std::setw(14) << "frees" << '\n';
+        for (size_t phase = 0; phase < report.phases.size(); ++phase)
+            row(AllocationTracker::PhaseName(static_cast<AllocationPhase>(phase)), report.phases[phase]);
+        for (size_t type = 0; type < Commands::COMMAND_RECORD_NAMES.size(); ++type)
+        {
+            if (report.commandTypes[type].allocations > 0)
+                row(Commands::COMMAND_RECORD_NAMES[type], report.commandTypes[type]);
+        }
+    }
+    /**
+     * @brief Prints the hardware counters per phase, with IPC and misses per thousand instructions.
+     */
+    void BatchRunner::PrintPerfReport(std::ostream& out, const Utils::PerfReport& report)
+    {
+        using Utils::PerfCounterGroup;
+        using Utils::PerfEvent;
+        using Utils::PerfPhase;
+
+        bool available = false;
+        for (const auto& phase : report.phases)
+            available = available || phase.Any();
+        if (!available)
+        {
+            out << "[Perf counters] unavailable (no PMU access: check perf_event_paranoid or container limits)\n";
+            return;
+        }
+
+        auto perThousand = [](const Utils::PerfCounts& counts, PerfEvent event)
+        {
+            const auto instructions = counts[PerfEvent::Instructions];
+            return instructions ? 1000.0 * static_cast<double>(counts[event]) / static_cast<double>(instructions) : 0.0;
+        };
+
+        out << "[Perf counters]\n" << std::left << std::setw(12) << "  phase" << std::right;
+        for (size_t event = 0; event < Utils::PerfCounts::EVENT_COUNT; ++event)
+            out << std::setw(16) << PerfCounterGroup::EventName(static_cast<PerfEvent>(event));
+        out << std::setw(8) << "IPC" << std::setw(12) << "cache MPKI" << std::setw(12) << "branch MPKI" << '\n';
+        for (size_t phase = 0; phase < report.phases.size(); ++phase)
+        {
+            const auto& counts = report.phases[phase];
+            out << "  " << std::left << std::setw(10) << PerfCounterGroup::PhaseName(static_cast<PerfPhase>(phase)) << std::right;
+            for (size_t event = 0; event < Utils::PerfCounts::EVENT_COUNT; ++event)
+            {
+                if (counts.available[event])
+                    out << std::setw(16) << counts.values[event];
+                else
+                    out << std::setw(16) << "n/a";
+            }
+            out << std::fixed << std::setprecision(2) << std::setw(8) << counts.InstructionsPerCycle()
+                << std::setw(12) << perThousand(counts, PerfEvent::CacheMisses)
+                << std::setw(12) << perThousand(counts, PerfEvent::BranchMisses) << '\n' << std::defaultfloat;
+        }
+    }
+    /**
+     * @brief Runs the task directory `repeat` times and then, if requested, watches it.
+     *
+     * @param stopRequested Stops watch mode when set (e.g. from a signal handler).
+     * @return 0 on success, EXIT_TASK_FAILURE if a task file failed, EXIT_USAGE_ERROR if the
+     * task directory or the output sink cannot be used.
+     */
+    int BatchRunner::Run(const std::atomic<bool>& stopRequested)
+    {
+        m_summary = {};
+        const std::string tasksPath = fs::absolute(m_options.tasksPath).string();
+        if (!fs::is_directory(tasksPath))
+        {
+            std::cerr << "❌ Path does not exist: " << tasksPath << "\n";
+            return EXIT_USAGE_ERROR;
+        }
+
+        std::ofstream file;
+        std::ostream* sink = &std::cout;
+        if (m_options.output == "null")
+        {
+            sink = nullptr;
+        }
+        else if (m_options.output != "-")
+        {
+            file.open(m_options.output, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                std::cerr << "❌ Cannot open output file: " << m_options.output << "\n";
+                return EXIT_USAGE_ERROR;
+            }
+            sink = &file;
+        }
+        OutputPrinter::SetOutputStream(sink);
+        Commands::PingCommand::SetOutputMode(m_options.verbosePing ? Commands::PingOutputMode::Verbose
+                                                                   : Commands::PingOutputMode::Summary);
+
+        if (!m_options.tracePath.empty())
+            Utils::Tracer::Start();
+
+        TaskManager manager(tasksPath);
+        manager.SetWorkerThreads(m_options.threads);
+        if (!m_options.useCache)
+            manager.SetProgramCacheCapacity(0);
+        if (m_options.compile)
+            manager.CompileTaskFiles();
+        manager.SetPerfCountersEnabled(m_options.perfCounters);
+        manager.SetAtomicFiles(m_options.atomicFiles);
+        Domain::MessageLog::SetCompressionEnabled(m_options.compressMessages);
+
+        // Watch before the first run, so files dropped while it runs are not missed.
+        TaskDirectoryWatcher watcher(manager, tasksPath);
+        const bool watching = m_options.watch && watcher.Start();
+        if (m_options.watch && !watching)
+            std::cerr << "❌ Cannot watch: " << tasksPath << "\n";
+
+        auto addStats = [this](const RunStats& stats)
+        {
+            m_summary.files += stats.files;
+            m_summary.failedFiles += stats.failedFiles;
+            m_summary.rolledBackFiles += stats.rolledBackFiles;
+            m_summary.commands += stats.commands;
+        };
+
+        const auto allocationsBefore = Utils::AllocationTracker::Snapshot();
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned run = 0; run < m_options.repeat; ++run)
+        {
+            auto state = std::make_shared<Domain::SystemState>();
+            state->SetMessageIndexEnabled(m_options.indexMessages);
+            state->SetRetentionPolicy({m_options.retainMessages, m_options.retainBytes});
+            manager.SetState(std::move(state));
+            manager.RunTasksFromFiles();
+            addStats(manager.GetLastRunStats());
+        }
+        m_summary.wallTime = std::chrono::steady_clock::now() - start;
+
+        if (watching)
+        {
+            watcher.MarkProcessed(manager.GetLastRunFiles());
+            watcher.Run(stopRequested);
+            // Only the time spent running watched files counts, not the time spent waiting for them.
+            for (const auto& report : watcher.GetReports())
+            {
+                addStats(report.stats);
+                m_summary.wallTime += report.runTime;
+            }
+        }
+        m_summary.executeLatency = manager.GetExecuteLatencyReport();
+        m_summary.parseLatency = manager.GetParseLatencyReport();
+        m_summary.allocations = Utils::AllocationTracker::Snapshot() - allocationsBefore;
+        m_summary.peakResidentBytes = Utils::PeakResidentBytes();
+        if (m_options.perfCounters)
+            m_summary.perf = manager.GetPerfReport();
+
+        OutputPrinter::SetOutputStream(&std::cout);
+        if (!m_options.tracePath.empty())
+        {
+            Utils::Tracer::Stop();
+            if (!Utils::Tracer::WriteChromeTrace(m_options.tracePath))
+                std::cerr << "❌ Cannot write trace file: " << m_options.tracePath << "\n";
+            else if (Utils::Tracer::DroppedEvents() > 0)
+                std::cerr << "[Trace] " << Utils::Tracer::DroppedEvents() << " events dropped (per-thread limit reached)\n";
+        }
+        return m_summary.failedFiles > 0 ? EXIT_TASK_FAILURE : EXIT_SUCCESS;
+    }
+    /**
+     * @brief Gets the totals of the last Run.
+     */
+    const BatchSummary& BatchRunner::GetSummary() const
+    {
+        return m_summary;
+    }
+}
@@ -6,9 +6,13 @@
 #include "commands/ExitCommand.h"
 #include "commands/GetGroupsCommand.h"
 #include "commands/GetMessageHistoryCommand.h"
+#include "commands/GetPingStatsCommand.h"
+#include "commands/GetStatsCommand.h"
 #include "commands/GetUsersCommand.h"
 #include "commands/PingCommand.h"
 #include "commands/RemoveUserFromGroupCommand.h"
+#include "commands/SearchMessagesCommand.h"
+#include "commands/SendGroupMessageCommand.h"
 #include "commands/SendMessageCommand.h"
 #include "utils/CommandStrings.h"
 #include "errorhandling/exceptions/AllExceptions.h"
@@ -26,70 +30,110 @@ namespace App
      */
     CommandRegistry::CommandRegistry()
     {
-        registerCommand(CMD_ADD_USER_TO_GROUP, [](const std::vector<std::string>& args)
+        registerBuiltin(CMD_ADD_USER_TO_GROUP, [](CommandArgs args)
                     {
                         if(args.size() != 2) throw InvalidArgumentException(std::string(CMD_ADD_USER_TO_GROUP), " Command Expects 2 Argument.");
-                        return std::make_unique<Commands::AddUserToGroupCommand>(args[0], args[1]);
+                        return Commands::CommandRecord(std::in_place_type<Commands::AddUserToGroupCommand>, args[0], args[1]);
                     });
 
-        registerCommand(CMD_CREATE_USER, [](const std::vector<std::string>& args)
+        registerBuiltin(CMD_CREATE_USER, [](CommandArgs args)
                     {
                         if(args.size() != 1)throw InvalidArgumentException(std::string(CMD_CREATE_USER),  " Command Expects 1 Argument.");
-                        return std::make_unique<Commands::CreateUserCommand>(args[0]);
+                        return Commands::CommandRecord(std::in_place_type<Commands::CreateUserCommand>, args[0]);
                     });
 
-        registerCommand(CMD_DELETE_USER, [](const std::vector<std::string>& args)
+        registerBuiltin(CMD_DELETE_USER, [](CommandArgs args)
                     {
                         if(args.size() != 1)throw InvalidArgumentException(std::string(CMD_DELETE_USER), " Command Expects 1 Argument.");
-                        return std::make_unique<Commands::DeleteUserCommand>(args[0]);
+                        return Commands::CommandRecord(std::in_place_type<Commands::DeleteUserCommand>, args[0]);
                     });
 
-        registerCommand(CMD_DISABLE_USER, [](const std::vector<std::string>& args)
+        registerBuiltin(CMD_DISABLE_USER, [](CommandArgs args)
                     {
                         if(args.size() != 1)throw InvalidArgumentException(std::string(CMD_DISABLE_USER), " Command Expects 1 Argument.");
-                        return std::make_unique<Commands::DisableUserCommand>(args[0]);
+                        return Commands::CommandRecord(std::in_place_type<Commands::DisableUserCommand>, args[0]);
                     });
 
-        registerCommand(CMD_EXIT, [](const std::vector<std::string>& args)
+        registerBuiltin(CMD_EXIT, [](CommandArgs args)
                     {
                         if(!args.empty())throw InvalidArgumentException(std::string(CMD_EXIT)," Command Expects NO Arguments.");
-                        return std::make_unique<Commands::ExitCommand>();
+                        return Commands::CommandRecord(std::in_place_type<Commands::ExitCommand>);
                     });
 
-        registerCommand(CMD_GET_GROUPS, [](const std::vector<std::string>& args)
+        registerBuiltin(CMD_GET_GROUPS, [](CommandArgs args)
                     {
                         if(!args.empty())throw InvalidArgumentException(std::string(CMD_GET_GROUPS)," Command Expects NO Arguments.");
-                        return std::make_unique<Commands::GetGroupsCommand>();
+                        return Commands::CommandRecord(std::in_place_type<Commands::GetGroupsCommand>);
                     });
 
-        registerCommand(CMD_GET_MESSAGE_HISTORY, [](const std::vector<std::string>& args)
+        registerBuiltin(CMD_GET_MESSAGE_HISTORY, [](CommandArgs args)
                     {
                         if(args.size() != 1)throw InvalidArgumentException(std::string(CMD_GET_MESSAGE_HISTORY), " Command Expects 1 Argument.");
-                        return std::make_unique<Commands::GetMessageHistoryCommand>(args[0]);
+                        return Commands::CommandRecord(std::in_place_type<Commands::GetMessageHistoryCommand>, args[0]);
                     });
 
-        registerCommand(CMD_GET_USERS, [](const std::vector<std::string>& args)
+        registerBuiltin(CMD_GET_PING_STATS, [](CommandArgs args)
+                    {
+                        if(!args.empty())throw InvalidArgumentException(std::string(CMD_GET_PING_STATS), " Command Expects NO Arguments.");
+                        return Commands::CommandRecord(std::in_place_type<Commands::GetPingStatsCommand>);
+                    });
+
+        registerBuiltin(CMD_GET_STATS, [](CommandArgs args)
+                    {
+                        if(!args.empty())throw InvalidArgumentException(std::string(CMD_GET_STATS), " Command Expects NO Arguments.");
+                        return Commands::CommandRecord(std::in_place_type<Commands::GetStatsCommand>);
+                    });
+
+        registerBuiltin(CMD_GET_USERS, [](CommandArgs args)
                     {
                         if(!args.empty())throw InvalidArgumentException(std::string(CMD_GET_USERS), " Command Expects NO Arguments.");
-                        return std::make_unique<Commands::GetUsersCommand>();
+                        return Commands::CommandRecord(std::in_place_type<Commands::GetUsersCommand>);
+                    });
+
+        registerBuiltin(CMD_GET_USERS_PREFIX, [](CommandArgs args)
+                    {
+                        if(args.empty() || args.size() > 2)throw InvalidArgumentException(std::string(CMD_GET_USERS_PREFIX), " Command Expects 1 or 2 Arguments.");
+                        if(args.size() == 1)
+                            return Commands::CommandRecord(std::in_place_type<Commands::GetUsersCommand>, Commands::UserQuery::Prefix, args[0]);
+                        return Commands::CommandRecord(std::in_place_type<Commands::GetUsersCommand>, Commands::UserQuery::Prefix, args[0], args[1]);
+                    });
+
+        registerBuiltin(CMD_GET_USERS_AFTER, [](CommandArgs args)
+                    {
+                        if(args.empty() || args.size() > 2)throw InvalidArgumentException(std::string(CMD_GET_USERS_AFTER), " Command Expects 1 or 2 Arguments.");
+                        if(args.size() == 1)
+                            return Commands::CommandRecord(std::in_place_type<Commands::GetUsersCommand>, Commands::UserQuery::After, args[0]);
+                        return Commands::CommandRecord(std::in_place_type<Commands::GetUsersCommand>, Commands::UserQuery::After, args[0], args[1]);
                     });
 
-        registerCommand(CMD_PING, [](const std::vector<std::string>& args)
+        registerBuiltin(CMD_PING, [](CommandArgs args)
                     {
                         if(args.size() != 2)throw InvalidArgumentException(std::string(CMD_PING), " Command Expects 2 Argument.");
-                        return std::make_unique<Commands::PingCommand>(args[0], args[1]);
+                        return Commands::CommandRecord(std::in_place_type<Commands::PingCommand>, args[0], args[1]);
                     });
 
-        registerCommand(CMD_REMOVE_USER_FROM_GROUP, [](const std::vector<std::string>& args)
+        registerBuiltin(CMD_REMOVE_USER_FROM_GROUP, [](CommandArgs args)
                     {
                         if(args.size() != 2)throw InvalidArgumentException(std::string(CMD_REMOVE_USER_FROM_GROUP), " Command Expects 2 Arguments.");
-                        return std::make_unique<Commands::RemoveUserFromGroupCommand>(args[0], args[1]);
+                        return Commands::CommandRecord(std::in_place_type<Commands::RemoveUserFromGroupCommand>, args[0], args[1]);
+                    });
+
+        registerBuiltin(CMD_SEARCH_MESSAGES, [](CommandArgs args)
+                    {
+                        if(args.size() != 1)throw InvalidArgumentException(std::string(CMD_SEARCH_MESSAGES), " Command Expects 1 Argument.");
+                        return Commands::CommandRecord(std::in_place_type<Commands::SearchMessagesCommand>, args[0]);
                     });
 
-        registerCommand(CMD_SEND_MESSAGE, [](const std::vector<std::string>& args)
+        registerBuiltin(CMD_SEND_MESSAGE, [](CommandArgs args)
                     {
                         if(args.size() != 2)throw InvalidArgumentException(std::string(CMD_SEND_MESSAGE)," Command Expects 2 Arguments.");
-                        return std::make_unique<Commands::SendMessageCommand>(args[0], args[1]);
+                        return Commands::CommandRecord(std::in_place_type<Commands::SendMessageCommand>, args[0], args[1]);
+                    });
+
+        registerBuiltin(CMD_SEND_MESSAGE_TO_GROUP, [](CommandArgs args)
+                    {
+                        if(args.size() != 2)throw InvalidArgumentException(std::string(CMD_SEND_MESSAGE_TO_GROUP)," Command Expects 2 Arguments.");
+                        return Commands::CommandRecord(std::in_place_type<Commands::SendGroupMessageCommand>, args[0], args[1]);
                     });
     }
     /**
@@ -100,26 +144,66 @@ namespace App
      */
     void CommandRegistry::registerCommand(const std::string &commandKey, CommandFactory command_task)
     {
-        m_registryMap[commandKey] = std::move(command_task);
+        m_registryMap[commandKey] = [command_task = std::move(command_task)](CommandArgs args)
+                    {
+                        return Commands::CommandRecord(command_task(args));
+                    };
+    }
+    /**
+     * @brief Registers a built-in command whose factory builds the command by value.
+     *
+     * @param commandKey The key that identifies the command.
+     * @param record_task A factory lambda that returns the command as a CommandRecord.
+     */
+    void CommandRegistry::registerBuiltin(const std::string &commandKey, RecordFactory record_task)
+    {
+        m_registryMap[commandKey] = std::move(record_task);
     }
     /**
      * @brief Creates a command instance from the registered commands.
      *
      * @param commandName The name/key of the command to create.
-     * @param args The arguments to be passed to the command constructor.
+     * @param args The arguments to be passed to the command constructor; the command may keep views into them.
      * @return std::unique_ptr<ICommand> The constructed command object.
      *
      * @throws InvalidCommandException if the command name is not registered.
      * @throws InvalidArgumentException if the argument count is invalid for the given command.
      */
-    std::unique_ptr<Commands::ICommand> CommandRegistry::createCommand(const std::string &commnadName, const std::vector<std::string> &args) const
+    std::unique_ptr<Commands::ICommand> CommandRegistry::createCommand(std::string_view commnadName, CommandArgs args) const
+    {
+        return Commands::ToCommand(createRecord(commnadName, args));
+    }
+    /**
+     * @brief Creates a command record from the registered commands.
+     *
+     * @param commandName The name/key of the command to create.
+     * @param args The arguments to be passed to the command constructor; the command may keep views into them.
+     * @return Commands::CommandRecord The command stored by value, or the ICommand of an extension command.
+     *
+     * @throws InvalidCommandException if the command name is not registered.
+     * @throws InvalidArgumentException if the argument count is invalid for the given command.
+     */
+    Commands::CommandRecord CommandRegistry::createRecord(std::string_view commnadName, CommandArgs args) const
+    {
+        return findRecordFactory(commnadName)(args);
+    }
+    /**
+     * @brief Looks up the factory of a registered command, so callers that create the same command
+     * many times (e.g. the commands of a compiled task file) resolve its name once.
+     *
+     * @param commandName The name/key of the command.
+     * @return The factory; it stays valid while the registry lives and no command is registered.
+     *
+     * @throws InvalidCommandException if the command name is not registered.
+     */
+    const RecordFactory& CommandRegistry::findRecordFactory(std::string_view commandName) const
     {
-        auto itr = m_registryMap.find(commnadName);
+        auto itr = m_registryMap.find(commandName);
 
         if(itr == m_registryMap.end())
-            throw InvalidCommandException(commnadName, "Does not exist");
+            throw InvalidCommandException(std::string(commandName), "Does not exist");
 
-        return itr->second(args);
+        return itr->second;
     }
 
 }
\ No newline at end of file
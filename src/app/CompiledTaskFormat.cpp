@@ -0,0 +1,191 @@
+#include "app/CompiledTaskFormat.h"
+#include "errorhandling/exceptions/AllExceptions.h"
+
+#include <cstring>
+#include <unordered_map>
+
+using namespace ErrorHandling::Exceptions;
+using namespace TasksTypes;
+
+/*
+ * Layout (host byte order, little endian on every supported platform):
+ *
+ *   Header        magic[4] | u16 version | u16 flags | u64 sourceChecksum
+ *                 u32 stringCount | u32 commandCount | u32 argumentCount | u32 stringBytes
+ *   Offsets       u32[stringCount + 1]             start of each string in the blob
+ *   Blob          char[stringBytes]                 interned command names and arguments
+ *   Commands      {u32 nameId, u32 firstArg, u32 argCount}[commandCount]
+ *   Arguments     u32[argumentCount]                string ids referenced by the commands
+ */
+namespace App::CompiledTaskFormat
+{
+    namespace
+    {
+        constexpr size_t HEADER_SIZE = 4 + 2 + 2 + 8 + 4 * 4;
+        constexpr size_t COMMAND_SIZE = 3 * sizeof(uint32_t);
+
+        template<typename T>
+        void Append(std::string& out, T value)
+        {
+            char bytes[sizeof(T)];
+            std::memcpy(bytes, &value, sizeof(T));
+            out.append(bytes, sizeof(T));
+        }
+
+        template<typename T>
+        T ReadAt(std::string_view bytes, size_t offset)
+        {
+            if (offset + sizeof(T) > bytes.size())
+                throw CommandExecutionException("LoadCompiledTasks", " Truncated compiled task file");
+
+            T value;
+            std::memcpy(&value, bytes.data() + offset, sizeof(T));
+            return value;
+        }
+
+        void CheckHeader(std::string_view bytes)
+        {
+            if (bytes.size() < HEADER_SIZE || std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) != 0)
+                throw CommandExecutionException("LoadCompiledTasks", " Not a compiled task file");
+
+            if (ReadAt<uint16_t>(bytes, 4) != VERSION)
+                throw CommandExecutionException("LoadCompiledTasks", " Unsupported compiled task file version");
+        }
+    }
+    /**
+     * @brief Serializes tokenized commands into the compiled task file format.
+     * Command names and arguments are interned, so repeated strings are stored once.
+     * @param commands The tokenized commands, in execution order.
+     * @param sourceChecksum FNV-1a checksum of the text file the commands were compiled from.
+     * @return The bytes of the compiled file.
+     */
+    std::string Serialize(const CompiledCommands& commands, uint64_t sourceChecksum)
+    {
+        std::unordered_map<std::string_view, uint32_t> ids;
+        std::vector<std::string_view> strings;
+        auto intern = [&](const std::string& value) -> uint32_t
+        {
+            auto [itr, inserted] = ids.try_emplace(value, static_cast<uint32_t>(strings.size()));
+            if (inserted)
+                strings.push_back(value);
+            return itr->second;
+        };
+
+        std::vector<uint32_t> commandTable;
+        std::vector<uint32_t> argumentTable;
+        commandTable.reserve(commands.size() * 3);
+        for (const auto& [name, args] : commands)
+        {
+            commandTable.push_back(intern(name));
+            commandTable.push_back(static_cast<uint32_t>(argumentTable.size()));
+            commandTable.push_back(static_cast<uint32_t>(args.size()));
+            for (const auto& arg : args)
+                argumentTable.push_back(intern(arg));
+        }
+
+        uint32_t stringBytes = 0;
+        for (auto value : strings)
+            stringBytes += static_cast<uint32_t>(value.size());
+
+        std::string out;
+        out.reserve(HEADER_SIZE + (strings.size() + 1) * 4 + stringBytes + commandTable.size() * 4 + argumentTable.size() * 4);
+        out.append(MAGIC, sizeof(MAGIC));
+        Append<uint16_t>(out, VERSION);
+        Append<uint16_t>(out, 0);
+        Append<uint64_t>(out, sourceChecksum);
+        Append<uint32_t>(out, static_cast<uint32_t>(strings.size()));
+        Append<uint32_t>(out, static_cast<uint32_t>(commands.size()));
+        Append<uint32_t>(out, static_cast<uint32_t>(argumentTable.size()));
+        Append<uint32_t>(out, stringBytes);
+
+        uint32_t offset = 0;
+        for (auto value : strings)
+        {
+            Append<uint32_t>(out, offset);
+            offset += static_cast<uint32_t>(value.size());
+        }
+        Append<uint32_t>(out, offset);
+
+        for (auto value : strings)
+            out.append(value);
+        for (auto value : commandTable)
+            Append<uint32_t>(out, value);
+        for (auto value : argumentTable)
+            Append<uint32_t>(out, value);
+
+        return out;
+    }
+    /**
+     * @brief Reads the commands stored in a compiled task file, in place.
+     * Names and arguments are views into `bytes`, so nothing is copied per string; command names
+     * keep their string id, so a reader can resolve each distinct name once.
+     * @param bytes The contents of the compiled file; must outlive the result.
+     * @return The source checksum and the commands.
+     * @throws CommandExecutionException if the file is truncated, corrupt or of another version.
+     */
+    CompiledTasks Deserialize(std::string_view bytes)
+    {
+        CheckHeader(bytes);
+
+        CompiledTasks compiled;
+        compiled.sourceChecksum = ReadAt<uint64_t>(bytes, 8);
+        const auto stringCount   = ReadAt<uint32_t>(bytes, 16);
+        const auto commandCount  = ReadAt<uint32_t>(bytes, 20);
+        const auto argumentCount = ReadAt<uint32_t>(bytes, 24);
+        const auto stringBytes   = ReadAt<uint32_t>(bytes, 28);
+
+        const size_t offsetsAt   = HEADER_SIZE;
+        const size_t blobAt      = offsetsAt + (static_cast<size_t>(stringCount) + 1) * sizeof(uint32_t);
+        const size_t commandsAt  = blobAt + stringBytes;
+        const size_t argumentsAt = commandsAt + static_cast<size_t>(commandCount) * COMMAND_SIZE;
+        const size_t totalSize   = argumentsAt + static_cast<size_t>(argumentCount) * sizeof(uint32_t);
+
+        if (bytes.size() != totalSize)
+            throw CommandExecutionException("LoadCompiledTasks", " Corrupt compiled task file");
+
+        compiled.blob = bytes.substr(blobAt, stringBytes);
+        compiled.strings.reserve(stringCount);
+        for (uint32_t id = 0; id < stringCount; ++id)
+        {
+            const auto begin = ReadAt<uint32_t>(bytes, offsetsAt + id * sizeof(uint32_t));
+            const auto end   = ReadAt<uint32_t>(bytes, offsetsAt + (id + 1) * sizeof(uint32_t));
+            if (begin > end || end > stringBytes)
+                throw CommandExecutionException("LoadCompiledTasks", " Corrupt string table in compiled task file");
+
+            compiled.strings.push_back(compiled.blob.substr(begin, end - begin));
+        }
+
+        auto checkId = [&](uint32_t id)
+        {
+            if (id >= stringCount)
+                throw CommandExecutionException("LoadCompiledTasks", " Corrupt string id in compiled task file");
+            return id;
+        };
+
+        compiled.arguments.reserve(argumentCount);
+        for (uint32_t a = 0; a < argumentCount; ++a)
+            compiled.arguments.push_back(compiled.strings[checkId(ReadAt<uint32_t>(bytes, argumentsAt + a * sizeof(uint32_t)))]);
+
+        compiled.commands.reserve(commandCount);
+        for (uint32_t i = 0; i < commandCount; ++i)
+        {
+            const size_t entry = commandsAt + i * COMMAND_SIZE;
+            CompiledCommand command{checkId(ReadAt<uint32_t>(bytes, entry)), ReadAt<uint32_t>(bytes, entry + 4), ReadAt<uint32_t>(bytes, entry + 8)};
+            if (static_cast<uint64_t>(command.firstArgument) + command.argumentCount > argumentCount)
+                throw CommandExecutionException("LoadCompiledTasks", " Corrupt argument table in compiled task file");
+
+            compiled.commands.push_back(command);
+        }
+
+        return compiled;
+    }
+    /**
+     * @brief Reads only the source checksum of a compiled task file.
+     * @throws CommandExecutionException if the header is not a supported compiled file header.
+     */
+    uint64_t ReadSourceChecksum(std::string_view bytes)
+    {
+        CheckHeader(bytes);
+        return ReadAt<uint64_t>(bytes, 8);
+    }
+}
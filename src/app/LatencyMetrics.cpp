@@ -0,0 +1,71 @@
+#include "app/LatencyMetrics.h"
+
+namespace App
+{
+    /**
+     * @brief Copies the histograms of another instance.
+     */
+    LatencyMetrics::LatencyMetrics(const LatencyMetrics& other)
+    {
+        std::lock_guard lock(other.m_mutex);
+        m_histograms = other.m_histograms;
+    }
+    /**
+     * @brief Replaces the histograms with those of another instance.
+     */
+    LatencyMetrics& LatencyMetrics::operator=(const LatencyMetrics& other)
+    {
+        if (this != &other)
+        {
+            std::scoped_lock lock(m_mutex, other.m_mutex);
+            m_histograms = other.m_histograms;
+        }
+        return *this;
+    }
+    /**
+     * @brief Adds every histogram of another instance (e.g. the one filled while parsing a file),
+     * type by type. Types the other instance never recorded are skipped.
+     */
+    void LatencyMetrics::Merge(const LatencyMetrics& other)
+    {
+        std::scoped_lock lock(m_mutex, other.m_mutex);
+        for (size_t type = 0; type < LINE_TYPE_COUNT; ++type)
+        {
+            if (other.m_histograms[type].Count() > 0)
+                m_histograms[type].Merge(other.m_histograms[type]);
+        }
+    }
+    /**
+     * @brief Forgets every recorded latency.
+     */
+    void LatencyMetrics::Reset()
+    {
+        std::lock_guard lock(m_mutex);
+        for (auto& histogram : m_histograms)
+        {
+            if (histogram.Count() > 0)
+                histogram.Reset();
+        }
+    }
+    /**
+     * @brief Gets count, p50, p90, p99 and max per recorded type, keyed by TypeName.
+     */
+    LatencyReport LatencyMetrics::GetReport() const
+    {
+        std::lock_guard lock(m_mutex);
+        LatencyReport report;
+        for (size_t type = 0; type < LINE_TYPE_COUNT; ++type)
+        {
+            if (m_histograms[type].Count() > 0)
+                report.emplace(TypeName(type), m_histograms[type].Summarize());
+        }
+        return report;
+    }
+    /**
+     * @brief Gets the name of a line type: the command name, or "COMMENT OR BLANK".
+     */
+    const char* LatencyMetrics::TypeName(size_t type)
+    {
+        return type == COMMENT_LINE_TYPE ? "COMMENT OR BLANK" : Commands::COMMAND_RECORD_NAMES[type];
+    }
+}
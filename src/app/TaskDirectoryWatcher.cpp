@@ -0,0 +1,210 @@
+#include "app/TaskDirectoryWatcher.h"
+#include "app/TaskFileLoader.h"
+#include "commandresult/OutputPrinter.h"
+#include "utils/Hash.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using CommandResult::OutputPrinter;
+namespace fs = std::filesystem;
+
+namespace App
+{
+    namespace
+    {
+        constexpr int RUN_POLL_INTERVAL_MS = 200;
+
+        bool IsTextTaskFile(const std::string& fileName)
+        {
+            return fs::path(fileName).extension() == ".txt";
+        }
+    }
+    /**
+     * @brief Constructs a watcher that runs new task files through the given TaskManager.
+     * @param manager The TaskManager (and therefore the SystemState) the files are applied to.
+     * @param directoryPath The task directory to watch.
+     */
+    TaskDirectoryWatcher::TaskDirectoryWatcher(TaskManager& manager, std::string directoryPath)
+        : m_manager(manager), m_directoryPath(std::move(directoryPath)) {}
+
+    TaskDirectoryWatcher::~TaskDirectoryWatcher()
+    {
+#ifdef __linux__
+        if (m_inotifyFd >= 0)
+            close(m_inotifyFd);
+#endif
+    }
+    /**
+     * @brief Starts watching the directory.
+     *
+     * Call it before running the files already in the directory, then pass the files that run
+     * executed to MarkProcessed: files that arrive in the meantime are reported by the next PollOnce.
+     *
+     * @return false if the directory cannot be watched (missing directory, inotify unavailable or not Linux).
+     */
+    bool TaskDirectoryWatcher::Start()
+    {
+#ifdef __linux__
+        if (m_inotifyFd >= 0)
+            return true;
+
+        m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_inotifyFd < 0)
+        {
+            std::cerr << "[ERROR] inotify is not available" << std::endl;
+            return false;
+        }
+        if (inotify_add_watch(m_inotifyFd, m_directoryPath.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+        {
+            std::cerr << "[ERROR] Cannot watch directory: " << m_directoryPath << std::endl;
+            close(m_inotifyFd);
+            m_inotifyFd = -1;
+            return false;
+        }
+        return true;
+#else
+        std::cerr << "[ERROR] Watch mode is only available on Linux" << std::endl;
+        return false;
+#endif
+    }
+    /**
+     * @brief Records files as processed, so events for the same contents do not run them again.
+     * @param files The files a TaskManager run executed (TaskManager::GetLastRunFiles).
+     */
+    void TaskDirectoryWatcher::MarkProcessed(const std::vector<ExecutedTaskFile>& files)
+    {
+        for (const auto& file : files)
+            m_processed[file.fileName] = file.contentHash;
+    }
+    /**
+     * @brief Waits for directory events and executes the task files they report.
+     * @param timeoutMs Maximum time to wait for the first event, in milliseconds.
+     * @return The number of task files executed.
+     */
+    size_t TaskDirectoryWatcher::PollOnce(int timeoutMs)
+    {
+        size_t processed = 0;
+#ifdef __linux__
+        if (m_inotifyFd < 0)
+            return processed;
+
+        pollfd descriptor{m_inotifyFd, POLLIN, 0};
+        if (poll(&descriptor, 1, timeoutMs) <= 0)
+            return processed;
+
+        const auto detectedAt = std::chrono::steady_clock::now();
+        alignas(inotify_event) char buffer[4096];
+        std::vector<std::string> arrived;
+        bool overflowed = false;
+        for (;;)
+        {
+            const ssize_t length = read(m_inotifyFd, buffer, sizeof(buffer));
+            if (length <= 0)
+                break;
+
+            for (ssize_t offset = 0; offset < length;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                if (event->mask & IN_Q_OVERFLOW)
+                    overflowed = true;
+                if (event->len == 0 || (event->mask & IN_ISDIR))
+                    continue;
+
+                std::string fileName(event->name);
+                if (IsTextTaskFile(fileName))
+                    arrived.push_back(std::move(fileName));
+            }
+        }
+
+        // Events were dropped: rescan, ProcessFile skips the files whose contents already ran.
+        if (overflowed)
+        {
+            std::cerr << "[WARNING] inotify queue overflowed, rescanning: " << m_directoryPath << std::endl;
+            arrived.clear();
+            std::error_code error;
+            for (const auto& entry : fs::directory_iterator(m_directoryPath, error))
+            {
+                auto fileName = entry.path().filename().string();
+                if (entry.is_regular_file(error) && IsTextTaskFile(fileName))
+                    arrived.push_back(std::move(fileName));
+            }
+            std::sort(arrived.begin(), arrived.end());
+        }
+
+        for (const auto& fileName : arrived)
+        {
+            if (ProcessFile(fileName, detectedAt))
+                ++processed;
+        }
+#else
+        (void)timeoutMs;
+#endif
+        return processed;
+    }
+    /**
+     * @brief Watches the directory until stop is requested.
+     * @param stopRequested Set to true (from another thread) to return.
+     */
+    void TaskDirectoryWatcher::Run(const std::atomic<bool>& stopRequested)
+    {
+        while (!stopRequested.load())
+        {
+            PollOnce(RUN_POLL_INTERVAL_MS);
+        }
+    }
+    /**
+     * @brief Gets the latency of every task file executed so far.
+     */
+    const std::vector<WatchedTaskReport>& TaskDirectoryWatcher::GetReports() const
+    {
+        return m_reports;
+    }
+    /**
+     * @brief Executes a task file unless a file with the same name and contents was already processed.
+     * The file is only recorded as processed once it ran, so a file that could not be read is retried
+     * on its next event.
+     * @return true if the file was executed.
+     */
+    bool TaskDirectoryWatcher::ProcessFile(const std::string& fileName, std::chrono::steady_clock::time_point detectedAt)
+    {
+        const auto path = fs::path(m_directoryPath) / fileName;
+        std::string content;
+        if (!TaskFileLoader::ReadWholeFile(path, content))
+            return false;
+
+        auto itr = m_processed.find(fileName);
+        if (itr != m_processed.end() && itr->second == Utils::Fnv1a64(content))
+            return false;
+
+        std::error_code error;
+        const auto writtenAt = fs::last_write_time(path, error);
+        const auto runStart = std::chrono::steady_clock::now();
+        if (!m_manager.RunTaskFile(path))
+            return false;
+
+        // Remember the contents that actually ran, which may be newer than the ones hashed above.
+        MarkProcessed(m_manager.GetLastRunFiles());
+
+        WatchedTaskReport report{fileName};
+        const auto appliedAt = std::chrono::steady_clock::now();
+        report.detectedToApplied = appliedAt - detectedAt;
+        report.runTime = appliedAt - runStart;
+        report.stats = m_manager.GetLastRunStats();
+        if (!error)
+            report.writtenToApplied = std::chrono::duration_cast<std::chrono::nanoseconds>(fs::file_time_type::clock::now() - writtenAt);
+
+        OutputPrinter::PrintWatchedTask(fileName, report.detectedToApplied, report.writtenToApplied);
+        m_reports.push_back(std::move(report));
+        return true;
+    }
+}
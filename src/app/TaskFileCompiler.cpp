@@ -0,0 +1,98 @@
+#include "app/TaskFileCompiler.h"
+#include "app/TaskFileLoader.h"
+#include "app/CompiledTaskFormat.h"
+#include "errorhandling/ErrorHandler.h"
+#include "utils/Hash.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace ErrorHandling::Exceptions;
+using namespace TasksTypes;
+namespace fs = std::filesystem;
+
+namespace App
+{
+    /**
+     * @brief Constructs a compiler that validates commands against the given registry.
+     * @param registry The registry used to check every compiled command.
+     */
+    TaskFileCompiler::TaskFileCompiler(const CommandRegistry& registry)
+        : m_registry(registry), m_parser(registry) {}
+    /**
+     * @brief Compiles a `.txt` task file into a `.umtb` file next to it.
+     *
+     * The file is tokenized and every command is checked against the registry, so only files
+     * that would parse successfully are compiled. The compiled file records the checksum of
+     * the text it was built from.
+     *
+     * @param sourcePath The text task file.
+     * @return true if the compiled file was written.
+     */
+    bool TaskFileCompiler::CompileFile(const fs::path& sourcePath) const
+    {
+        std::string content;
+        if (!TaskFileLoader::ReadWholeFile(sourcePath, content))
+        {
+            std::cerr << "[WARNING] Could not open file: " << sourcePath << std::endl;
+            return false;
+        }
+
+        CompiledCommands commands;
+        try
+        {
+            commands = m_parser.TokenizeTasks(TaskFileLoader::SplitTaskLineViews(content));
+            for (const auto& [commandName, args] : commands)
+            {
+                const std::vector<std::string_view> views(args.begin(), args.end());
+                m_registry.createRecord(commandName, views);
+            }
+        }
+        catch (const BaseException& e)
+        {
+            ErrorHandler::Handle(e, "CompileTaskFile");
+            return false;
+        }
+
+        auto compiledPath = fs::path(sourcePath).replace_extension(CompiledTaskFormat::EXTENSION);
+        std::ofstream out(compiledPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+        {
+            std::cerr << "[WARNING] Could not write file: " << compiledPath << std::endl;
+            return false;
+        }
+
+        out << CompiledTaskFormat::Serialize(commands, Utils::Fnv1a64(content));
+        return static_cast<bool>(out);
+    }
+    /**
+     * @brief Compiles every `.txt` task file of a directory.
+     * @param directoryPath The task directory.
+     * @return The number of files compiled.
+     */
+    size_t TaskFileCompiler::CompileDirectory(const std::string& directoryPath) const
+    {
+        size_t compiled = 0;
+        try
+        {
+            if (!fs::exists(directoryPath) || !fs::is_directory(directoryPath))
+            {
+                std::cerr << "[ERROR] Directory not found: " << directoryPath << std::endl;
+                return compiled;
+            }
+
+            for (const auto& entry : fs::directory_iterator(directoryPath))
+            {
+                if (!entry.is_regular_file() || entry.path().extension() != ".txt") continue;
+
+                if (CompileFile(entry.path()))
+                    ++compiled;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "[EXCEPTION] While compiling tasks: " << e.what() << std::endl;
+        }
+        return compiled;
+    }
+}
@@ -2,6 +2,16 @@
 #include "commandresult/OutputPrinter.h"
 #include "errorhandling/ErrorHandler.h"
 #include "commands/ExitCommand.h"
+#include "app/TaskFileCompiler.h"
+#include "utils/AllocationTracker.h"
+#include "utils/Tracer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 
 using namespace TasksTypes;
 using CommandResult::OutputPrinter;
@@ -45,12 +55,18 @@ namespace App
      * @brief Loads and executes all tasks from the loaded task files.
      *
      * Steps:
-     * - Loads all task files from the specified directory.
-     * - Parses each line into a command name and argument list.
+     * - Scans the task directory.
+     * - Reuses the cached program of every file that did not change since the previous run.
+     * - Otherwise loads the file, using its compiled task file when it is up to date.
+     * - Parses each line into a command name and argument list (compiled files are already tokenized).
      * - Searches for the command in the registry.
      * - Executes the command using the provided system state.
      *
+     * With more than one worker thread, files are loaded and parsed in parallel; execution and
+     * output always happen in directory order on the calling thread.
+     *
      * If a command is not found or fails, it prints an error and stops processing the current task file.
+     * With SetAtomicFiles(true), the changes the file made before the failure are also undone.
      */
     void TaskManager::RunTasksFromFiles()
     {
@@ -58,62 +74,370 @@ namespace App
         {
             throw std::runtime_error("[TaskManager] SystemState has not been set!");
         }
+        m_lastRun = {};
+        m_lastRunFiles.clear();
         try
         {
-            ListOfTaskFiles taskFiles = m_loader->LoadAllTasks();
-            for (const auto& [fileName, lines] : taskFiles)
+            ListOfTaskFileEntries entries;
             {
-                auto name = fileName;
-                OutputPrinter::PrintTaskStart(fileName);
-                ParsedTasks parsed = m_parser->ParseTasks(fileName, lines);
+                Utils::ScopedPerfPhase perf(PerfTarget(m_perfReport, Utils::PerfPhase::Load));
+                entries = m_loader->ScanTaskFiles();
+            }
+            std::vector<PreparedTask> prepared(entries.size());
+            if (m_workerThreads > 1)
+                PrepareInParallel(entries, prepared);
 
-                if (parsed.empty())
-                {
-                    OutputPrinter::PrintTaskFailure(fileName);
-                    continue;
-                }
-                bool executionFailedForThisFile = false;
-                for (const auto& [commandName, commands] : parsed)
+            std::unordered_set<std::string> livePaths;
+            for (size_t i = 0; i < entries.size(); ++i)
+            {
+                livePaths.insert(entries[i].path.string());
+                RunTaskEntry(entries[i], &prepared[i]);
+            }
+            m_programCache.RetainOnly(livePaths);
+        }
+        catch(const BaseException& e)
+        {
+            ErrorHandler::Handle(e, "TaskManager->RunTasksFromFiles");
+        }
+    }
+    /**
+     * @brief Loads and executes a single task file, e.g. one that just arrived in the task directory.
+     *
+     * @param taskFilePath The `.txt` or `.umtb` task file.
+     * @return true if the file was loaded and executed (even if one of its commands failed).
+     */
+    bool TaskManager::RunTaskFile(const std::filesystem::path& taskFilePath)
+    {
+        if (!m_state)
+        {
+            throw std::runtime_error("[TaskManager] SystemState has not been set!");
+        }
+        m_lastRun = {};
+        m_lastRunFiles.clear();
+        auto entry = TaskFileLoader::DescribeFile(taskFilePath);
+        if (!entry)
+            return false;
+
+        try
+        {
+            return RunTaskEntry(*entry);
+        }
+        catch(const BaseException& e)
+        {
+            ErrorHandler::Handle(e, "TaskManager->RunTaskFile");
+            return false;
+        }
+    }
+    /**
+     * @brief Gets the directory the task files are loaded from.
+     */
+    const std::string& TaskManager::GetTasksPath() const
+    {
+        return m_loader->GetDirectoryPath();
+    }
+    /**
+     * @brief Loads and parses, on worker threads, every file that is not already in the program cache.
+     * Parse errors are kept and reported when the file is reached during execution.
+     *
+     * @param entries The scanned task files.
+     * @param prepared Receives the loaded source and program (or error) of each file, by index.
+     */
+    void TaskManager::PrepareInParallel(const ListOfTaskFileEntries& entries, std::vector<PreparedTask>& prepared)
+    {
+        std::vector<size_t> pending;
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            if (!m_programCache.Contains(entries[i]))
+                pending.push_back(i);
+        }
+
+        std::atomic<size_t> next{0};
+        std::mutex perfMutex;
+        auto worker = [&]()
+        {
+            Utils::PerfReport perfReport;
+            for (size_t n = next++; n < pending.size(); n = next++)
+            {
+                auto& task = prepared[pending[n]];
+                task.attempted = true;
                 {
-                    for (auto& command : commands)
-                    {
-                        if (command)
-                        {
-                            try
-                            {
-                                command->execute(*m_state);
-                            }
-                            catch(const BaseException& e)
-                            {
-                                ErrorHandler::Handle(e, "Command Execution");
-                                executionFailedForThisFile = true;
-                                break;
-                            }
-                        }
-                        if (Commands::ExitCommand::wasTriggered())
-                        {
-                            Commands::ExitCommand::reset();
-                            break;
-                        }
-                    }
-                    if (executionFailedForThisFile || Commands::ExitCommand::wasTriggered())
-                    {
-                        break;
-                    }
+                    Utils::ScopedPerfPhase perf(PerfTarget(perfReport, Utils::PerfPhase::Load));
+                    task.source = m_loader->LoadSource(entries[pending[n]]);
                 }
-                if (executionFailedForThisFile)
+                if (!task.source)
+                    continue;
+
+                try
                 {
-                    OutputPrinter::PrintTaskFailure(fileName);
+                    Utils::ScopedPerfPhase perf(PerfTarget(perfReport, Utils::PerfPhase::Parse));
+                    task.program = task.source->compiled ? m_parser->CreateProgram(*task.source->compiled)
+                                                         : m_parser->CreateProgram(task.source->lines);
                 }
-                else if (!Commands::ExitCommand::wasTriggered())
+                catch (...)
                 {
-                    OutputPrinter::PrintTaskSuccess(fileName);
+                    task.error = std::current_exception();
                 }
             }
+            std::lock_guard lock(perfMutex);
+            m_perfReport += perfReport;
+        };
+
+        const size_t threadCount = std::min<size_t>(m_workerThreads, pending.size());
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < threadCount; ++i)
+            threads.emplace_back(worker);
+        worker();
+        for (auto& thread : threads)
+            thread.join();
+    }
+    /**
+     * @brief Parses (or takes from the program cache) and executes one task file.
+     * Once snapshot readers exist, the changes of the file are published when it ends.
+     * In atomic file mode the file runs in a state transaction that is rolled back if a command fails.
+     *
+     * @param entry The scanned task file.
+     * @param prepared The file already loaded and parsed by a worker thread, if any.
+     * @return false if the file could not be read.
+     */
+    bool TaskManager::RunTaskEntry(const TaskFileEntry& entry, PreparedTask* prepared)
+    {
+        Utils::TraceSpan span("task", "task", entry.fileName);
+        const bool isPrepared = prepared && prepared->attempted;
+        uint64_t contentHash = 0;
+        auto program = m_programCache.Find(entry, &contentHash);
+        std::optional<TaskSource> source;
+        if (!program)
+        {
+            if (isPrepared)
+            {
+                source = std::move(prepared->source);
+            }
+            else
+            {
+                Utils::ScopedPerfPhase perf(PerfTarget(m_perfReport, Utils::PerfPhase::Load));
+                source = m_loader->LoadSource(entry);
+            }
+            if (!source)
+                return false;
+
+            contentHash = source->contentHash;
+            program = m_programCache.FindByContent(entry, contentHash);
         }
-        catch(const BaseException& e)
+
+        ++m_lastRun.files;
+        m_lastRunFiles.push_back({entry.fileName, contentHash});
+        OutputPrinter::PrintTaskStart(entry.fileName);
+        if (!program)
         {
-            ErrorHandler::Handle(e, "TaskManager->RunTasksFromFiles");
+            try
+            {
+                if (isPrepared && prepared->error)
+                    std::rethrow_exception(prepared->error);
+
+                Utils::ScopedPerfPhase perf(isPrepared ? nullptr : PerfTarget(m_perfReport, Utils::PerfPhase::Parse));
+                CommandProgram created = isPrepared ? std::move(prepared->program)
+                                       : source->compiled ? m_parser->CreateProgram(*source->compiled)
+                                                          : m_parser->CreateProgram(source->lines);
+                program = m_programCache.Insert(entry, contentHash, std::move(created), entry.size);
+            }
+            catch (const BaseException& e)
+            {
+                ErrorHandler::Handle(e, "CreateCommandFromLine");
+                ++m_lastRun.failedFiles;
+                OutputPrinter::PrintTaskFailure(entry.fileName);
+                return true;
+            }
+        }
+
+        if (m_atomicFiles)
+            m_state->BeginTransaction();
+        bool completed = false;
+        try
+        {
+            completed = ExecuteProgram(*program);
+        }
+        catch (...)
+        {
+            if (m_atomicFiles)
+                m_state->RollbackTransaction();
+            throw;
         }
+
+        size_t undone = 0;
+        if (m_atomicFiles && completed)
+            m_state->CommitTransaction();
+        else if (m_atomicFiles)
+            undone = m_state->RollbackTransaction();
+        m_state->PublishPending();
+        if (!completed)
+        {
+            ++m_lastRun.failedFiles;
+            if (m_atomicFiles)
+            {
+                ++m_lastRun.rolledBackFiles;
+                OutputPrinter::PrintTaskRollback(entry.fileName, undone);
+            }
+            OutputPrinter::PrintTaskFailure(entry.fileName);
+        }
+        else if (!Commands::ExitCommand::wasTriggered())
+        {
+            OutputPrinter::PrintTaskSuccess(entry.fileName);
+        }
+        return true;
+    }
+    /**
+     * @brief Sets how many threads load and parse task files during RunTasksFromFiles.
+     *
+     * @param threads Number of threads, including the calling one. 0 and 1 keep everything on the calling thread.
+     */
+    void TaskManager::SetWorkerThreads(unsigned threads)
+    {
+        m_workerThreads = std::max(1u, threads);
+    }
+    /**
+     * @brief Makes every task file all or nothing: when one of its commands fails, the changes made by
+     * the earlier commands of that file are undone from an undo log (in time proportional to them).
+     * Output already printed by those commands is not taken back.
+     *
+     * @param atomic true for all-or-nothing files; false (default) keeps the changes made before the failure.
+     */
+    void TaskManager::SetAtomicFiles(bool atomic)
+    {
+        m_atomicFiles = atomic;
+    }
+    /**
+     * @brief Gets the number of files, failed files and executed commands of the last run.
+     */
+    const RunStats& TaskManager::GetLastRunStats() const
+    {
+        return m_lastRun;
+    }
+    /**
+     * @brief Gets the files the last run loaded and executed, in execution order, with the hash of the
+     * contents that ran (files that could not be read are not listed).
+     */
+    const std::vector<ExecutedTaskFile>& TaskManager::GetLastRunFiles() const
+    {
+        return m_lastRunFiles;
+    }
+    /**
+     * @brief Sets the memory budget of the parsed program cache.
+     *
+     * @param capacityBytes Approximate upper bound in bytes. 0 disables caching, so every run re-parses every file.
+     */
+    void TaskManager::SetProgramCacheCapacity(size_t capacityBytes)
+    {
+        m_programCache.SetCapacity(capacityBytes);
+    }
+    /**
+     * @brief Gets the size and hit/miss counters of the parsed program cache.
+     */
+    ProgramCacheStats TaskManager::GetProgramCacheStats() const
+    {
+        return m_programCache.GetStats();
+    }
+    /**
+     * @brief Compiles every text task file of the task directory into a binary task file.
+     *
+     * @return The number of files compiled.
+     */
+    size_t TaskManager::CompileTaskFiles() const
+    {
+        return TaskFileCompiler(m_registry).CompileDirectory(m_loader->GetDirectoryPath());
+    }
+    /**
+     * @brief Executes a parsed command program against the current system state.
+     *
+     * Runs every command record in order through a single dispatch loop. Execution stops at the
+     * first failing command or when an EXIT command is reached.
+     *
+     * When built with USER_MGMT_ENABLE_METRICS, the latency of every command (failed ones
+     * included) is recorded in the histogram of its command type.
+     *
+     * @param program The command records of a single task file.
+     * @return true if the program ran to completion (or to EXIT), false if a command failed.
+     */
+    bool TaskManager::ExecuteProgram(CommandProgram& program)
+    {
+        Utils::ScopedAllocationPhase allocationPhase(Utils::AllocationPhase::Execute);
+        Utils::ScopedPerfPhase perf(PerfTarget(m_perfReport, Utils::PerfPhase::Execute));
+        for (auto& record : program.records)
+        {
+            Utils::ScopedAllocationCommand allocationCommand(record.index());
+            Utils::TraceSpan span(Commands::COMMAND_RECORD_NAMES[record.index()], "execute");
+            ++m_lastRun.commands;
+#ifdef USER_MGMT_ENABLE_METRICS
+            const auto start = std::chrono::steady_clock::now();
+#endif
+            try
+            {
+                Commands::ExecuteRecord(record, *m_state);
+            }
+            catch(const BaseException& e)
+            {
+#ifdef USER_MGMT_ENABLE_METRICS
+                m_executeLatency.Record(record.index(), std::chrono::steady_clock::now() - start);
+#endif
+                ErrorHandler::Handle(e, "Command Execution");
+                return false;
+            }
+#ifdef USER_MGMT_ENABLE_METRICS
+            m_executeLatency.Record(record.index(), std::chrono::steady_clock::now() - start);
+#endif
+            if (Commands::ExitCommand::wasTriggered())
+            {
+                Commands::ExitCommand::reset();
+                break;
+            }
+        }
+        return true;
+    }
+    /**
+     * @brief Gets the execution latency per command type since the last reset.
+     * Empty when built without USER_MGMT_ENABLE_METRICS.
+     */
+    LatencyReport TaskManager::GetExecuteLatencyReport() const
+    {
+        return m_executeLatency.GetReport();
+    }
+    /**
+     * @brief Gets the parse time per line type since the last reset.
+     */
+    LatencyReport TaskManager::GetParseLatencyReport() const
+    {
+        return m_parser->GetParseLatencyReport();
+    }
+    /**
+     * @brief Forgets the recorded execution and parse latencies.
+     */
+    void TaskManager::ResetLatencyMetrics()
+    {
+        m_executeLatency.Reset();
+        m_parser->ResetParseLatency();
+    }
+    /**
+     * @brief Starts (or stops) collecting hardware counters around the load, parse and execute phases.
+     * Enabling forgets the counters collected so far. Counters that cannot be opened are reported as unavailable.
+     */
+    void TaskManager::SetPerfCountersEnabled(bool enabled)
+    {
+        m_perfEnabled = enabled;
+        m_perfReport = {};
+    }
+    /**
+     * @brief Gets the hardware counters per phase collected since SetPerfCountersEnabled(true).
+     */
+    const Utils::PerfReport& TaskManager::GetPerfReport() const
+    {
+        return m_perfReport;
+    }
+    /**
+     * @brief Gets where a phase measurement must be added, or nullptr when nothing must be measured.
+     */
+    Utils::PerfCounts* TaskManager::PerfTarget(Utils::PerfReport& report, Utils::PerfPhase phase)
+    {
+        if (!m_perfEnabled)
+            return nullptr;
+        return &report[phase];
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,153 @@
+#include "app/TaskProgramCache.h"
+
+using namespace TasksTypes;
+
+namespace App
+{
+    /**
+     * @brief Constructs an empty cache.
+     * @param capacityBytes Approximate upper bound of the memory held by cached programs. 0 disables caching.
+     */
+    TaskProgramCache::TaskProgramCache(size_t capacityBytes)
+    {
+        m_stats.capacityBytes = capacityBytes;
+    }
+    /**
+     * @brief Looks up the program of a file whose size and last write time did not change.
+     * @param entry The scanned task file.
+     * @param contentHash Receives, on a hit, the hash of the contents the program was parsed from.
+     * @return The cached program, or nullptr on a miss.
+     */
+    TaskProgramCache::ProgramPtr TaskProgramCache::Find(const TaskFileEntry& entry, uint64_t* contentHash)
+    {
+        auto itr = m_index.find(entry.path.string());
+        if (itr == m_index.end() || itr->second->size != entry.size || itr->second->lastWrite != entry.lastWrite)
+            return nullptr;
+
+        ++m_stats.hits;
+        Touch(itr->second);
+        if (contentHash)
+            *contentHash = itr->second->contentHash;
+        return itr->second->program;
+    }
+    /**
+     * @brief Checks, without touching the LRU order or the counters, whether Find would hit.
+     * @param entry The scanned task file.
+     */
+    bool TaskProgramCache::Contains(const TaskFileEntry& entry) const
+    {
+        auto itr = m_index.find(entry.path.string());
+        return itr != m_index.end() && itr->second->size == entry.size && itr->second->lastWrite == entry.lastWrite;
+    }
+    /**
+     * @brief Looks up the program of a file whose metadata changed but whose contents may not have.
+     * On a hit the stored size and last write time are refreshed.
+     * @param entry The scanned task file.
+     * @param contentHash Hash of the file contents.
+     * @return The cached program, or nullptr on a miss.
+     */
+    TaskProgramCache::ProgramPtr TaskProgramCache::FindByContent(const TaskFileEntry& entry, uint64_t contentHash)
+    {
+        auto itr = m_index.find(entry.path.string());
+        if (itr == m_index.end() || itr->second->contentHash != contentHash)
+        {
+            ++m_stats.misses;
+            return nullptr;
+        }
+
+        ++m_stats.hits;
+        itr->second->size = entry.size;
+        itr->second->lastWrite = entry.lastWrite;
+        Touch(itr->second);
+        return itr->second->program;
+    }
+    /**
+     * @brief Stores the parsed program of a task file, evicting the least recently used programs if needed.
+     * @param entry The scanned task file.
+     * @param contentHash Hash of the file contents.
+     * @param program The parsed program.
+     * @param sourceBytes Size of the loaded source, used to approximate the memory held by the program's argument pool.
+     * @return The program, shared with the cache when it fits in the budget.
+     */
+    TaskProgramCache::ProgramPtr TaskProgramCache::Insert(const TaskFileEntry& entry, uint64_t contentHash,
+                                                            CommandProgram program, size_t sourceBytes)
+    {
+        const size_t bytes = sizeof(Entry) + entry.path.native().size() + program.records.capacity() * sizeof(Commands::CommandRecord) + sourceBytes;
+        auto shared = std::make_shared<CommandProgram>(std::move(program));
+
+        if (auto itr = m_index.find(entry.path.string()); itr != m_index.end())
+            Erase(itr->second);
+
+        if (bytes > m_stats.capacityBytes)
+            return shared;
+
+        m_lru.push_front({entry.path.string(), entry.size, entry.lastWrite, contentHash, bytes, shared});
+        m_index[m_lru.front().path] = m_lru.begin();
+        m_stats.bytes += bytes;
+        m_stats.entries = m_lru.size();
+        EvictToCapacity();
+        return shared;
+    }
+    /**
+     * @brief Drops the programs of every file that is not in the given set (e.g. deleted files).
+     * @param paths The task file paths still present.
+     */
+    void TaskProgramCache::RetainOnly(const std::unordered_set<std::string>& paths)
+    {
+        for (auto itr = m_lru.begin(); itr != m_lru.end();)
+        {
+            auto next = std::next(itr);
+            if (!paths.count(itr->path))
+                Erase(itr);
+            itr = next;
+        }
+    }
+    /**
+     * @brief Changes the memory budget, evicting programs if the cache no longer fits.
+     * @param capacityBytes Approximate upper bound of the memory held by cached programs. 0 disables caching.
+     */
+    void TaskProgramCache::SetCapacity(size_t capacityBytes)
+    {
+        m_stats.capacityBytes = capacityBytes;
+        EvictToCapacity();
+    }
+    /**
+     * @brief Removes every cached program.
+     */
+    void TaskProgramCache::Clear()
+    {
+        m_lru.clear();
+        m_index.clear();
+        m_stats.bytes = 0;
+        m_stats.entries = 0;
+    }
+    /**
+     * @brief Gets the current size, budget and hit/miss counters of the cache.
+     */
+    ProgramCacheStats TaskProgramCache::GetStats() const
+    {
+        return m_stats;
+    }
+
+    void TaskProgramCache::Touch(EntryList::iterator itr)
+    {
+        m_lru.splice(m_lru.begin(), m_lru, itr);
+    }
+
+    void TaskProgramCache::Erase(EntryList::iterator itr)
+    {
+        m_stats.bytes -= itr->bytes;
+        m_index.erase(itr->path);
+        m_lru.erase(itr);
+        m_stats.entries = m_lru.size();
+    }
+
+    void TaskProgramCache::EvictToCapacity()
+    {
+        while (m_stats.bytes > m_stats.capacityBytes && !m_lru.empty())
+        {
+            Erase(std::prev(m_lru.end()));
+            ++m_stats.evictions;
+        }
+    }
+}
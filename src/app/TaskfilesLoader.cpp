@@ -1,14 +1,50 @@
 #include "app/TaskFileLoader.h"
+#include "app/CompiledTaskFormat.h"
+#include "errorhandling/exceptions/AllExceptions.h"
+#include "utils/Hash.h"
+#include "utils/AllocationTracker.h"
+#include "utils/Tracer.h"
 
 #include<fstream>
 #include<iostream>
 #include<filesystem>
+#include<iterator>
+#include<unordered_set>
+#include<algorithm>
 
 
 using namespace TasksTypes;
+using namespace ErrorHandling::Exceptions;
 namespace fs = std::filesystem;
 namespace App
 {
+    namespace
+    {
+        /**
+         * @brief Reads a whole file into a string of any allocator, sized once from the file size.
+         */
+        template <typename String>
+        bool ReadInto(const fs::path& path, String& content)
+        {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if(!file.is_open())
+                return false;
+
+            const auto size = file.tellg();
+            if(size < 0)
+            {
+                file.clear();
+                file.seekg(0);
+                content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+                return true;
+            }
+            content.resize(static_cast<size_t>(size));
+            file.seekg(0);
+            file.read(content.data(), size);
+            content.resize(static_cast<size_t>(file.gcount()));
+            return true;
+        }
+    }
     /**
      * @brief Constructs a TaskFileLoader with the specified directory path.
      *This constructor initializes the loader to point to the directory containing task files.
@@ -43,31 +79,244 @@ namespace App
             {
                 if(!entry.is_regular_file() || entry.path().extension() != ".txt") continue;
 
-                std::ifstream file(entry.path());
-                if(!file.is_open())
+                std::string content;
+                if(!ReadWholeFile(entry.path(), content))
                 {
                     std::cerr << "[WARNING] Could not open file: " << entry.path() << std::endl;
                     continue;
                 }
 
-                std::vector<std::string> lines;
-                std::string line;
-                while(std::getline(file, line))
+                tasks.emplace_back(entry.path().filename().string(), SplitTaskLines(content));
+            }
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << "[EXCEPTION] While loading tasks: " << e.what() << std::endl;
+        }
+
+        return tasks;
+    }
+    /**
+     * @brief Loads all task files, preferring compiled task files over their text sources.
+     *
+     * A `.txt` file with a `.umtb` sibling whose checksum matches the text is returned with its
+     * compiled commands, so it never goes through the text parser. Stale or corrupt compiled files
+     * are ignored and the text file is loaded instead. A `.umtb` file without a text source is
+     * loaded as is.
+     *
+     * @return ListOfTaskSources The task files of the directory.
+     *         If the directory doesn't exist or cannot be accessed, an empty list is returned.
+     */
+    ListOfTaskSources TaskFileLoader::LoadAllSources() const
+    {
+        ListOfTaskSources sources;
+        for(const auto& entry : ScanTaskFiles())
+        {
+            if(auto source = LoadSource(entry))
+                sources.push_back(std::move(*source));
+        }
+        return sources;
+    }
+    /**
+     * @brief Lists the task files of the directory without reading them.
+     *
+     * Returns every `.txt` file and every `.umtb` file that has no `.txt` source next to it,
+     * together with the size and last write time used to detect changes between runs.
+     * Files are sorted by name, so every run executes them in the same order.
+     *
+     * @return ListOfTaskFileEntries The task files found.
+     *         If the directory doesn't exist or cannot be accessed, an empty list is returned.
+     */
+    ListOfTaskFileEntries TaskFileLoader::ScanTaskFiles() const
+    {
+        Utils::ScopedAllocationPhase allocationPhase(Utils::AllocationPhase::Load);
+        Utils::TraceSpan span("scan", "load", m_directoryPath);
+        ListOfTaskFileEntries entries;
+        try
+        {
+            if(!fs::exists(m_directoryPath) || !fs::is_directory(m_directoryPath))
+            {
+                std::cerr << "[ERROR] Directory not found: " << m_directoryPath << std::endl;
+                return entries;
+            }
+
+            std::unordered_set<std::string> textStems;
+            for(const auto& entry : fs::directory_iterator(m_directoryPath))
+            {
+                if(!entry.is_regular_file()) continue;
+
+                const auto extension = entry.path().extension();
+                if(extension == ".txt")
+                    textStems.insert(entry.path().stem().string());
+                else if(extension != CompiledTaskFormat::EXTENSION)
+                    continue;
+
+                entries.push_back({entry.path(), entry.path().filename().string(), entry.file_size(), entry.last_write_time()});
+            }
+
+            entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const TaskFileEntry& entry)
+                        {
+                            return entry.path.extension() != ".txt" && textStems.count(entry.path.stem().string());
+                        }), entries.end());
+            std::sort(entries.begin(), entries.end(), [](const TaskFileEntry& lhs, const TaskFileEntry& rhs)
+                        {
+                            return lhs.fileName < rhs.fileName;
+                        });
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << "[EXCEPTION] While loading tasks: " << e.what() << std::endl;
+        }
+
+        return entries;
+    }
+    /**
+     * @brief Reads a single task file found by ScanTaskFiles.
+     *
+     * @param entry The task file to read.
+     * @return The loaded task file with the hash of its contents, or std::nullopt if it could not be read.
+     */
+    std::optional<TaskSource> TaskFileLoader::LoadSource(const TaskFileEntry& entry) const
+    {
+        Utils::ScopedAllocationPhase allocationPhase(Utils::AllocationPhase::Load);
+        Utils::TraceSpan span("load", "load", entry.fileName);
+        const bool isText = entry.path.extension() == ".txt";
+        TaskSource source;
+        source.fileName = entry.fileName;
+        source.arena = std::make_unique<TaskArena>(isText ? entry.size + entry.size / 2 : entry.size);
+        if(!ReadWholeFile(entry.path, source.arena->content))
+        {
+            std::cerr << "[WARNING] Could not open file: " << entry.path << std::endl;
+            return std::nullopt;
+        }
+
+        const std::string_view content = source.arena->content;
+        source.contentHash = Utils::Fnv1a64(content);
+        if(isText)
+        {
+            auto compiledPath = fs::path(entry.path).replace_extension(CompiledTaskFormat::EXTENSION);
+            std::error_code error;
+            const auto compiledSize = fs::file_size(compiledPath, error);
+            if(!error)
+            {
+                // The compiled commands are views into these bytes, so they replace the text arena.
+                auto compiledArena = std::make_unique<TaskArena>(compiledSize);
+                try
                 {
-                    if(!line.empty() && line.find_first_not_of(" \t\r\n") != std::string::npos)
+                    if(!ReadWholeFile(compiledPath, compiledArena->content))
+                        std::cerr << "[WARNING] Could not open file: " << compiledPath << std::endl;
+                    else if(CompiledTaskFormat::ReadSourceChecksum(compiledArena->content) != source.contentHash)
+                        std::cerr << "[WARNING] Stale compiled file ignored: " << compiledPath << std::endl;
+                    else
                     {
-                        lines.push_back(line);
+                        source.compiled = CompiledTaskFormat::Deserialize(compiledArena->content);
+                        source.arena = std::move(compiledArena);
                     }
                 }
+                catch(const BaseException& e)
+                {
+                    std::cerr << "[WARNING] " << compiledPath << ": " << e.what() << std::endl;
+                }
+            }
 
-                tasks.emplace_back(entry.path().filename().string(), std::move(lines));
+            if(!source.compiled)
+            {
+                source.arena->lines = SplitTaskLineViews(content, &source.arena->resource);
+                source.lines = source.arena->lines;
             }
         }
-        catch(const std::exception& e)
+        else
         {
-            std::cerr << "[EXCEPTION] While loading tasks: " << e.what() << std::endl;
+            try
+            {
+                source.compiled = CompiledTaskFormat::Deserialize(content);
+            }
+            catch(const BaseException& e)
+            {
+                std::cerr << "[WARNING] " << entry.path << ": " << e.what() << std::endl;
+                return std::nullopt;
+            }
         }
 
-        return tasks;
+        return source;
+    }
+    /**
+     * @brief Gets the directory the task files are loaded from.
+     */
+    const std::string& TaskFileLoader::GetDirectoryPath() const
+    {
+        return m_directoryPath;
+    }
+    /**
+     * @brief Builds the directory entry of a single task file.
+     * @param path The task file.
+     * @return The entry, or std::nullopt if the file does not exist or is not a regular file.
+     */
+    std::optional<TaskFileEntry> TaskFileLoader::DescribeFile(const fs::path& path)
+    {
+        std::error_code error;
+        if(!fs::is_regular_file(path, error))
+            return std::nullopt;
+
+        auto size = fs::file_size(path, error);
+        if(error)
+            return std::nullopt;
+
+        auto lastWrite = fs::last_write_time(path, error);
+        if(error)
+            return std::nullopt;
+
+        return TaskFileEntry{path, path.filename().string(), size, lastWrite};
+    }
+    /**
+     * @brief Splits the contents of a task file into its non blank lines.
+     * @param content The whole file contents.
+     * @return The lines that contain anything other than whitespace, without the line terminator.
+     */
+    std::vector<std::string> TaskFileLoader::SplitTaskLines(std::string_view content)
+    {
+        const auto views = SplitTaskLineViews(content);
+        return std::vector<std::string>(views.begin(), views.end());
+    }
+    /**
+     * @brief Splits the contents of a task file into views of its non blank lines, without copying them.
+     * @param content The whole file contents; the views point into it.
+     * @param resource Where the vector of views is allocated (e.g. the arena of the file).
+     * @return The lines that contain anything other than whitespace, without the line terminator.
+     */
+    TaskLines TaskFileLoader::SplitTaskLineViews(std::string_view content, std::pmr::memory_resource* resource)
+    {
+        TaskLines lines(resource);
+        lines.reserve(static_cast<size_t>(std::count(content.begin(), content.end(), '\n')) + 1);
+        size_t start = 0;
+        while(start < content.size())
+        {
+            size_t end = content.find('\n', start);
+            if(end == std::string_view::npos)
+                end = content.size();
+
+            auto line = content.substr(start, end - start);
+            if(!line.empty() && line.find_first_not_of(" \t\r\n") != std::string_view::npos)
+            {
+                lines.emplace_back(line);
+            }
+            start = end + 1;
+        }
+        return lines;
+    }
+    /**
+     * @brief Reads a whole file in binary mode.
+     * @param path The file to read.
+     * @param content Receives the file contents.
+     * @return false if the file could not be opened.
+     */
+    bool TaskFileLoader::ReadWholeFile(const fs::path& path, std::string& content)
+    {
+        return ReadInto(path, content);
+    }
+
+    bool TaskFileLoader::ReadWholeFile(const fs::path& path, std::pmr::string& content)
+    {
+        return ReadInto(path, content);
     }
-}
\ No newline at end of file
+}
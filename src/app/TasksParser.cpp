@@ -1,8 +1,11 @@
-#include "App/TasksParser.h"
+#include "app/TasksParser.h"
 #include "errorhandling/ErrorHandler.h"
+#include "utils/AllocationTracker.h"
+#include "utils/Tracer.h"
 #include <sstream>
 #include <stdexcept>
 #include <iostream>
+#include <chrono>
 
 
 using namespace ErrorHandling::Exceptions;
@@ -76,70 +79,64 @@ namespace App
     }
     /**
      *  @brief Parses a word (non-whitespace sequence excluding quotes).
-     *  @return A parser that returns the parsed word as a string.
+     *  Scans the input directly and copies nothing.
+     *  @return A parser that returns the parsed word as a view into the input.
     */
-    parsec::Parser<std::string> word_parser()
+    parsec::Parser<std::string_view> word_parser()
     {
-        auto word_char_p = char_p_if([](char c)
-                {
-                    return !std::isspace(static_cast<unsigned char>(c)) && c != '"';
-                }, "Word character");
+        return [](std::string_view input, size_t index) -> parsec::Result<std::string_view>
+        {
+            size_t end = index;
+            while(end < input.length() && !std::isspace(static_cast<unsigned char>(input[end])) && input[end] != '"') {end++;}
 
-            return parsec::fmap<std::string, std::list<char>>(
-                    [](std::list<char> chars)
-                    {
-                        return std::string(chars.begin(), chars.end());
-                    },
-                    many1(word_char_p)
-        );
+            if(end == index)
+                return parsec::makeError<std::string_view>("Expected a word character", index);
+
+            return parsec::makeSuccess(input.substr(index, end - index), end, "Word", std::nullopt);
+        };
     }
     /**
-    * @brief Parses a quoted string (delimited by double quotes).
-    * @return A parser that returns the parsed string inside the quotes.
+    * @brief Parses a quoted string (delimited by double quotes), scanning for the closing quote directly.
+    * @return A parser that returns the text inside the quotes as a view into the input.
     */
-    parsec::Parser<std::string> quoted_string_parser()
+    parsec::Parser<std::string_view> quoted_string_parser()
     {
-        auto inner_content_parser = char_p('"') >> many(char_p_if([](char c){ return c != '"'; }, "Char inside quotes")) << char_p('"');
-        return parsec::fmap<std::string, std::list<char>>(
-                    [](std::list<char> chars)
-                    {
-                        return std::string(chars.begin(), chars.end());
-                    },
-                    inner_content_parser );
+        return [](std::string_view input, size_t index) -> parsec::Result<std::string_view>
+        {
+            if(index >= input.length() || input[index] != '"')
+                return parsec::makeError<std::string_view>("Expected '\"'", index);
+
+            const size_t close = input.find('"', index + 1);
+            if(close == std::string_view::npos)
+                return parsec::makeError<std::string_view>("Expected '\"'", input.length());
+
+            return parsec::makeSuccess(input.substr(index + 1, close - index - 1), close + 1, "Quoted", std::nullopt);
+        };
     }
     /**
      * @brief Parses a word composed entirely of uppercase letters.
-     * @return A parser that returns the uppercase word, or fails otherwise.
+     * Argument words fail here on every line, so the error message fits the small-string buffer.
+     * @return A parser that returns the uppercase word as a view into the input, or fails otherwise.
      */
-    parsec::Parser<std::string> uppercase_word_parser()
+    parsec::Parser<std::string_view> uppercase_word_parser()
     {
-        return [=](std::string_view sv, size_t i) -> parsec::Result<std::string>
+        return [](std::string_view sv, size_t i) -> parsec::Result<std::string_view>
         {
+            size_t end = i;
+            while (end < sv.length() && std::isupper(static_cast<unsigned char>(sv[end]))) {end++;}
 
-            auto wordResult = word_parser()(sv, i);
-
-            if (wordResult.failure())
-                return parsec::makeError<std::string>("Failed to parse word", i);
+            const bool wordEnds = end == sv.length() || std::isspace(static_cast<unsigned char>(sv[end])) || sv[end] == '"';
+            if (end == i || !wordEnds)
+                return parsec::makeError<std::string_view>("Not uppercase", i);
 
-            std::string word = wordResult.value();
-
-            if (std::all_of(word.begin(), word.end(), [](unsigned char c)
-                {
-                    return std::isupper(c);
-                }))
-            {
-                return parsec::makeSuccess<std::string>(std::move(word), wordResult.index(), "Fully Uppercase",
-                                std::make_optional<std::vector<parsec::Trace>>({std::move(wordResult.trace())}));
-            }
-            else
-            {
-                return parsec::makeError<std::string>("Word is not fully uppercase", i);
-            }
+            return parsec::makeSuccess(sv.substr(i, end - i), end, "Fully Uppercase", std::nullopt);
         };
     }
     /**
     * @brief Parses a task command and its arguments from a line.
     * It extracts uppercase tokens as command name and others as arguments.
+    * This is the owning form of the grammar; TasksParser::TokenizeLine follows the same grammar
+    * without the combinators, so parsing a line builds no list and copies no token.
     * @return A parser that returns a TaskFile with the full command name and its arguments.
     */
     parsec::Parser<TasksTypes::TaskFile> ExtractCommandAndArgs()
@@ -151,7 +148,7 @@ namespace App
                     if(uppercase_res.success())
                     {
                         return parsec::makeSuccess<std::pair<std::optional<std::string>, std::optional<std::string>>>(
-                                { std::make_optional(std::move(uppercase_res.value())), std::nullopt },
+                                { std::make_optional(std::string(uppercase_res.value())), std::nullopt },
                                     uppercase_res.index() );
                     }
 
@@ -159,7 +156,7 @@ namespace App
                     if (quoted_res.success())
                     {
                         return parsec::makeSuccess<std::pair<std::optional<std::string>, std::optional<std::string>>>(
-                            { std::nullopt, std::make_optional(std::move(quoted_res.value())) },
+                            { std::nullopt, std::make_optional(std::string(quoted_res.value())) },
                             quoted_res.index() );
                     }
 
@@ -167,7 +164,7 @@ namespace App
                     if (word_res.success())
                     {
                         return parsec::makeSuccess<std::pair<std::optional<std::string>, std::optional<std::string>>>(
-                            { std::nullopt, std::make_optional(std::move(word_res.value())) },
+                            { std::nullopt, std::make_optional(std::string(word_res.value())) },
                             word_res.index() );
                     }
 
@@ -178,10 +175,10 @@ namespace App
 
         auto full_parser =  uppercase_word_parser() & parsec::many(spaces1() >> token_classifier_parser);
 
-        return parsec::fmap<TaskFile, std::tuple<std::string, std::list<std::pair<std::optional<std::string>, std::optional<std::string>>>>>(
+        return parsec::fmap<TaskFile, std::tuple<std::string_view, std::list<std::pair<std::optional<std::string>, std::optional<std::string>>>>>(
             [](const auto& parsed) -> TaskFile
             {
-                std::string command_name = std::get<0>(parsed);
+                std::string command_name(std::get<0>(parsed));
                 std::vector<std::string> arguments;
 
                 for (const auto& [cmd, arg] : std::get<1>(parsed))
@@ -216,63 +213,292 @@ namespace App
     ParsedTasks TasksParser::ParseTasks(const std::string& fileName, const std::vector<std::string>& rawTasks) const
     {
         ParsedTasks parsed;
-        CommandList commands;
-        bool taskHasError = false;
 
+        for (auto& [name, program] : ParseProgram(fileName, rawTasks))
+        {
+            CommandList commands;
+            commands.commands.reserve(program.records.size());
+            for (auto& record : program.records)
+                commands.commands.push_back(Commands::ToCommand(std::move(record)));
+            commands.arguments = std::move(program.arguments);
+
+            parsed.emplace_back(std::move(name), std::move(commands));
+        }
+
+        return parsed;
+    }
+    /**
+    * @brief Parses a set of raw task lines into a contiguous command program.
+    * @param fileName The name of the task file.
+    * @param rawTasks A list of raw strings representing task lines.
+    * @return A ParsedProgram holding the command records of the file. Skips file if any command fails.
+    */
+    ParsedProgram TasksParser::ParseProgram(const std::string& fileName, const std::vector<std::string>& rawTasks) const
+    {
+        const std::vector<std::string_view> lines(rawTasks.begin(), rawTasks.end());
+        return ParseProgram(fileName, lines);
+    }
+    /**
+    * @brief Parses task lines (e.g. the views of a loaded TaskSource) into a contiguous command program.
+    * @param fileName The name of the task file.
+    * @param rawTasks The raw task lines.
+    * @return A ParsedProgram holding the command records of the file. Skips file if any command fails.
+    */
+    ParsedProgram TasksParser::ParseProgram(const std::string& fileName, std::span<const std::string_view> rawTasks) const
+    {
+        ParsedProgram parsed;
+        try
+        {
+            parsed.emplace_back(fileName, CreateProgram(rawTasks));
+        }
+        catch (const BaseException& e)
+        {
+            ErrorHandler::Handle(e, "CreateCommandFromLine");
+        }
+        return parsed;
+    }
+    /**
+    * @brief Builds a command program from the already tokenized commands of a compiled task file.
+    * @param fileName The name of the task file.
+    * @param compiled The commands of the compiled file, in execution order.
+    * @return A ParsedProgram holding the command records of the file. Skips file if any command fails.
+    */
+    ParsedProgram TasksParser::BuildProgram(const std::string& fileName, const CompiledTasks& compiled) const
+    {
+        ParsedProgram parsed;
+        try
+        {
+            parsed.emplace_back(fileName, CreateProgram(compiled));
+        }
+        catch (const BaseException& e)
+        {
+            ErrorHandler::Handle(e, "CreateCommandFromLine");
+        }
+        return parsed;
+    }
+    /**
+    * @brief Parses raw task lines into a command program without reporting errors.
+    * Safe to call from several threads at once.
+    * @param rawTasks A list of raw strings representing task lines.
+    * @return The command records of the file.
+    * @throws BaseException (or a derived exception) for the first line that cannot be parsed or created.
+    */
+    CommandProgram TasksParser::CreateProgram(const std::vector<std::string>& rawTasks) const
+    {
+        const std::vector<std::string_view> lines(rawTasks.begin(), rawTasks.end());
+        return CreateProgram(lines);
+    }
+    /**
+    * @brief Parses task lines into a command program without reporting errors.
+    * Lines are only sliced while cleaning and tokenizing; each argument is copied once into the
+    * program's ArgumentPool, which is sized after the lines, and the commands keep views into it.
+    * The command name and argument buffers are reused across lines, so a line costs no allocation
+    * besides what its command needs to own (e.g. a message body).
+    * Safe to call from several threads at once.
+    * @param rawTasks The raw task lines.
+    * @return The command records of the file.
+    * @throws BaseException (or a derived exception) for the first line that cannot be parsed or created.
+    */
+    CommandProgram TasksParser::CreateProgram(std::span<const std::string_view> rawTasks) const
+    {
+        Utils::ScopedAllocationPhase allocationPhase(Utils::AllocationPhase::Parse);
+        size_t lineBytes = 0;
+        for (const auto& rawline : rawTasks)
+            lineBytes += rawline.size();
+
+        CommandProgram program;
+        program.records.reserve(rawTasks.size());
+        program.arguments = std::make_unique<ArgumentPool>(lineBytes);
+        std::string commandName;
+        std::vector<std::string_view> args;
+
+        Utils::TraceSpan span("parse", "parse");
+#ifdef USER_MGMT_ENABLE_METRICS
+        // Filled without locking, merged once per file and reset for the next file of the thread.
+        thread_local LatencyMetrics fileLatency;
+#endif
         for (const auto& rawline : rawTasks)
         {
-            std::string newLine = CleanLine(rawline);
+#ifdef USER_MGMT_ENABLE_METRICS
+            const auto start = std::chrono::steady_clock::now();
+#endif
+            const std::string_view newLine = CleanLine(rawline);
 
             if (newLine.empty())
+            {
+#ifdef USER_MGMT_ENABLE_METRICS
+                fileLatency.Record(COMMENT_LINE_TYPE, std::chrono::steady_clock::now() - start);
+#endif
                 continue;
+            }
 
-            try
+            TokenizeLine(newLine, commandName, args);
+            for (auto& arg : args)
+                arg = program.arguments->Store(arg);
             {
-                auto parser = ExtractCommandAndArgs();
-                auto result = parser(newLine, 0);
+                Utils::ScopedAllocationPhase createPhase(Utils::AllocationPhase::CreateCommand);
+                program.records.push_back(m_registry.createRecord(commandName, args));
+            }
+#ifdef USER_MGMT_ENABLE_METRICS
+            fileLatency.Record(program.records.back().index(), std::chrono::steady_clock::now() - start);
+#endif
+        }
 
-                if(result.failure())
-                    throw CommandExecutionException("ParseTasks", result.error());
+#ifdef USER_MGMT_ENABLE_METRICS
+        m_parseLatency.Merge(fileLatency);
+        fileLatency.Reset();
+#endif
+        return program;
+    }
+    /**
+    * @brief Creates the command program of a compiled task file without reporting errors.
+    * The interned strings of the file are copied into the program's ArgumentPool in one block, so
+    * the program does not depend on `compiled` and no argument is copied or allocated on its own.
+    * Each distinct command name is resolved in the registry once.
+    * Safe to call from several threads at once.
+    * @param compiled The commands of the compiled file, in execution order.
+    * @return The command records of the file.
+    * @throws BaseException (or a derived exception) for the first command that cannot be created.
+    */
+    CommandProgram TasksParser::CreateProgram(const CompiledTasks& compiled) const
+    {
+        Utils::ScopedAllocationPhase allocationPhase(Utils::AllocationPhase::Parse);
+        CommandProgram program;
+        program.records.reserve(compiled.commands.size());
+        program.arguments = std::make_unique<ArgumentPool>(compiled.blob.size());
+        const std::string_view blob = program.arguments->Store(compiled.blob);
+        auto rebase = [&](std::string_view text)
+        {
+            return blob.substr(static_cast<size_t>(text.data() - compiled.blob.data()), text.size());
+        };
+        std::vector<const RecordFactory*> factories(compiled.strings.size(), nullptr);
+        std::vector<std::string_view> args;
 
-                const auto& [commandName, args] = result.value();
+        Utils::TraceSpan span("parse compiled", "parse");
+        for (const auto& command : compiled.commands)
+        {
+            auto& factory = factories[command.nameId];
+            if (!factory)
+                factory = &m_registry.findRecordFactory(compiled.Name(command));
+
+            args.clear();
+            for (const auto& arg : compiled.Arguments(command))
+                args.push_back(rebase(arg));
+            Utils::ScopedAllocationPhase createPhase(Utils::AllocationPhase::CreateCommand);
+            program.records.push_back((*factory)(args));
+        }
 
-                auto command = m_registry.createCommand(commandName, args);
-                commands.push_back(std::move(command));
+        return program;
+    }
+    /**
+    * @brief Tokenizes raw task lines into command names and arguments without creating commands.
+    * @param rawTasks A list of raw strings representing task lines.
+    * @return The tokenized commands; comments and blank lines are dropped.
+    * @throws CommandExecutionException if a line cannot be parsed.
+    */
+    CompiledCommands TasksParser::TokenizeTasks(std::span<const std::string_view> rawTasks) const
+    {
+        CompiledCommands commands;
+        commands.reserve(rawTasks.size());
+        std::string commandName;
+        std::vector<std::string_view> args;
+
+        for (const auto& rawline : rawTasks)
+        {
+            const std::string_view newLine = CleanLine(rawline);
+
+            if (newLine.empty())
+                continue;
+
+            TokenizeLine(newLine, commandName, args);
+            commands.emplace_back(commandName, std::vector<std::string>(args.begin(), args.end()));
+        }
+
+        return commands;
+    }
+    /**
+    * @brief Splits a cleaned line into its command name and arguments, following the grammar of
+    * ExtractCommandAndArgs: an uppercase word, then whitespace separated tokens, uppercase ones
+    * joining the command name and the rest (quoted or plain words) becoming arguments. Tokenizing
+    * stops at the first token that matches none of them.
+    * The token parsers are built once and shared by every thread; they hold no mutable state.
+    * @param cleanLine A line already passed through CleanLine.
+    * @param commandName Receives the command name; its buffer is reused from line to line.
+    * @param args Receives the arguments as views into `cleanLine`; its buffer is reused from line to line.
+    * @throws CommandExecutionException if the line does not start with an uppercase word.
+    */
+    void TasksParser::TokenizeLine(std::string_view cleanLine, std::string& commandName, std::vector<std::string_view>& args) const
+    {
+        static const auto commandWord = uppercase_word_parser();
+        static const auto quoted = quoted_string_parser();
+        static const auto word = word_parser();
+
+        auto head = commandWord(cleanLine, 0);
+        if(head.failure())
+            throw CommandExecutionException("ParseTasks", head.error());
+
+        commandName.assign(head.value());
+        args.clear();
+        size_t index = head.index();
+        while (true)
+        {
+            size_t start = index;
+            while(start < cleanLine.length() && std::isspace(static_cast<unsigned char>(cleanLine[start]))) {start++;}
+            if (start == index)
+                break;
+
+            if (auto upper = commandWord(cleanLine, start); upper.success())
+            {
+                commandName += ' ';
+                commandName += upper.value();
+                index = upper.index();
+            }
+            else if (auto text = quoted(cleanLine, start); text.success())
+            {
+                args.push_back(text.value());
+                index = text.index();
             }
-            catch (const BaseException& e)
+            else if (auto plain = word(cleanLine, start); plain.success())
+            {
+                args.push_back(plain.value());
+                index = plain.index();
+            }
+            else
             {
-                ErrorHandler::Handle(e, "CreateCommandFromLine");
-                taskHasError = true;
                 break;
             }
         }
-
-        if (!taskHasError)
-            parsed.emplace_back(fileName, std::move(commands));
-
-        return parsed;
     }
     /**
     * @brief Cleans a line by trimming whitespace and removing comments.
     * @param line A single line from a task file.
-    * @return The cleaned line, or an empty string if it’s a comment or blank.
+    * @return The cleaned part of the line (a view into it), or an empty view if it’s a comment or blank.
     */
-    std::string TasksParser::CleanLine(const std::string& line) const
+    std::string_view TasksParser::CleanLine(std::string_view line)
     {
+        const size_t first = line.find_first_not_of(" \t");
+        if (first == std::string_view::npos || line[first] == '#')
+            return {};
 
-        std::string trimmed = line;
-        trimmed.erase(0, trimmed.find_first_not_of(" \t"));
-
-        if (trimmed.empty() || trimmed[0] == '#')
-            return "";
-
-        size_t commentPos = trimmed.find('#');
-        if (commentPos != std::string::npos)
-            trimmed = trimmed.substr(0, commentPos);
+        std::string_view trimmed = line.substr(first);
+        trimmed = trimmed.substr(0, trimmed.find('#'));
 
-
-        trimmed.erase(trimmed.find_last_not_of(" \t\r\n") + 1);
-        return trimmed;
+        const size_t last = trimmed.find_last_not_of(" \t\r\n");
+        return last == std::string_view::npos ? std::string_view() : trimmed.substr(0, last + 1);
+    }
+    /**
+    * @brief Gets the parse time per line type (command name, or comment/blank) recorded by CreateProgram.
+    * Empty when built without USER_MGMT_ENABLE_METRICS.
+    */
+    LatencyReport TasksParser::GetParseLatencyReport() const
+    {
+        return m_parseLatency.GetReport();
+    }
+    /**
+    * @brief Forgets the recorded parse times.
+    */
+    void TasksParser::ResetParseLatency()
+    {
+        m_parseLatency.Reset();
     }
 }
-
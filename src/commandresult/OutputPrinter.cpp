@@ -1,39 +1,89 @@
 #include "commandresult/OutputPrinter.h"
 #include "utils/Symbols.h"
+#include "utils/AllocationTracker.h"
+#include "utils/Tracer.h"
 #include <locale>
 
 using namespace  Symbols;
 
 namespace CommandResult
 {
+    namespace
+    {
+        std::ostream s_discard(nullptr);
+        std::ostream* s_stream = &std::cout;
+
+        // Ends a task block with a blank line and pushes the buffered output to the sink.
+        void EndTaskBlock()
+        {
+            Utils::TraceSpan span("flush", "output");
+            OutputPrinter::Stream() << std::endl;
+        }
+    }
+    /**
+     * @brief Redirects every printed line to the given stream.
+     * @param stream The output sink; nullptr discards the output.
+     */
+    void OutputPrinter::SetOutputStream(std::ostream* stream)
+    {
+        s_stream = stream ? stream : &s_discard;
+    }
+    /**
+     * @brief Gets the stream the printer currently writes to (std::cout by default).
+     */
+    std::ostream& OutputPrinter::Stream()
+    {
+        return *s_stream;
+    }
     void OutputPrinter::PrintCommandSuccess(const std::string& commandLine)
     {
-        std::cout << SYMBOL_SUCCESS << " " << commandLine << '\n';
+        Utils::ScopedAllocationPhase allocationPhase(Utils::AllocationPhase::Print);
+        Stream() << SYMBOL_SUCCESS << " " << commandLine << '\n';
     }
     void OutputPrinter::PrintCommandResult(const std::string& commandLine)
     {
-        std::cout << "    "<< commandLine << '\n';
+        Utils::ScopedAllocationPhase allocationPhase(Utils::AllocationPhase::Print);
+        Stream() << "    "<< commandLine << '\n';
     }
 
     void OutputPrinter::PrintCommandFailure(const std::string& commandLine, const std::string& failureReason)
     {
-        std::cout << SYMBOL_FAILURE << " " << commandLine << " (Failed: " << failureReason << ")\n";
+        Utils::ScopedAllocationPhase allocationPhase(Utils::AllocationPhase::Print);
+        Stream() << SYMBOL_FAILURE << " " << commandLine << " (Failed: " << failureReason << ")\n";
     }
 
     void OutputPrinter::PrintTaskStart(const std::string& taskName)
     {
-        std::cout << "[Processing task: " << SYMBOL_ARROW <<"  " << taskName << "]\n";
+        Utils::ScopedAllocationPhase allocationPhase(Utils::AllocationPhase::Print);
+        Stream() << "[Processing task: " << SYMBOL_ARROW <<"  " << taskName << "]\n";
     }
 
     void OutputPrinter::PrintTaskFailure(const std::string& taskName)
     {
-        std::cout << "[ " << SYMBOL_TASK_FAILED <<" Task " << taskName << " stopped due to failure]\n";
-        std::cout << std::endl;
+        Utils::ScopedAllocationPhase allocationPhase(Utils::AllocationPhase::Print);
+        Stream() << "[ " << SYMBOL_TASK_FAILED <<" Task " << taskName << " stopped due to failure]\n";
+        EndTaskBlock();
+    }
+
+    void OutputPrinter::PrintTaskRollback(const std::string& taskName, size_t changesUndone)
+    {
+        Utils::ScopedAllocationPhase allocationPhase(Utils::AllocationPhase::Print);
+        Stream() << "[Task " << taskName << " rolled back: " << changesUndone << " changes undone]\n";
     }
 
     void OutputPrinter::PrintTaskSuccess(const std::string& taskName)
     {
-        std::cout << "[Task " << taskName << " completed successfully" << SYMBOL_COMPLETED << "]\n";
-        std::cout << std::endl;
+        Utils::ScopedAllocationPhase allocationPhase(Utils::AllocationPhase::Print);
+        Stream() << "[Task " << taskName << " completed successfully" << SYMBOL_COMPLETED << "]\n";
+        EndTaskBlock();
+    }
+
+    void OutputPrinter::PrintWatchedTask(const std::string& taskName, std::chrono::nanoseconds detectedToApplied,
+                                            std::chrono::nanoseconds writtenToApplied)
+    {
+        Utils::ScopedAllocationPhase allocationPhase(Utils::AllocationPhase::Print);
+        using Milliseconds = std::chrono::duration<double, std::milli>;
+        Stream() << "[Watch: " << taskName << " applied " << Milliseconds(detectedToApplied).count()
+                  << " ms after detection, " << Milliseconds(writtenToApplied).count() << " ms after write]\n";
     }
-}
+}
\ No newline at end of file
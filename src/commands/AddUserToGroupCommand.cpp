@@ -4,13 +4,13 @@
 using CommandResult::OutputPrinter;
 namespace Commands
 {
-    AddUserToGroupCommand::AddUserToGroupCommand(std::string username_, std::string groupName_)
-            : m_username(std::move(username_)), m_groupname(std::move(groupName_)) {}
+    AddUserToGroupCommand::AddUserToGroupCommand(std::string_view username_, std::string_view groupName_)
+            : m_username(username_), m_groupname(groupName_) {}
 
     void AddUserToGroupCommand::execute(Domain::SystemState &state)
     {
-        state.AddUserToGroup(std::move(m_username), std::move(m_groupname));
-        OutputPrinter::PrintCommandSuccess("ADD USER " + m_username + " TO GROUP " + m_groupname);
+        state.AddUserToGroup(m_username, m_groupname);
+        OutputPrinter::PrintCommandSuccess("ADD USER " + std::string(m_username) + " TO GROUP " + std::string(m_groupname));
     }
 
 }
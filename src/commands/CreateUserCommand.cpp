@@ -5,14 +5,13 @@ using CommandResult::OutputPrinter;
 
 namespace Commands
 {
-    CreateUserCommand::CreateUserCommand(std::string username_)
-                : m_username(std::move(username_)) {}
+    CreateUserCommand::CreateUserCommand(std::string_view username_)
+                : m_username(username_) {}
 
     void CreateUserCommand::execute(Domain::SystemState& state)
     {
-        auto newUser = std::make_shared<Domain::User>(m_username);
-        state.AddUser(newUser);
-        OutputPrinter::PrintCommandSuccess("CREATE USER " + m_username);
+        state.AddUser(state.NewUser(m_username));
+        OutputPrinter::PrintCommandSuccess("CREATE USER " + std::string(m_username));
     }
 }
 
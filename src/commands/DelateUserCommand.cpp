@@ -5,13 +5,13 @@ using CommandResult::OutputPrinter;
 
 namespace Commands
 {
-    DeleteUserCommand::DeleteUserCommand(std::string username_)
-                : m_username(std::move(username_)) {}
+    DeleteUserCommand::DeleteUserCommand(std::string_view username_)
+                : m_username(username_) {}
 
     void DeleteUserCommand::execute(Domain::SystemState& state)
     {
         state.DeleteUser(m_username);
-        OutputPrinter::PrintCommandSuccess("DELETE USER " + m_username);
+        OutputPrinter::PrintCommandSuccess("DELETE USER " + std::string(m_username));
     }
 
 }
\ No newline at end of file
@@ -4,13 +4,13 @@
 using CommandResult::OutputPrinter;
 namespace Commands
 {
-    DisableUserCommand::DisableUserCommand(std::string username_)
-                : m_username(std::move(username_)) {}
+    DisableUserCommand::DisableUserCommand(std::string_view username_)
+                : m_username(username_) {}
 
     void DisableUserCommand::execute(Domain::SystemState& state)
     {
         state.DisableUser(m_username);
-        OutputPrinter::PrintCommandSuccess("DISABLE USER " + m_username);
+        OutputPrinter::PrintCommandSuccess("DISABLE USER " + std::string(m_username));
     }
 
 }
\ No newline at end of file
@@ -6,10 +6,10 @@ namespace Commands
 {
     void GetGroupsCommand::execute(Domain::SystemState& state)
     {
-        const auto& groups = state.getGroups();
+        const auto snapshot = state.Snapshot();
         OutputPrinter::PrintCommandSuccess("GET GROUPS" );
-        std::for_each(groups.begin(), groups.end(), [](const std::shared_ptr<Domain::Group>& group) {
-                    OutputPrinter::PrintCommandResult(group->getGroupName());
+        snapshot->ForEachGroup([](const Domain::StateSnapshot::GroupEntry& entry) {
+                    OutputPrinter::PrintCommandResult(std::string(entry.GetName()));
                 });
     }
-}
\ No newline at end of file
+}
@@ -4,15 +4,15 @@
 using CommandResult::OutputPrinter;
 namespace Commands
 {
-    GetMessageHistoryCommand::GetMessageHistoryCommand(std::string username_)
-                : m_username(std::move(username_)) {}
+    GetMessageHistoryCommand::GetMessageHistoryCommand(std::string_view username_)
+                : m_username(username_) {}
 
     void GetMessageHistoryCommand::execute(Domain::SystemState& state)
     {
-        const auto& messageHistory = state.getMessageHistory(m_username);
-        OutputPrinter::PrintCommandSuccess("GET MESSAGE HISTORY " + m_username);
-        std::for_each(messageHistory.begin(), messageHistory.end(), [](const std::unique_ptr<Domain::Message>& msg) {
-                    OutputPrinter::PrintCommandResult(msg->getContent());
+        const auto messageHistory = state.Snapshot()->getMessageHistory(m_username);
+        OutputPrinter::PrintCommandSuccess("GET MESSAGE HISTORY " + std::string(m_username));
+        std::for_each(messageHistory.begin(), messageHistory.end(), [](const Domain::Message& msg) {
+                    OutputPrinter::PrintCommandResult(msg.getContent());
                 });
     }
 }
\ No newline at end of file
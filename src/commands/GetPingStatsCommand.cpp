@@ -0,0 +1,16 @@
+#include "commands/GetPingStatsCommand.h"
+#include "commandresult/OutputPrinter.h"
+
+using CommandResult::OutputPrinter;
+namespace Commands
+{
+    void GetPingStatsCommand::execute(Domain::SystemState& state)
+    {
+        const auto stats = state.GetPingStats();
+        OutputPrinter::PrintCommandSuccess("GET PING STATS");
+        for (const auto& [username, received] : stats.receivedByUser)
+            OutputPrinter::PrintCommandResult(username + ": " + std::to_string(received));
+        OutputPrinter::PrintCommandResult("Total sent: " + std::to_string(stats.pingsSent)
+                                          + " (" + std::to_string(stats.pingsToUnknownUsers) + " to unknown users)");
+    }
+}
@@ -0,0 +1,23 @@
+#include "commands/GetStatsCommand.h"
+#include "commandresult/OutputPrinter.h"
+
+using CommandResult::OutputPrinter;
+namespace Commands
+{
+    void GetStatsCommand::execute(Domain::SystemState& state)
+    {
+        const auto stats = state.GetMemoryStats();
+        OutputPrinter::PrintCommandSuccess("GET STATS");
+        OutputPrinter::PrintCommandResult("users: " + std::to_string(stats.users) + ", groups: " + std::to_string(stats.groups)
+                                          + ", memberships: " + std::to_string(stats.memberships) + ", messages: " + std::to_string(stats.messages));
+        OutputPrinter::PrintCommandResult("names: " + std::to_string(stats.nameBytes) + " bytes");
+        OutputPrinter::PrintCommandResult("user objects: " + std::to_string(stats.userObjectBytes) + " bytes");
+        OutputPrinter::PrintCommandResult("group objects: " + std::to_string(stats.groupObjectBytes) + " bytes");
+        OutputPrinter::PrintCommandResult("membership lists: " + std::to_string(stats.membershipBytes) + " bytes");
+        OutputPrinter::PrintCommandResult("message bodies: " + std::to_string(stats.messageBodyBytes) + " bytes");
+        OutputPrinter::PrintCommandResult("message storage: " + std::to_string(stats.messageStorageBytes) + " bytes");
+        OutputPrinter::PrintCommandResult("hash tables: " + std::to_string(stats.hashTableBytes) + " bytes");
+        OutputPrinter::PrintCommandResult("indexes: " + std::to_string(stats.indexBytes) + " bytes");
+        OutputPrinter::PrintCommandResult("Total: " + std::to_string(stats.TotalBytes()) + " bytes");
+    }
+}
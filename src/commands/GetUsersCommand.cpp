@@ -1,17 +1,69 @@
 #include "commands/GetUsersCommand.h"
 #include "commandresult/OutputPrinter.h"
+#include "errorhandling/exceptions/AllExceptions.h"
+#include "utils/CommandStrings.h"
+#include <charconv>
 
 using CommandResult::OutputPrinter;
+using namespace ErrorHandling::Exceptions;
 namespace Commands
 {
+    /**
+     * @brief Constructs a GET USERS PREFIX / GET USERS AFTER command without a limit.
+     * @param query Prefix or After.
+     * @param key The prefix, or the name the listing starts after.
+     */
+    GetUsersCommand::GetUsersCommand(UserQuery query, std::string_view key)
+        : m_query(query), m_key(key) {}
+    /**
+     * @brief Constructs a GET USERS PREFIX / GET USERS AFTER command that lists at most `limit` users.
+     * @throws InvalidArgumentException if limit is not a positive decimal number.
+     */
+    GetUsersCommand::GetUsersCommand(UserQuery query, std::string_view key, std::string_view limit)
+        : GetUsersCommand(query, key)
+    {
+        const char* end = limit.data() + limit.size();
+        auto [parsedEnd, error] = std::from_chars(limit.data(), end, m_limit);
+        if (limit.empty() || error != std::errc() || parsedEnd != end || m_limit == 0)
+        {
+            throw InvalidArgumentException("GET USERS command ", " Invalid limit: " + std::string(limit));
+        }
+    }
+    /**
+     * @brief Lists the selected users in username order from the current snapshot,
+     * in O(log n + k) for k listed users.
+     */
     void GetUsersCommand::execute(Domain::SystemState& state)
     {
-        const auto& users = state.getUsers();
-        OutputPrinter::PrintCommandSuccess("GET USERS" );
-        std::for_each(users.begin(), users.end(), [](const std::shared_ptr<Domain::User>& user) {
-                    OutputPrinter::PrintCommandResult(user->getUsername());
-                });
+        const auto snapshot = state.Snapshot();
+        size_t remaining = m_limit;
+        switch (m_query)
+        {
+            case UserQuery::All:
+                OutputPrinter::PrintCommandSuccess(CMD::CMD_GET_USERS);
+                snapshot->GetUsernameIndex().ForEach([&](std::string_view name) {
+                            OutputPrinter::PrintCommandResult(std::string(name));
+                            return true;
+                        });
+                break;
+            case UserQuery::Prefix:
+                OutputPrinter::PrintCommandSuccess(std::string(CMD::CMD_GET_USERS_PREFIX) + " " + std::string(m_key));
+                snapshot->GetUsernameIndex().ForEachFrom(m_key, [&](std::string_view name) {
+                            if (!name.starts_with(m_key))
+                                return false;
+                            OutputPrinter::PrintCommandResult(std::string(name));
+                            return --remaining > 0;
+                        });
+                break;
+            case UserQuery::After:
+                OutputPrinter::PrintCommandSuccess(std::string(CMD::CMD_GET_USERS_AFTER) + " " + std::string(m_key));
+                snapshot->GetUsernameIndex().ForEachFrom(m_key, [&](std::string_view name) {
+                            if (name == m_key)
+                                return true;
+                            OutputPrinter::PrintCommandResult(std::string(name));
+                            return --remaining > 0;
+                        });
+                break;
+        }
     }
-
-
-}
\ No newline at end of file
+}
@@ -1,5 +1,5 @@
 #include "commands/PingCommand.h"
-#include <stdexcept>
+#include <charconv>
 #include "errorhandling/exceptions/AllExceptions.h"
 #include "commandresult/OutputPrinter.h"
 
@@ -7,31 +7,62 @@ using CommandResult::OutputPrinter;
 using namespace  ErrorHandling::Exceptions;
 namespace Commands
 {
-
-    PingCommand::PingCommand(std::string toUsername, std::string times_)
-        : m_toUsername(std::move(toUsername))
+    /**
+     * @brief Constructs a PING command.
+     * @param toUsername The user to ping.
+     * @param times_ The number of pings, a non-negative decimal number.
+     * @throws InvalidArgumentException if times_ is negative, not a number or out of range.
+     */
+    PingCommand::PingCommand(std::string_view toUsername, std::string_view times_)
+        : m_toUsername(toUsername)
     {
-        try
-        {
-            m_times = std::stoi(times_);
-        }
-        catch (const std::exception&)
+        const char* end = times_.data() + times_.size();
+        auto [parsedEnd, error] = std::from_chars(times_.data(), end, m_times);
+        if (times_.empty() || error != std::errc() || parsedEnd != end)
         {
-            throw InvalidArgumentException("PING command ", " Invalid argument: "  + times_);
+            throw InvalidArgumentException("PING command ", " Invalid argument: "  + std::string(times_));
         }
     }
-
+    /**
+     * @brief Records the pings in the system state in constant time and reports them.
+     */
     void PingCommand::execute(Domain::SystemState& state)
     {
-        bool isUser = state.isUserExists(m_toUsername);
-        OutputPrinter::PrintCommandSuccess("Send Ping to " + m_toUsername + " (" + std::to_string(m_times) + ")");
-        for(int i = 0; i < m_times; ++i)
+        const auto received = state.RecordPing(m_toUsername, m_times);
+        const std::string count = std::to_string(m_times);
+        const std::string toUsername(m_toUsername);
+        OutputPrinter::PrintCommandSuccess("Send Ping to " + toUsername + " (" + count + ")");
+
+        if (s_outputMode == PingOutputMode::Verbose)
         {
-            OutputPrinter::PrintCommandResult("Sent Ping to " + m_toUsername);
-            if(isUser)
-            OutputPrinter::PrintCommandResult(m_toUsername + " received a ping");
+            const std::string sentLine = "Sent Ping to " + toUsername;
+            const std::string receivedLine = toUsername + " received a ping";
+            for (uint64_t i = 0; i < m_times; ++i)
+            {
+                OutputPrinter::PrintCommandResult(sentLine);
+                if (received)
+                    OutputPrinter::PrintCommandResult(receivedLine);
+            }
+        }
+        else if (received)
+        {
+            OutputPrinter::PrintCommandResult(toUsername + " received " + count + " pings (" + std::to_string(*received) + " in total)");
+        }
+        else
+        {
+            OutputPrinter::PrintCommandResult("Sent " + count + " pings to " + toUsername + ", user does not exist");
         }
-
+    }
+    /**
+     * @brief Selects how every PING command reports its result (Summary by default).
+     */
+    void PingCommand::SetOutputMode(PingOutputMode mode)
+    {
+        s_outputMode = mode;
     }
 
+    PingOutputMode PingCommand::GetOutputMode()
+    {
+        return s_outputMode;
+    }
 }
@@ -4,12 +4,12 @@
 using CommandResult::OutputPrinter;
 namespace Commands
 {
-    RemoveUserFromGroupCommand::RemoveUserFromGroupCommand(std::string username_, std::string groupName_)
-            : m_username(std::move(username_)), m_groupname(std::move(groupName_)) {}
+    RemoveUserFromGroupCommand::RemoveUserFromGroupCommand(std::string_view username_, std::string_view groupName_)
+            : m_username(username_), m_groupname(groupName_) {}
 
     void RemoveUserFromGroupCommand::execute(Domain::SystemState &state)
     {
         state.RemoveUserFromGroup(m_username, m_groupname);
-        OutputPrinter::PrintCommandSuccess("ROMOVE USER " + m_username + " FROM GROUP " + m_groupname);
+        OutputPrinter::PrintCommandSuccess("ROMOVE USER " + std::string(m_username) + " FROM GROUP " + std::string(m_groupname));
     }
 }
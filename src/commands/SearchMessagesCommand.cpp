@@ -0,0 +1,25 @@
+#include "commands/SearchMessagesCommand.h"
+#include "commandresult/OutputPrinter.h"
+#include "utils/CommandStrings.h"
+
+using CommandResult::OutputPrinter;
+
+namespace Commands
+{
+    /**
+     * @brief Constructs a SEARCH MESSAGES command.
+     * @param query_ The terms every listed message must contain.
+     */
+    SearchMessagesCommand::SearchMessagesCommand(std::string_view query_)
+            : m_query(query_) {}
+    /**
+     * @brief Lists, as "user: message", every message of an existing user that contains all the terms.
+     */
+    void SearchMessagesCommand::execute(Domain::SystemState& state)
+    {
+        const auto matches = state.SearchMessages(m_query);
+        OutputPrinter::PrintCommandSuccess(std::string(CMD::CMD_SEARCH_MESSAGES) + " \"" + std::string(m_query) + "\" (" + std::to_string(matches.size()) + " found)");
+        for (const auto& match : matches)
+            OutputPrinter::PrintCommandResult(std::string(match.user->getUsername()) + ": " + match.user->getMessages()[match.messageIndex].getContent());
+    }
+}
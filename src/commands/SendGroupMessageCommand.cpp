@@ -0,0 +1,18 @@
+#include "commands/SendGroupMessageCommand.h"
+#include "commandresult/OutputPrinter.h"
+
+using CommandResult::OutputPrinter;
+
+namespace Commands
+{
+    SendGroupMessageCommand::SendGroupMessageCommand(std::string_view groupName_, std::string_view message_)
+            : m_groupName(groupName_), m_message(std::string(message_)) {}
+
+    void SendGroupMessageCommand::execute(Domain::SystemState &state)
+    {
+        const size_t delivered = state.SendMessageToGroup(m_groupName, m_message);
+
+        OutputPrinter::PrintCommandSuccess("SEND MESSAGE TO GROUP " + std::string(m_groupName) + " " + m_message.getContent());
+        OutputPrinter::PrintCommandResult("Delivered to " + std::to_string(delivered) + " members");
+    }
+}
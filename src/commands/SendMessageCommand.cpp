@@ -5,14 +5,17 @@ using CommandResult::OutputPrinter;
 
 namespace Commands
 {
-    SendMessageCommand::SendMessageCommand(std::string toUsername_, std::string message_)
-            : m_toUsername(std::move(toUsername_)), m_message(std::move(message_)) {}
+    /**
+     * @brief Constructs a SEND MESSAGE command. The body is allocated once here and shared by
+     * every execution of the command (e.g. repeated runs of a cached program).
+     */
+    SendMessageCommand::SendMessageCommand(std::string_view toUsername_, std::string_view message_)
+            : m_toUsername(toUsername_), m_message(std::string(message_)) {}
 
     void SendMessageCommand::execute(Domain::SystemState &state)
     {
-        auto message = std::make_unique<Domain::Message>(m_message);
-        state.SendMessage(m_toUsername, std::move(message));
+        state.SendMessage(m_toUsername, m_message);
 
-        OutputPrinter::PrintCommandSuccess("SEND MASSAGE " + m_toUsername + " " + m_message);
+        OutputPrinter::PrintCommandSuccess("SEND MASSAGE " + std::string(m_toUsername) + " " + m_message.getContent());
     }
 }
@@ -7,21 +7,23 @@ namespace Domain
     /**
      * @brief Constructs a Group with the given group name.
      * @param groupName_ The name of the group.
+     * @param resource The memory resource for the name and the member list; it must outlive the group.
      */
-    Group::Group(std::string groupName_):m_groupName(std::move(groupName_)){}
+    Group::Group(std::string_view groupName_, std::pmr::memory_resource* resource)
+        :m_groupName(groupName_, resource), m_groupMembers(resource){}
     /**
      * @brief Gets the name of the group.
-     * @return const std::string& The name of the group.
+     * @return std::string_view A view of the name, valid while the group lives.
      */
-    const std::string& Group::getGroupName() const
+    std::string_view Group::getGroupName() const
     {
         return m_groupName;
     }
     /**
      * @brief Gets the members of the group.
-     * @return const std::vector<std::shared_ptr<User>>& A vector containing shared pointers to the users in the group.
+     * @return const std::pmr::vector<std::shared_ptr<User>>& A vector containing shared pointers to the users in the group.
      */
-    const std::vector<std::shared_ptr<User>>& Group::getMembers() const
+    const std::pmr::vector<std::shared_ptr<User>>& Group::getMembers() const
     {
         return m_groupMembers;
     }
@@ -41,16 +43,35 @@ namespace Domain
     /**
      * @brief Removes a user from the group.
      * @param user A shared pointer to the user to be removed.
+     * @return The position the user had in the member list (to restore it with RestoreMember).
      */
-    void Group::RemoveMember(const std::shared_ptr<User>& user)
+    size_t Group::RemoveMember(const std::shared_ptr<User>& user)
     {
-        m_groupMembers.erase(std::remove_if(m_groupMembers.begin(), m_groupMembers.end(),
+        auto first = std::find_if(m_groupMembers.begin(), m_groupMembers.end(),
+                    [&](const std::shared_ptr<User>& u) {
+                        return u && u->getUsername() == user->getUsername();
+                    });
+        const auto position = static_cast<size_t>(first - m_groupMembers.begin());
+        m_groupMembers.erase(std::remove_if(first, m_groupMembers.end(),
                     [&](const std::shared_ptr<User>& u) {
                         return u && u->getUsername() == user->getUsername();
                     }), m_groupMembers.end());
 
         --m_memberCount;
         user->RemoveGroup(shared_from_this());
+        return position;
+    }
+    /**
+     * @brief Puts a removed user back at its previous position in the member list.
+     * @param user The user removed by RemoveMember.
+     * @param position The position returned by RemoveMember.
+     */
+    void Group::RestoreMember(const std::shared_ptr<User>& user, size_t position)
+    {
+        position = std::min(position, m_groupMembers.size());
+        m_groupMembers.insert(m_groupMembers.begin() + static_cast<std::ptrdiff_t>(position), user);
+        ++m_memberCount;
+        user->JoinGroup(shared_from_this());
     }
     /**
      * @brief Checks whether a user with the given username is a member of the group.
@@ -58,7 +79,7 @@ namespace Domain
      * @return true If the user is a member.
      * @return false If the user is not a member.
      */
-    bool Group::hasMember(const std::string& username) const
+    bool Group::hasMember(std::string_view username) const
     {
         return std::any_of(m_groupMembers.begin(), m_groupMembers.end(),
             [&](const std::shared_ptr<User>& user) {
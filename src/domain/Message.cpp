@@ -6,13 +6,25 @@ namespace Domain
      * @brief Constructs a Message with the given content.
      * @param content_ The text content of the message.
      */
-    Message::Message( std::string content_): m_content(std::move(content_)){}
+    Message::Message( std::string content_): m_body(std::make_shared<const std::string>(std::move(content_))){}
+    /**
+     * @brief Constructs a Message that shares an existing body.
+     * @param body_ The text content of the message, shared with other messages.
+     */
+    Message::Message(std::shared_ptr<const std::string> body_): m_body(std::move(body_)){}
     /**
      * @brief Retrieves the content of the message.
      * @return const std::string& A reference to the string containing the message content.
      */
     const std::string& Message::getContent() const
     {
-        return m_content;
+        return *m_body;
+    }
+    /**
+     * @brief Retrieves the shared body of the message.
+     */
+    const std::shared_ptr<const std::string>& Message::getBody() const
+    {
+        return m_body;
     }
-}
\ No newline at end of file
+}
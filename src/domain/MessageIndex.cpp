@@ -0,0 +1,211 @@
+#include "domain/MessageIndex.h"
+
+#include <algorithm>
+
+namespace Domain
+{
+    namespace
+    {
+        bool IsWordByte(unsigned char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+        }
+
+        // Keeps the ids of `ids` that are also in `other`; both ascending.
+        void Intersect(std::vector<uint32_t>& ids, const std::vector<uint32_t>& other)
+        {
+            auto out = ids.begin();
+            auto it = other.begin();
+            for (uint32_t id : ids)
+            {
+                it = std::lower_bound(it, other.end(), id);
+                if (it == other.end())
+                    break;
+                if (*it == id)
+                    *out++ = id;
+            }
+            ids.erase(out, ids.end());
+        }
+    }
+    /**
+     * @brief Splits a text into its distinct lowercase terms, sorted.
+     */
+    std::vector<std::string> MessageIndex::Tokenize(std::string_view text)
+    {
+        std::vector<std::string> terms;
+        for (size_t i = 0; i < text.size();)
+        {
+            if (!IsWordByte(static_cast<unsigned char>(text[i])))
+            {
+                ++i;
+                continue;
+            }
+            std::string term;
+            for (; i < text.size() && IsWordByte(static_cast<unsigned char>(text[i])); ++i)
+            {
+                const char c = text[i];
+                term.push_back(c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c);
+            }
+            terms.push_back(std::move(term));
+        }
+        std::sort(terms.begin(), terms.end());
+        terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+        return terms;
+    }
+    /**
+     * @brief Indexes a message that was just appended to a user's history.
+     * @param user The recipient.
+     * @param messageIndex The position of the message in the recipient's history.
+     * @param terms The terms of the message, from Tokenize (shared by every recipient of a group message).
+     */
+    void MessageIndex::Add(const std::shared_ptr<User>& user, size_t messageIndex, const std::vector<std::string>& terms)
+    {
+        const auto document = static_cast<uint32_t>(m_documents.size());
+        m_documents.push_back({UserId(user), static_cast<uint32_t>(messageIndex)});
+        for (const auto& term : terms)
+        {
+            auto it = m_postings.find(term);
+            if (it == m_postings.end())
+                it = m_postings.emplace(term, PostingList{}).first;
+            it->second.Append(document);
+        }
+    }
+    /**
+     * @brief Removes the latest indexed message (to undo a send).
+     * @param terms The terms the message was added with.
+     */
+    void MessageIndex::RemoveLast(const std::vector<std::string>& terms)
+    {
+        if (m_documents.empty())
+            return;
+
+        m_documents.pop_back();
+        for (const auto& term : terms)
+        {
+            auto it = m_postings.find(term);
+            if (it == m_postings.end())
+                continue;
+            it->second.PopBack();
+            if (it->second.count == 0)
+                m_postings.erase(it);
+        }
+    }
+    /**
+     * @brief Finds the messages that contain every term.
+     * Messages of users deleted since, or popped from their history, are left out by the caller.
+     * @return The matches in the order the messages were indexed; empty if there are no terms.
+     */
+    std::vector<MessageMatch> MessageIndex::Search(const std::vector<std::string>& terms) const
+    {
+        std::vector<const PostingList*> lists;
+        for (const auto& term : terms)
+        {
+            auto it = m_postings.find(term);
+            if (it == m_postings.end())
+                return {};
+            lists.push_back(&it->second);
+        }
+        if (lists.empty())
+            return {};
+
+        std::sort(lists.begin(), lists.end(), [](const PostingList* lhs, const PostingList* rhs) { return lhs->count < rhs->count; });
+        std::vector<uint32_t> documents = lists.front()->Decode();
+        for (size_t i = 1; i < lists.size() && !documents.empty(); ++i)
+            Intersect(documents, lists[i]->Decode());
+
+        std::vector<MessageMatch> matches;
+        matches.reserve(documents.size());
+        for (uint32_t document : documents)
+        {
+            if (auto user = m_users[m_documents[document].user].lock())
+                matches.push_back({std::move(user), m_documents[document].message});
+        }
+        return matches;
+    }
+    /**
+     * @brief Approximates the heap bytes held by the index.
+     */
+    size_t MessageIndex::MemoryUsage() const
+    {
+        size_t bytes = m_documents.capacity() * sizeof(Document)
+                     + m_users.capacity() * sizeof(std::weak_ptr<User>)
+                     + m_userIds.size() * (sizeof(std::pair<const User*, uint32_t>) + 2 * sizeof(void*))
+                     + m_postings.bucket_count() * sizeof(void*);
+        for (const auto& [term, postings] : m_postings)
+        {
+            bytes += sizeof(std::pair<const std::string, PostingList>) + sizeof(void*) + postings.bytes.capacity();
+            if (term.capacity() > 15)
+                bytes += term.capacity() + 1;
+        }
+        return bytes;
+    }
+    /**
+     * @brief Gets the id of a user, giving it one on its first indexed message.
+     * A user recreated at the address of a freed one gets a new id.
+     */
+    uint32_t MessageIndex::UserId(const std::shared_ptr<User>& user)
+    {
+        auto [it, inserted] = m_userIds.try_emplace(user.get(), static_cast<uint32_t>(m_users.size()));
+        if (!inserted && m_users[it->second].lock() != user)
+        {
+            it->second = static_cast<uint32_t>(m_users.size());
+            inserted = true;
+        }
+        if (inserted)
+            m_users.push_back(user);
+        return it->second;
+    }
+
+    void MessageIndex::PostingList::Append(uint32_t document)
+    {
+        uint32_t delta = count == 0 ? document : document - last;
+        while (delta >= 0x80)
+        {
+            bytes.push_back(static_cast<uint8_t>(delta | 0x80));
+            delta >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(delta));
+        last = document;
+        ++count;
+    }
+    /**
+     * @brief Removes the latest id. A varint ends with the only byte that has no continuation bit.
+     */
+    void MessageIndex::PostingList::PopBack()
+    {
+        if (count == 0)
+            return;
+
+        size_t start = bytes.size() - 1;
+        while (start > 0 && (bytes[start - 1] & 0x80))
+            --start;
+
+        uint32_t delta = 0;
+        for (size_t i = bytes.size(); i-- > start;)
+            delta = (delta << 7) | (bytes[i] & 0x7F);
+        bytes.resize(start);
+        last -= delta;
+        --count;
+    }
+
+    std::vector<uint32_t> MessageIndex::PostingList::Decode() const
+    {
+        std::vector<uint32_t> documents;
+        documents.reserve(count);
+        uint32_t document = 0;
+        uint32_t delta = 0;
+        int shift = 0;
+        for (uint8_t byte : bytes)
+        {
+            delta |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            shift += 7;
+            if (byte & 0x80)
+                continue;
+            document += delta;
+            documents.push_back(document);
+            delta = 0;
+            shift = 0;
+        }
+        return documents;
+    }
+}
@@ -0,0 +1,539 @@
+#include "domain/MessageLog.h"
+#include "domain/MemoryStats.h"
+#include "utils/BlockCompression.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Domain
+{
+    namespace
+    {
+        void WriteVarint(std::string& out, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                out.push_back(static_cast<char>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+        uint64_t ReadVarint(std::string_view in, size_t& position)
+        {
+            uint64_t value = 0;
+            for (int shift = 0; position < in.size(); shift += 7)
+            {
+                const auto byte = static_cast<uint8_t>(in[position++]);
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                    return value;
+            }
+            throw std::runtime_error("Truncated message block");
+        }
+        /**
+         * @brief Approximates the heap held by a message body: the make_shared block and its text.
+         */
+        size_t BodyFootprint(const std::shared_ptr<const std::string>& body)
+        {
+            return MemoryStats::CONTROL_BLOCK_BYTES + sizeof(std::string) + MemoryStats::HeapBytes(*body);
+        }
+    }
+
+    /**
+     * @brief A block of up to BLOCK_SIZE consecutive messages.
+     *
+     * A hot block holds a handle and an epoch per slot and may still be appended to. A sealed
+     * block is full and immutable: for every message it packs the epoch delta, the length and
+     * the text, and compresses the packed bytes.
+     */
+    class MessageLog::Block
+    {
+        public:
+            Block(size_t capacity_, std::pmr::memory_resource* resource)
+                : capacity(capacity_), epochs(capacity_, resource), bodies(capacity_, resource),
+                  payload(resource) {}
+            explicit Block(std::pmr::memory_resource* resource) : Block(0, resource) {}
+
+            /**
+             * @brief Gets the epoch of the first message, which both representations keep unpacked.
+             */
+            uint64_t FirstEpoch() const
+            {
+                return sealed ? firstEpoch : epochs[0].load(std::memory_order_relaxed);
+            }
+            /**
+             * @brief Gets the message in a slot.
+             * @param texts The unpacked texts of a sealed block (see Unpack); unused for a hot block.
+             */
+            Message At(size_t offset, const std::shared_ptr<const std::vector<std::string>>& texts) const
+            {
+                if (!sealed)
+                    return Message(bodies[offset]);
+                return Message(std::shared_ptr<const std::string>(texts, &(*texts)[offset]));
+            }
+            /**
+             * @brief Decompresses a sealed block.
+             */
+            void Unpack(std::vector<uint64_t>* epochsOut, std::vector<std::string>* textsOut, std::pmr::vector<uint32_t>* lengthsOut = nullptr) const
+            {
+                const std::string packed = Utils::DecompressBlock(payload, packedSize);
+                size_t position = 0;
+                uint64_t epoch = firstEpoch;
+                for (size_t offset = 0; offset < BLOCK_SIZE; ++offset)
+                {
+                    epoch += ReadVarint(packed, position);
+                    if (epochsOut)
+                        epochsOut->push_back(epoch);
+                    const size_t length = ReadVarint(packed, position);
+                    if (length > packed.size() - position)
+                        throw std::runtime_error("Corrupt message block");
+                    if (lengthsOut)
+                        lengthsOut->push_back(static_cast<uint32_t>(length));
+                    if (textsOut)
+                        textsOut->emplace_back(packed, position, length);
+                    position += length;
+                }
+            }
+
+            /**
+             * @brief Approximates the heap held by the block itself, without the bodies it points to.
+             */
+            size_t Footprint() const
+            {
+                const size_t bytes = sizeof(Block) + MemoryStats::CONTROL_BLOCK_BYTES;
+                if (sealed)
+                    return bytes + payload.capacity();
+                return bytes + capacity * (sizeof(std::atomic<uint64_t>) + sizeof(std::shared_ptr<const std::string>));
+            }
+
+            std::shared_ptr<const std::vector<std::string>> UnpackTexts() const
+            {
+                auto texts = std::make_shared<std::vector<std::string>>();
+                texts->reserve(BLOCK_SIZE);
+                Unpack(nullptr, texts.get());
+                return texts;
+            }
+
+            size_t capacity = 0;
+            std::pmr::vector<std::atomic<uint64_t>> epochs;
+            std::pmr::vector<std::shared_ptr<const std::string>> bodies;
+
+            bool sealed = false;
+            uint64_t firstEpoch = 0;
+            size_t packedSize = 0;
+            std::pmr::vector<uint8_t> payload;
+    };
+
+    /**
+     * @brief The texts of the sealed block a log decompressed last, reused by operator[].
+     */
+    struct MessageLog::DecodedBlock
+    {
+        std::shared_ptr<const Block> block;
+        std::shared_ptr<const std::vector<std::string>> texts;
+    };
+
+    /**
+     * @brief Constructs an empty log.
+     * @param resource The memory resource for blocks and directories; it must outlive the log and
+     * every snapshot that reads it.
+     */
+    MessageLog::MessageLog(std::pmr::memory_resource* resource)
+        : m_resource(resource), m_pendingReleases(resource), m_lengths(resource) {}
+
+    /**
+     * @brief Enables or disables sealing (and compressing) old blocks in every log. Disabled by
+     * default: sealing trades read and append time for memory. Blocks sealed before disabling
+     * stay sealed.
+     */
+    void MessageLog::SetCompressionEnabled(bool enabled)
+    {
+        s_compressionEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool MessageLog::IsCompressionEnabled()
+    {
+        return s_compressionEnabled.load(std::memory_order_relaxed);
+    }
+    /**
+     * @brief Gets a block holding messages in [FirstIndex(), size()). Any thread may call it.
+     */
+    std::shared_ptr<const MessageLog::Block> MessageLog::LoadBlock(size_t block) const
+    {
+        const auto directory = m_directory.load(std::memory_order_acquire);
+        return directory->slots[block - directory->base].load(std::memory_order_acquire);
+    }
+    /**
+     * @brief Gets the slot of a block for the owner, replacing a full directory by one twice the
+     * size of the blocks still held, starting at the first of them.
+     */
+    MessageLog::Slot& MessageLog::WritableSlot(size_t block)
+    {
+        auto directory = m_directory.load(std::memory_order_relaxed);
+        if (!directory || block >= directory->base + directory->capacity)
+        {
+            const size_t base = m_releasedBlocks;
+            auto next = std::allocate_shared<Directory>(std::pmr::polymorphic_allocator<Directory>(m_resource),
+                                                        base, std::max<size_t>(1, 2 * (block + 1 - base)), m_resource);
+            if (directory)
+            {
+                for (size_t i = next->base; i < directory->base + directory->capacity; ++i)
+                    next->slots[i - next->base].store(directory->slots[i - directory->base].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+            if (directory)
+                m_storageBytes -= sizeof(Directory) + MemoryStats::CONTROL_BLOCK_BYTES + directory->capacity * sizeof(Slot);
+            m_storageBytes += sizeof(Directory) + MemoryStats::CONTROL_BLOCK_BYTES + next->capacity * sizeof(Slot);
+            m_directory.store(next, std::memory_order_release);
+            directory = std::move(next);
+        }
+        return directory->slots[block - directory->base];
+    }
+    /**
+     * @brief Publishes a block (or frees a slot, when null) and updates StorageBytes().
+     */
+    void MessageLog::StoreBlock(Slot& slot, std::shared_ptr<const Block> block)
+    {
+        if (const auto previous = slot.load(std::memory_order_relaxed))
+        {
+            m_storageBytes -= previous->Footprint();
+            if (previous->sealed)
+            {
+                const auto decoded = m_decoded.load(std::memory_order_relaxed);
+                if (decoded && decoded->block == previous)
+                    m_decoded.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+        if (block)
+            m_storageBytes += block->Footprint();
+        slot.store(std::move(block), std::memory_order_release);
+    }
+    /**
+     * @brief Gets a hot block the owner can write slot `offset` of, replacing the block in its
+     * slot by a larger or unsealed copy when needed. The first block grows from
+     * FIRST_HOT_CAPACITY slots so short histories stay small; later blocks start full size.
+     * @param block The block index.
+     * @param offset The slot about to be written; the slots below it are kept.
+     */
+    MessageLog::Block& MessageLog::WritableBlock(size_t block, size_t offset)
+    {
+        Slot& slot = WritableSlot(block);
+        std::shared_ptr<const Block> current = slot.load(std::memory_order_relaxed);
+        if (current && !current->sealed && offset < current->capacity)
+            return const_cast<Block&>(*current);
+
+        size_t capacity = block == 0 && !current ? FIRST_HOT_CAPACITY : BLOCK_SIZE;
+        if (current && !current->sealed)
+            capacity = std::min(current->capacity * 2, BLOCK_SIZE);
+        auto next = std::allocate_shared<Block>(std::pmr::polymorphic_allocator<Block>(m_resource), capacity, m_resource);
+        if (current && current->sealed)
+        {
+            std::vector<uint64_t> epochs;
+            std::vector<std::string> texts;
+            current->Unpack(&epochs, &texts);
+            for (size_t i = 0; i < BLOCK_SIZE; ++i)
+            {
+                next->epochs[i].store(epochs[i], std::memory_order_relaxed);
+                next->bodies[i] = std::make_shared<const std::string>(std::move(texts[i]));
+                m_bodyBytes += BodyFootprint(next->bodies[i]);
+            }
+            --m_sealedBlocks;
+        }
+        else if (current)
+        {
+            for (size_t i = 0; i < offset; ++i)
+            {
+                next->epochs[i].store(current->epochs[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                next->bodies[i] = current->bodies[i];
+            }
+        }
+
+        Block& writable = *next;
+        StoreBlock(slot, std::move(next));
+        return writable;
+    }
+    /**
+     * @brief Replaces a full hot block by its sealed, compressed form. Every text is packed and its
+     * handle dropped, so a body still shared by other logs (group messages) is copied into the
+     * block; it is freed once the last handle to it goes.
+     */
+    void MessageLog::Seal(size_t block)
+    {
+        Slot& slot = WritableSlot(block);
+        const std::shared_ptr<const Block> hot = slot.load(std::memory_order_relaxed);
+        if (!hot || hot->sealed)
+            return;
+
+        auto sealed = std::allocate_shared<Block>(std::pmr::polymorphic_allocator<Block>(m_resource), m_resource);
+        sealed->sealed = true;
+        sealed->firstEpoch = hot->FirstEpoch();
+
+        std::string packed;
+        uint64_t previousEpoch = sealed->firstEpoch;
+        for (size_t offset = 0; offset < BLOCK_SIZE; ++offset)
+        {
+            const uint64_t epoch = hot->epochs[offset].load(std::memory_order_relaxed);
+            WriteVarint(packed, epoch - previousEpoch);
+            previousEpoch = epoch;
+
+            const auto& body = hot->bodies[offset];
+            m_bodyBytes -= BodyFootprint(body);
+            WriteVarint(packed, body->size());
+            packed += *body;
+        }
+        sealed->packedSize = packed.size();
+        const std::vector<uint8_t> payload = Utils::CompressBlock(packed);
+        sealed->payload.assign(payload.begin(), payload.end());
+
+        StoreBlock(slot, std::move(sealed));
+        ++m_sealedBlocks;
+        if (m_lengthsBlock == block)
+            m_lengthsBlock = SIZE_MAX;
+    }
+    /**
+     * @brief Appends a message. Only the thread that owns the state may call it.
+     * Starting a new block seals the block HOT_BLOCKS behind it when compression is enabled.
+     * @param message The message to append.
+     * @param epoch The state epoch the message becomes visible in.
+     */
+    void MessageLog::Append(Message message, uint64_t epoch)
+    {
+        const size_t index = m_size.load(std::memory_order_relaxed);
+        const size_t block = index / BLOCK_SIZE;
+        const size_t offset = index % BLOCK_SIZE;
+
+        Block& writable = WritableBlock(block, offset);
+        m_bytes += message.getContent().size();
+        m_bodyBytes += BodyFootprint(message.getBody());
+        writable.bodies[offset] = message.getBody();
+        writable.epochs[offset].store(epoch, std::memory_order_relaxed);
+        m_size.store(index + 1, std::memory_order_release);
+
+        if (offset == 0 && block >= m_releasedBlocks + HOT_BLOCKS && IsCompressionEnabled())
+            Seal(block - HOT_BLOCKS);
+    }
+    /**
+     * @brief Removes the latest message and releases its body. Only the thread that owns the state
+     * may call it, and only for a message that no published snapshot can see.
+     */
+    void MessageLog::PopBack()
+    {
+        const size_t index = m_size.load(std::memory_order_relaxed);
+        if (index == 0)
+            return;
+
+        const size_t block = (index - 1) / BLOCK_SIZE;
+        const size_t offset = (index - 1) % BLOCK_SIZE;
+        Block& writable = WritableBlock(block, offset);
+        m_size.store(index - 1, std::memory_order_release);
+        if (m_first.load(std::memory_order_relaxed) < index)
+            m_bytes -= writable.bodies[offset]->size();
+        else
+            m_first.store(index - 1, std::memory_order_release);
+        m_bodyBytes -= BodyFootprint(writable.bodies[offset]);
+        writable.bodies[offset].reset();
+    }
+    /**
+     * @brief Gets a message in [FirstIndex(), size()). Reading a sealed block decompresses all of it;
+     * the texts of the last block decompressed are kept, so reading positions in order (e.g. search
+     * matches) decompresses each block once. Any thread may call it.
+     */
+    Message MessageLog::operator[](size_t index) const
+    {
+        const auto block = LoadBlock(index / BLOCK_SIZE);
+        if (!block->sealed)
+            return block->At(index % BLOCK_SIZE, nullptr);
+
+        auto decoded = m_decoded.load(std::memory_order_acquire);
+        if (!decoded || decoded->block != block)
+        {
+            decoded = std::make_shared<const DecodedBlock>(DecodedBlock{block, block->UnpackTexts()});
+            m_decoded.store(decoded, std::memory_order_release);
+        }
+        return block->At(index % BLOCK_SIZE, decoded->texts);
+    }
+    /**
+     * @brief Gets the end position of the entries written in or before an epoch.
+     * Epochs never decrease along the log, so those entries are a prefix: the block is found by
+     * its first epoch and only that block is searched (unpacked, if sealed). Only blocks from
+     * FirstIndex() on are searched, so the result may be below FirstIndex() when every retained
+     * entry is newer than the epoch.
+     */
+    size_t MessageLog::CountUpTo(uint64_t epoch) const
+    {
+        return CountUpTo(epoch, FirstIndex());
+    }
+    /**
+     * @brief Same as CountUpTo(epoch), searching from the first position a snapshot retained
+     * rather than the current FirstIndex(). Its blocks must not have been released.
+     */
+    size_t MessageLog::CountUpTo(uint64_t epoch, size_t first) const
+    {
+        const size_t firstBlock = first / BLOCK_SIZE;
+        const size_t count = size();
+        size_t low = firstBlock;
+        size_t high = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        while (low < high)
+        {
+            const size_t middle = low + (high - low) / 2;
+            if (LoadBlock(middle)->FirstEpoch() <= epoch)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+        if (low == firstBlock)
+            return firstBlock * BLOCK_SIZE;
+
+        const size_t block = low - 1;
+        const auto found = LoadBlock(block);
+        const size_t entries = std::min(BLOCK_SIZE, count - block * BLOCK_SIZE);
+        size_t visible = 0;
+        if (found->sealed)
+        {
+            std::vector<uint64_t> epochs;
+            found->Unpack(&epochs, nullptr);
+            visible = static_cast<size_t>(std::upper_bound(epochs.begin(), epochs.begin() + entries, epoch) - epochs.begin());
+        }
+        else
+        {
+            size_t first = 1;
+            size_t last = entries;
+            while (first < last)
+            {
+                const size_t middle = first + (last - first) / 2;
+                if (found->epochs[middle].load(std::memory_order_relaxed) <= epoch)
+                    first = middle + 1;
+                else
+                    last = middle;
+            }
+            visible = first;
+        }
+        return block * BLOCK_SIZE + visible;
+    }
+    /**
+     * @brief Gets how many blocks are currently sealed. Only the owner thread may call it.
+     */
+    size_t MessageLog::SealedBlockCount() const
+    {
+        return m_sealedBlocks;
+    }
+    /**
+     * @brief Gets the total text size of the retained messages. Only the owner thread may call it.
+     */
+    uint64_t MessageLog::RetainedBytes() const
+    {
+        return m_bytes;
+    }
+    /**
+     * @brief Gets the text size of a message for the owner. The lengths of the last sealed block
+     * asked about are cached, so trimming walks each sealed block's texts once.
+     */
+    size_t MessageLog::LengthAt(size_t index)
+    {
+        const size_t block = index / BLOCK_SIZE;
+        const auto found = LoadBlock(block);
+        if (!found->sealed)
+            return found->bodies[index % BLOCK_SIZE]->size();
+        if (m_lengthsBlock != block)
+        {
+            m_lengths.clear();
+            found->Unpack(nullptr, nullptr, &m_lengths);
+            m_lengthsBlock = block;
+        }
+        return m_lengths[index % BLOCK_SIZE];
+    }
+    /**
+     * @brief Drops the oldest messages until the retained ones fit a policy. Only the owner thread
+     * may call it. The storage is freed later by ReleaseTrimmed.
+     * @param policy The bounds to enforce.
+     * @param epoch The state epoch the trim becomes visible in.
+     * @return The number of messages dropped.
+     */
+    size_t MessageLog::Trim(const RetentionPolicy& policy, uint64_t epoch)
+    {
+        const size_t end = m_size.load(std::memory_order_relaxed);
+        const size_t previous = m_first.load(std::memory_order_relaxed);
+        size_t first = previous;
+        while (first < end && ((policy.maxMessages && end - first > policy.maxMessages) || (policy.maxBytes && m_bytes > policy.maxBytes)))
+            m_bytes -= LengthAt(first++);
+        if (first == previous)
+            return 0;
+
+        m_first.store(first, std::memory_order_release);
+        if (first / BLOCK_SIZE > previous / BLOCK_SIZE)
+        {
+            if (!m_pendingReleases.empty() && m_pendingReleases.back().first == epoch)
+                m_pendingReleases.back().second = first;
+            else
+                m_pendingReleases.emplace_back(epoch, first);
+        }
+        return first - previous;
+    }
+    /**
+     * @brief Makes trimmed messages visible again (used to undo a Trim). Only valid while their
+     * blocks have not been released.
+     * @param first The FirstIndex() to go back to.
+     */
+    void MessageLog::RestoreFirst(size_t first)
+    {
+        const size_t current = m_first.load(std::memory_order_relaxed);
+        for (size_t i = first; i < current; ++i)
+            m_bytes += LengthAt(i);
+        m_first.store(first, std::memory_order_release);
+    }
+    /**
+     * @brief Frees the blocks that only hold trimmed messages, for the trims that every version a
+     * reader can still hold already reflects. Only the owner thread may call it, outside a transaction.
+     * @param oldestVisibleEpoch The epoch of the oldest version that may still be read.
+     * @return The number of blocks freed.
+     */
+    size_t MessageLog::ReleaseTrimmed(uint64_t oldestVisibleEpoch)
+    {
+        size_t target = 0;
+        size_t consumed = 0;
+        for (; consumed < m_pendingReleases.size() && m_pendingReleases[consumed].first <= oldestVisibleEpoch; ++consumed)
+            target = std::max(target, m_pendingReleases[consumed].second);
+        if (consumed == 0)
+            return 0;
+        m_pendingReleases.erase(m_pendingReleases.begin(), m_pendingReleases.begin() + static_cast<std::ptrdiff_t>(consumed));
+
+        const size_t releasable = std::min(target, m_first.load(std::memory_order_relaxed)) / BLOCK_SIZE;
+        if (releasable <= m_releasedBlocks)
+            return 0;
+
+        const auto directory = m_directory.load(std::memory_order_relaxed);
+        for (size_t block = m_releasedBlocks; block < releasable; ++block)
+        {
+            Slot& slot = directory->slots[block - directory->base];
+            const auto freed = slot.load(std::memory_order_relaxed);
+            if (freed->sealed)
+                --m_sealedBlocks;
+            else
+            {
+                for (size_t i = 0; i < freed->capacity; ++i)
+                {
+                    if (freed->bodies[i])
+                        m_bodyBytes -= BodyFootprint(freed->bodies[i]);
+                }
+            }
+            StoreBlock(slot, nullptr);
+        }
+        const size_t released = releasable - m_releasedBlocks;
+        m_releasedBlocks = releasable;
+        if (m_lengthsBlock < releasable)
+            m_lengthsBlock = SIZE_MAX;
+        return released;
+    }
+
+    Message MessageLog::const_iterator::operator*() const
+    {
+        const size_t block = m_index / BLOCK_SIZE;
+        if (block != m_blockIndex)
+        {
+            m_block = m_log->LoadBlock(block);
+            m_texts = m_block->sealed ? m_block->UnpackTexts() : nullptr;
+            m_blockIndex = block;
+        }
+        return m_block->At(m_index % BLOCK_SIZE, m_texts);
+    }
+}
@@ -0,0 +1,62 @@
+#include "domain/StateSnapshot.h"
+#include "errorhandling/exceptions/AllExceptions.h"
+
+#include <algorithm>
+#include <functional>
+
+using namespace ErrorHandling::Exceptions;
+
+namespace Domain
+{
+    namespace
+    {
+        template <typename Shard, typename NameOf>
+        auto FindInShard(const Shard& shard, std::string_view name, NameOf nameOf) -> decltype(&shard.front())
+        {
+            auto it = std::lower_bound(shard.begin(), shard.end(), name,
+                        [&](const auto& entry, std::string_view key) { return nameOf(entry) < key; });
+            return it != shard.end() && nameOf(*it) == name ? &*it : nullptr;
+        }
+    }
+    /**
+     * @brief Gets the shard a user or group name belongs to.
+     */
+    size_t StateSnapshot::ShardOf(std::string_view name)
+    {
+        return std::hash<std::string_view>{}(name) % SHARD_COUNT;
+    }
+    /**
+     * @brief Finds a user of this version.
+     * @return The user entry, or nullptr if the user did not exist at this version.
+     */
+    const StateSnapshot::UserEntry* StateSnapshot::FindUser(std::string_view username) const
+    {
+        return FindInShard(*m_userShards[ShardOf(username)], username,
+                    [](const UserEntry& entry) { return entry.GetName(); });
+    }
+    /**
+     * @brief Finds a group of this version.
+     * @return The group entry, or nullptr if the group did not exist at this version.
+     */
+    const StateSnapshot::GroupEntry* StateSnapshot::FindGroup(std::string_view groupName) const
+    {
+        return FindInShard(*m_groupShards[ShardOf(groupName)], groupName,
+                    [](const GroupEntry& entry) { return entry.GetName(); });
+    }
+    /**
+     * @brief Retrieves the messages a user had received at this version, from the first one it
+     * still retained then: later trims, even uncommitted ones, do not show.
+     * @param username The user whose message history to retrieve.
+     * @throws UserNotFoundException if the user did not exist at this version.
+     */
+    MessageHistoryView StateSnapshot::getMessageHistory(std::string_view username) const
+    {
+        const UserEntry* entry = FindUser(username);
+        if (!entry)
+        {
+            throw UserNotFoundException("GET MESSAGE HISTORY " + std::string(username), " User does not exist");
+        }
+        const auto& messages = entry->m_user->getMessages();
+        return MessageHistoryView(shared_from_this(), entry->m_user, entry->firstMessage, messages.CountUpTo(m_epoch, entry->firstMessage));
+    }
+}
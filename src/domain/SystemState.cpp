@@ -1,20 +1,116 @@
 #include "domain/SystemState.h"
 #include "errorhandling/exceptions/AllExceptions.h"
 
+#include <algorithm>
 #include <iterator>
 #include <vector>
 #include <memory>
+#include <stdexcept>
+#include <tuple>
 
 using namespace ErrorHandling::Exceptions;
 
 namespace Domain
 {
+    namespace
+    {
+        // Changes kept before a version is published even if nobody asked for one. Scales with the
+        // state so that rebuilding the changed shards stays a few entry copies per write.
+        constexpr size_t MIN_PENDING_CHANGES = 4096;
+
+        /**
+         * @brief Copies every shard that has a changed name and updates those names from the live map.
+         * @param shards The shards of the new version, still shared with the previous one.
+         * @param changed The changed names, in any order and possibly repeated.
+         * @param makeEntry Gets the entry of a name from the live state, or std::nullopt if it was removed.
+         * @param nameOf Gets the name of an entry.
+         */
+        template <typename Shards, typename MakeEntry, typename NameOf>
+        void ApplyChanges(Shards& shards, std::pmr::vector<std::pmr::string>& changed, MakeEntry makeEntry, NameOf nameOf)
+        {
+            using Shard = std::remove_const_t<typename Shards::value_type::element_type>;
+
+            std::vector<std::pair<size_t, std::string_view>> keys;
+            keys.reserve(changed.size());
+            for (const auto& name : changed)
+                keys.emplace_back(StateSnapshot::ShardOf(name), name);
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+            for (size_t i = 0; i < keys.size();)
+            {
+                const size_t shardIndex = keys[i].first;
+                auto shard = std::make_shared<Shard>(*shards[shardIndex]);
+                for (; i < keys.size() && keys[i].first == shardIndex; ++i)
+                {
+                    const std::string_view name = keys[i].second;
+                    auto it = std::lower_bound(shard->begin(), shard->end(), name,
+                                [&](const auto& entry, std::string_view key) { return nameOf(entry) < key; });
+                    const bool present = it != shard->end() && nameOf(*it) == name;
+                    auto entry = makeEntry(name);
+                    if (entry && present)
+                        *it = std::move(*entry);
+                    else if (entry)
+                        shard->insert(it, std::move(*entry));
+                    else if (present)
+                        shard->erase(it);
+                }
+                shards[shardIndex] = std::move(shard);
+            }
+        }
+
+        template <typename Shards, typename Map, typename MakeEntry, typename NameOf>
+        void BuildShards(Shards& shards, const Map& live, MakeEntry makeEntry, NameOf nameOf)
+        {
+            using Shard = std::remove_const_t<typename Shards::value_type::element_type>;
+
+            std::array<Shard, StateSnapshot::SHARD_COUNT> built;
+            for (const auto& [name, value] : live)
+                built[StateSnapshot::ShardOf(name)].push_back(*makeEntry(name));
+            for (size_t i = 0; i < built.size(); ++i)
+            {
+                std::sort(built[i].begin(), built[i].end(),
+                            [&](const auto& lhs, const auto& rhs) { return nameOf(lhs) < nameOf(rhs); });
+                shards[i] = std::make_shared<const Shard>(std::move(built[i]));
+            }
+        }
+
+        void Adjust(size_t& counter, size_t amount, bool add)
+        {
+            counter = add ? counter + amount : counter - amount;
+        }
+    }
+    /**
+     * @brief Constructs an empty state.
+     * @param resource The memory resource for users, groups, their names, message blocks, the maps
+     * and the username index. It must outlive the state and every snapshot taken from it, and be
+     * thread-safe (e.g. std::pmr::synchronized_pool_resource) if snapshots are read from other threads.
+     */
+    SystemState::SystemState(std::pmr::memory_resource* resource)
+        : m_resource(resource), m_userMap(resource), m_groupMap(resource), m_usernameIndex(resource),
+          m_groupRetention(resource), m_releaseQueue(resource), m_changedUsers(resource), m_changedGroups(resource),
+          m_undoLog(resource) {}
+    /**
+     * @brief Gets the memory resource the state allocates from.
+     */
+    std::pmr::memory_resource* SystemState::GetMemoryResource() const
+    {
+        return m_resource;
+    }
+    /**
+     * @brief Makes a user whose storage comes from the state's memory resource, ready for AddUser.
+     * @param username The username of the new user.
+     */
+    std::shared_ptr<User> SystemState::NewUser(std::string_view username) const
+    {
+        return std::allocate_shared<User>(std::pmr::polymorphic_allocator<User>(m_resource), username, m_resource);
+    }
     /**
      * @brief Checks if a user with the given username exists.
      * @param username The username to check.
      * @return True if the user exists, false otherwise.
      */
-    bool SystemState::isUserExists(const std::string& username) const
+    bool SystemState::isUserExists(std::string_view username) const
     {
         return m_userMap.find(username) != m_userMap.end();
     }
@@ -23,7 +119,7 @@ namespace Domain
      * @param groupName The group name to check.
      * @return True if the group exists, false otherwise.
      */
-    bool SystemState::isGroupExists(const std::string& groupName) const
+    bool SystemState::isGroupExists(std::string_view groupName) const
     {
         return m_groupMap.find(groupName) != m_groupMap.end();
     }
@@ -33,7 +129,7 @@ namespace Domain
      * @param groupName The group to verify membership.
      * @return True if the user belongs to the group, false otherwise.
      */
-    bool SystemState::isUserInGroup(const std::string& username, const std::string& groupName) const
+    bool SystemState::isUserInGroup(std::string_view username, std::string_view groupName) const
     {
         auto groupIt = m_groupMap.find(groupName);
         if (groupIt == m_groupMap.end())
@@ -56,10 +152,15 @@ namespace Domain
     {
         if (isUserExists(user->getUsername()))
         {
-            throw  UserAlreadyExistsException("ADD USER ", "User " + user->getUsername() + " already exist");
+            throw  UserAlreadyExistsException("ADD USER ", "User " + std::string(user->getUsername()) + " already exist");
         }
 
-        m_userMap[user->getUsername()] = user;
+        m_userMap.try_emplace(user->getUsername(), user);
+        m_usernameIndex.Insert(user->getUsername());
+        AccountUser(*user, true);
+        if (m_inTransaction)
+            m_undoLog.push_back({UndoAction::RemoveUser, user, nullptr});
+        MarkUserChanged(user->getUsername());
     }
     /**
      * @brief Creates a new group in the system.
@@ -67,35 +168,50 @@ namespace Domain
      */
     void SystemState::CreateNewGroup(const std::shared_ptr<Group>& group)
     {
-        m_groupMap[group->getGroupName()] = group;
+        m_groupMap.try_emplace(group->getGroupName(), group);
+        AccountGroup(*group, true);
+        MarkGroupChanged(group->getGroupName());
     }
     /**
      * @brief Deletes a user from the system.
      * @param username The username of the user to delete.
      * @throws UserNotFoundException if the user does not exist.
      */
-    void SystemState::DeleteUser(const std::string& username)
+    void SystemState::DeleteUser(std::string_view username)
     {
         if (!isUserExists(username))
         {
-            throw  UserNotFoundException("DELETE USER", "User: " + username + " does not exist");
+            throw  UserNotFoundException("DELETE USER", "User: " + std::string(username) + " does not exist");
         }
 
-        m_userMap.erase(username);
+        auto it = m_userMap.find(username);
+        // `username` may view the user's own name (e.g. getUsername()), so it is only used while
+        // the user is still held.
+        const std::shared_ptr<User> user = it->second;
+        if (m_inTransaction)
+            m_undoLog.push_back({UndoAction::RestoreUser, user, nullptr});
+        AccountUser(*user, false);
+        m_usernameIndex.Erase(user->getUsername());
+        m_userMap.erase(it);
+        MarkUserChanged(user->getUsername());
     }
     /**
      * @brief Disables a user in the system (soft removal).
      * @param username The username of the user to disable.
      * @throws UserNotFoundException if the user does not exist.
      */
-    void SystemState::DisableUser(const std::string& username)
+    void SystemState::DisableUser(std::string_view username)
     {
         if (!isUserExists(username))
         {
-            throw  UserNotFoundException("DISABLE USER " + username, " User does not exist");
+            throw  UserNotFoundException("DISABLE USER " + std::string(username), " User does not exist");
         }
 
-        m_userMap[username]->disable();
+        const auto& user = m_userMap.find(username)->second;
+        if (m_inTransaction && !user->isDisabled())
+            m_undoLog.push_back({UndoAction::EnableUser, user, nullptr});
+        user->disable();
+        MarkUserChanged(username);
     }
     /**
      * @brief Retrieves all users in the system.
@@ -132,27 +248,34 @@ namespace Domain
      * @throws UserNotFoundException if the user does not exist.
      * @throws CommandExecutionException if the user is already in the group or is disabled.
      */
-    void SystemState::AddUserToGroup(const std::string& username, const std::string& groupName)
+    void SystemState::AddUserToGroup(std::string_view username, std::string_view groupName)
     {
         if (!isUserExists(username))
-            throw  UserNotFoundException("ADD USER " + username + " TO GROUP " + groupName, " User does not exist");
+            throw  UserNotFoundException("ADD USER " + std::string(username) + " TO GROUP " + std::string(groupName), " User does not exist");
 
         if (isUserInGroup(username, groupName))
-            throw CommandExecutionException("ADD USER " + username + " TO GROUP " + groupName, " User already belong in that group");
+            throw CommandExecutionException("ADD USER " + std::string(username) + " TO GROUP " + std::string(groupName), " User already belong in that group");
 
-        auto user = m_userMap.at(username);
+        auto user = m_userMap.find(username)->second;
 
         if(user->isDisabled())
-            throw CommandExecutionException("ADD USER " + username + " TO GROUP " + groupName, " User is disabled");
+            throw CommandExecutionException("ADD USER " + std::string(username) + " TO GROUP " + std::string(groupName), " User is disabled");
 
         if (!isGroupExists(groupName))
         {
-            auto newGroup = std::make_shared<Group>(groupName);
+            auto newGroup = std::allocate_shared<Group>(std::pmr::polymorphic_allocator<Group>(m_resource), groupName, m_resource);
             CreateNewGroup(newGroup);
         }
 
-        auto group = m_groupMap.at(groupName);
+        auto group = m_groupMap.find(groupName)->second;
+        AccountUser(*user, false);
+        AccountGroup(*group, false);
         group->AddMembers(user);
+        AccountUser(*user, true);
+        AccountGroup(*group, true);
+        if (m_inTransaction)
+            m_undoLog.push_back({UndoAction::LeaveGroup, user, group});
+        MarkGroupChanged(groupName);
     }
     /**
      * @brief Removes a user from a group. If the group becomes empty, it is deleted.
@@ -161,27 +284,37 @@ namespace Domain
      * @throws UserNotFoundException if the user does not exist.
      * @throws CommandExecutionException if the group doesn't exist or the user isn't in it.
      */
-    void SystemState::RemoveUserFromGroup(const std::string& username, const std::string& groupName)
+    void SystemState::RemoveUserFromGroup(std::string_view username, std::string_view groupName)
     {
         if (!isUserExists(username) )
-            throw UserNotFoundException("REMOVE USER " + username + " FROM GROUP " + groupName, " User does not exist");
+            throw UserNotFoundException("REMOVE USER " + std::string(username) + " FROM GROUP " + std::string(groupName), " User does not exist");
 
         if ( !isGroupExists(groupName))
-            throw CommandExecutionException("REMOVE USER " + username + " FROM GROUP " + groupName, " Group does not exist");
+            throw CommandExecutionException("REMOVE USER " + std::string(username) + " FROM GROUP " + std::string(groupName), " Group does not exist");
 
         if ( !isUserInGroup(username, groupName))
-            throw CommandExecutionException("REMOVE USER " + username + " FROM GROUP " + groupName, " User doesn't belong in that group");
+            throw CommandExecutionException("REMOVE USER " + std::string(username) + " FROM GROUP " + std::string(groupName), " User doesn't belong in that group");
 
-        auto user = m_userMap.at(username);
-        auto group = m_groupMap.at(groupName);
+        auto user = m_userMap.find(username)->second;
+        auto group = m_groupMap.find(groupName)->second;
 
-        group->RemoveMember(user);
+        AccountUser(*user, false);
+        AccountGroup(*group, false);
+        const size_t position = group->RemoveMember(user);
         user->RemoveGroup(group);
+        AccountUser(*user, true);
+        if (m_inTransaction)
+            m_undoLog.push_back({UndoAction::RejoinGroup, user, group, position});
 
         if (group->getMemberCount() == 0)
         {
-            m_groupMap.erase(groupName);
+            m_groupMap.erase(group->getGroupName());
+        }
+        else
+        {
+            AccountGroup(*group, true);
         }
+        MarkGroupChanged(group->getGroupName());
     }
     /**
      * @brief Sends a message to a specific user.
@@ -190,33 +323,582 @@ namespace Domain
      * @throws UserNotFoundException if the recipient doesn't exist.
      * @throws CommandExecutionException if the user is disabled.
      */
-    void SystemState::SendMessage(const std::string& toUser, std::unique_ptr<Message> message)
+    void SystemState::SendMessage(std::string_view toUser, Message message)
     {
         if (!isUserExists(toUser))
         {
-            throw UserNotFoundException("SEND MESSAGE  " + toUser + " '" + message->getContent() +" '", " User does not exist");
+            throw UserNotFoundException("SEND MESSAGE  " + std::string(toUser) + " '" + message.getContent() +" '", " User does not exist");
         }
 
-        auto user = m_userMap.at(toUser);
+        auto user = m_userMap.find(toUser)->second;
         if(user->isDisabled())
-            throw CommandExecutionException("SEND MESSAGE  " + toUser + " '" + message->getContent() +" '", " User is disabled");
-        user->AddMessage(std::move(message));
+            throw CommandExecutionException("SEND MESSAGE  " + std::string(toUser) + " '" + message.getContent() +" '", " User is disabled");
+        if (m_messageIndex)
+            m_messageIndex->Add(user, user->getMessages().size(), MessageIndex::Tokenize(message.getContent()));
+        AccountUser(*user, false);
+        user->AddMessage(std::move(message), m_epoch + 1);
+        if (m_inTransaction)
+            m_undoLog.push_back({UndoAction::RemoveMessage, user, nullptr});
+        EnforceRetention(user, m_retention);
+        AccountUser(*user, true);
+        ReleaseTrimmedMessages();
+        CompactMessageIndex();
+        m_hasPendingChanges = true;
+    }
+    /**
+     * @brief Sends a message to every enabled member of a group.
+     * Every member receives a handle to the same body, so the text is stored once.
+     * @param groupName The recipient group.
+     * @param message The message to send.
+     * @return The number of members that received the message. Disabled members, and members
+     * deleted from the system while still listed in the group, are skipped.
+     * @throws CommandExecutionException if the group doesn't exist.
+     */
+    size_t SystemState::SendMessageToGroup(std::string_view groupName, const Message& message)
+    {
+        auto groupIt = m_groupMap.find(groupName);
+        if (groupIt == m_groupMap.end())
+            throw CommandExecutionException("SEND MESSAGE TO GROUP " + std::string(groupName) + " '" + message.getContent() + "'", " Group does not exist");
+
+        const auto terms = m_messageIndex ? MessageIndex::Tokenize(message.getContent()) : std::vector<std::string>();
+        auto policyIt = m_groupRetention.find(groupName);
+        const RetentionPolicy policy = policyIt == m_groupRetention.end() ? m_retention : RetentionPolicy::Tighter(m_retention, policyIt->second);
+        size_t delivered = 0;
+        for (const auto& member : groupIt->second->getMembers())
+        {
+            if (!member || member->isDisabled())
+                continue;
+            auto userIt = m_userMap.find(member->getUsername());
+            if (userIt == m_userMap.end() || userIt->second != member)
+                continue;
+            if (m_messageIndex)
+                m_messageIndex->Add(member, member->getMessages().size(), terms);
+            AccountUser(*member, false);
+            member->AddMessage(message, m_epoch + 1);
+            if (m_inTransaction)
+                m_undoLog.push_back({UndoAction::RemoveMessage, member, nullptr});
+            EnforceRetention(member, policy);
+            AccountUser(*member, true);
+            ++delivered;
+        }
+        ReleaseTrimmedMessages();
+        CompactMessageIndex();
+        m_hasPendingChanges = m_hasPendingChanges || delivered > 0;
+        return delivered;
     }
     /**
      * @brief Retrieves the message history of a user.
      * @param username The user whose message history to retrieve.
-     * @return Reference to the vector of messages.
+     * @return The messages the user still retains.
      * @throws UserNotFoundException if the user does not exist.
      */
-    const std::vector<std::unique_ptr<Message>>& SystemState::getMessageHistory(const std::string& username) const
+    MessageHistoryView SystemState::getMessageHistory(std::string_view username) const
     {
         if (!isUserExists(username))
         {
-            throw UserNotFoundException("GET MESSAGE HISTORY " + username, " User does not exist");
+            throw UserNotFoundException("GET MESSAGE HISTORY " + std::string(username), " User does not exist");
+        }
+
+        const auto& user = m_userMap.find(username)->second;
+        return MessageHistoryView(nullptr, user, user->getMessages().FirstIndex(), user->getMessages().size());
+    }
+    /**
+     * @brief Sets the retention policy of every history. It is enforced on each user the next
+     * time they receive a message, dropping their oldest messages.
+     */
+    void SystemState::SetRetentionPolicy(const RetentionPolicy& policy)
+    {
+        m_retention = policy;
+    }
+
+    const RetentionPolicy& SystemState::GetRetentionPolicy() const
+    {
+        return m_retention;
+    }
+    /**
+     * @brief Sets a retention policy for the members of a group, enforced (together with the
+     * system policy, the stricter bound winning) when a message is sent to the group.
+     * @param groupName The group; it does not need to exist yet.
+     * @param policy The bounds; an unlimited policy removes the group's own policy.
+     */
+    void SystemState::SetGroupRetentionPolicy(std::string_view groupName, const RetentionPolicy& policy)
+    {
+        if (policy.IsUnlimited())
+            m_groupRetention.erase(groupName);
+        else
+            m_groupRetention.try_emplace(groupName).first->second = policy;
+    }
+    /**
+     * @brief Trims a user's history to a policy right after a message was delivered. The next
+     * version records the new first message; the trimmed blocks are queued for
+     * ReleaseTrimmedMessages.
+     */
+    void SystemState::EnforceRetention(const std::shared_ptr<User>& user, const RetentionPolicy& policy)
+    {
+        if (policy.IsUnlimited())
+            return;
+
+        const size_t first = user->getMessages().FirstIndex();
+        const bool queued = user->getMessages().HasPendingReleases();
+        const size_t dropped = user->TrimMessages(policy, m_epoch + 1);
+        if (dropped == 0)
+            return;
+        m_trimmedSinceIndexBuild += dropped;
+        if (m_inTransaction)
+            m_undoLog.push_back({UndoAction::RestoreMessages, user, nullptr, first});
+        if (!queued && user->getMessages().HasPendingReleases())
+            m_releaseQueue.push_back(user);
+        MarkUserChanged(user->getUsername());
+    }
+    /**
+     * @brief Frees the trimmed blocks that no readable version can still see. Users trimmed since
+     * the last sweep are checked every time; the whole queue only when the oldest visible epoch
+     * moved, so a user who stops receiving messages still gets their blocks freed. Deleted users
+     * leave the queue: their log goes away with the last version that holds them. Waits for the
+     * end of a transaction, which may still restore the trimmed messages.
+     */
+    void SystemState::ReleaseTrimmedMessages()
+    {
+        if (m_inTransaction || m_releaseQueue.empty())
+            return;
+
+        auto isLive = [this](const std::shared_ptr<User>& user)
+        {
+            auto it = m_userMap.find(user->getUsername());
+            return it != m_userMap.end() && it->second == user;
+        };
+        const uint64_t oldest = OldestVisibleEpoch();
+        const size_t from = oldest != m_releaseEpoch ? 0 : m_releaseQueueSwept;
+        m_releaseEpoch = oldest;
+        for (size_t i = from; i < m_releaseQueue.size(); ++i)
+        {
+            const auto& user = m_releaseQueue[i];
+            if (!isLive(user))
+                continue;
+            AccountUser(*user, false);
+            user->ReleaseTrimmedMessages(oldest);
+            AccountUser(*user, true);
+        }
+        std::erase_if(m_releaseQueue, [&](const auto& user) { return !user->getMessages().HasPendingReleases() || !isLive(user); });
+        m_releaseQueueSwept = m_releaseQueue.size();
+    }
+    /**
+     * @brief Rebuilds the message index once most of its documents are trimmed messages, so its
+     * size follows the retained histories. Amortized over the trims, and skipped inside a
+     * transaction, whose undo relies on the index order.
+     */
+    void SystemState::CompactMessageIndex()
+    {
+        if (!m_messageIndex || m_inTransaction || m_trimmedSinceIndexBuild <= m_messageIndex->GetDocumentCount() / 2)
+            return;
+        m_messageIndex.reset();
+        SetMessageIndexEnabled(true);
+    }
+    /**
+     * @brief Gets the epoch of the oldest version a reader may still hold: the oldest superseded
+     * version still alive, else the current one. Without versions nothing can be read concurrently.
+     */
+    uint64_t SystemState::OldestVisibleEpoch()
+    {
+        while (!m_olderVersions.empty() && m_olderVersions.front().second.expired())
+            m_olderVersions.pop_front();
+        if (!m_olderVersions.empty())
+            return m_olderVersions.front().first;
+        return m_current ? m_current->GetEpoch() : UINT64_MAX;
+    }
+    /**
+     * @brief Starts (or stops) maintaining the inverted message index used by SearchMessages.
+     * Enabling indexes the messages already received; afterwards each message is tokenized once
+     * when it is sent.
+     * @throws std::runtime_error if called while a transaction is open.
+     */
+    void SystemState::SetMessageIndexEnabled(bool enabled)
+    {
+        if (m_inTransaction)
+            throw std::runtime_error("[SystemState] The message index cannot change inside a transaction");
+        if (!enabled)
+        {
+            m_messageIndex.reset();
+            return;
+        }
+        if (m_messageIndex)
+            return;
+
+        m_messageIndex = std::make_unique<MessageIndex>();
+        m_trimmedSinceIndexBuild = 0;
+        m_usernameIndex.ForEach([this](std::string_view name)
+        {
+            const auto& user = m_userMap.find(name)->second;
+            size_t position = user->getMessages().FirstIndex();
+            for (const Message& message : user->getMessages())
+                m_messageIndex->Add(user, position++, MessageIndex::Tokenize(message.getContent()));
+            return true;
+        });
+    }
+    /**
+     * @brief Gets the inverted message index, or nullptr when it is disabled.
+     */
+    const MessageIndex* SystemState::GetMessageIndex() const
+    {
+        return m_messageIndex.get();
+    }
+    /**
+     * @brief Finds the messages of existing users that contain every term of a query.
+     * Uses the message index when enabled and scans every history otherwise.
+     * @param query Free text; its terms are matched case-insensitively (see MessageIndex::Tokenize).
+     * @return The matches sorted by username and position in the history; empty for a query without terms.
+     */
+    std::vector<MessageMatch> SystemState::SearchMessages(std::string_view query) const
+    {
+        const auto terms = MessageIndex::Tokenize(query);
+        if (terms.empty())
+            return {};
+
+        std::vector<MessageMatch> matches;
+        if (m_messageIndex)
+        {
+            matches = m_messageIndex->Search(terms);
+            std::erase_if(matches, [this](const MessageMatch& match)
+            {
+                auto it = m_userMap.find(match.user->getUsername());
+                const auto& messages = match.user->getMessages();
+                return it == m_userMap.end() || it->second != match.user || match.messageIndex < messages.FirstIndex() || match.messageIndex >= messages.size();
+            });
+        }
+        else
+        {
+            for (const auto& [username, user] : m_userMap)
+            {
+                size_t position = user->getMessages().FirstIndex();
+                for (const Message& message : user->getMessages())
+                {
+                    const auto messageTerms = MessageIndex::Tokenize(message.getContent());
+                    if (std::includes(messageTerms.begin(), messageTerms.end(), terms.begin(), terms.end()))
+                        matches.push_back({user, position});
+                    ++position;
+                }
+            }
         }
 
-        return m_userMap.at(username)->getMessages();
+        std::sort(matches.begin(), matches.end(), [](const MessageMatch& lhs, const MessageMatch& rhs)
+        {
+            return std::pair(lhs.user->getUsername(), lhs.messageIndex) < std::pair(rhs.user->getUsername(), rhs.messageIndex);
+        });
+        return matches;
+    }
+    /**
+     * @brief Records `times` pings sent to a user in constant time.
+     * Pings to a user that does not exist are counted as sent but not received.
+     * @param username The recipient username.
+     * @param times The number of pings.
+     * @return The total pings received by the user, or std::nullopt if the user does not exist.
+     */
+    std::optional<uint64_t> SystemState::RecordPing(std::string_view username, uint64_t times)
+    {
+        m_pingsSent += times;
+        auto it = m_userMap.find(username);
+        if (m_inTransaction)
+            m_undoLog.push_back({UndoAction::RemovePings, it == m_userMap.end() ? nullptr : it->second, nullptr, times});
+        if (it == m_userMap.end())
+        {
+            m_pingsToUnknownUsers += times;
+            return std::nullopt;
+        }
+        return it->second->AddPings(times);
+    }
+    /**
+     * @brief Gets the ping counters: totals and pings received per user, sorted by username.
+     * Users that never received a ping are left out.
+     */
+    PingStats SystemState::GetPingStats() const
+    {
+        PingStats stats{m_pingsSent, m_pingsToUnknownUsers, {}};
+        for (const auto& [username, user] : m_userMap)
+        {
+            if (user->getPingsReceived() > 0)
+                stats.receivedByUser.emplace_back(username, user->getPingsReceived());
+        }
+        std::sort(stats.receivedByUser.begin(), stats.receivedByUser.end());
+        return stats;
+    }
+    /**
+     * @brief Gets live counts and approximate bytes per component. Counts, names, objects,
+     * memberships and message storage are kept up to date by every change; the hash tables and
+     * the username index are sized in O(1), and the message index, when enabled, in O(terms).
+     */
+    MemoryStats SystemState::GetMemoryStats() const
+    {
+        MemoryStats stats = m_memory;
+        stats.hashTableBytes = m_userMap.MemoryUsage() + m_groupMap.MemoryUsage();
+        stats.indexBytes = m_usernameIndex.MemoryUsage() + (m_messageIndex ? m_messageIndex->MemoryUsage() : 0);
+        return stats;
+    }
+    /**
+     * @brief Adds or removes a live user's share of the memory stats. Called before and after
+     * each change to a user, so the stats follow the change in O(1).
+     * The name is counted three times: the user, its map key and its username index entry.
+     */
+    void SystemState::AccountUser(const User& user, bool add)
+    {
+        const auto& messages = user.getMessages();
+        Adjust(m_memory.users, 1, add);
+        Adjust(m_memory.userObjectBytes, sizeof(User) + MemoryStats::CONTROL_BLOCK_BYTES, add);
+        Adjust(m_memory.nameBytes, 3 * MemoryStats::HeapBytes(user.getUsername()), add);
+        Adjust(m_memory.membershipBytes, user.getGroups().capacity() * sizeof(std::weak_ptr<Group>), add);
+        Adjust(m_memory.messages, messages.size() - messages.FirstIndex(), add);
+        Adjust(m_memory.messageBodyBytes, messages.BodyBytes(), add);
+        Adjust(m_memory.messageStorageBytes, messages.StorageBytes(), add);
+    }
+    /**
+     * @brief Adds or removes a live group's share of the memory stats (see AccountUser).
+     * The name is counted twice: the group and its map key.
+     */
+    void SystemState::AccountGroup(const Group& group, bool add)
+    {
+        Adjust(m_memory.groups, 1, add);
+        Adjust(m_memory.groupObjectBytes, sizeof(Group) + MemoryStats::CONTROL_BLOCK_BYTES, add);
+        Adjust(m_memory.nameBytes, 2 * MemoryStats::HeapBytes(group.getGroupName()), add);
+        Adjust(m_memory.memberships, static_cast<size_t>(group.getMemberCount()), add);
+        Adjust(m_memory.membershipBytes, group.getMembers().capacity() * sizeof(std::shared_ptr<User>), add);
+    }
+    /**
+     * @brief Gets a consistent, immutable version of the state that includes every change made so far.
+     * Publishes pending changes first. Must be called by the thread that mutates the state; the
+     * first call starts tracking changes.
+     */
+    std::shared_ptr<const StateSnapshot> SystemState::Snapshot()
+    {
+        if (!m_snapshotsEnabled || m_hasPendingChanges)
+            Publish();
+        ReleaseTrimmedMessages();
+        return m_current;
+    }
+    /**
+     * @brief Gets the latest published version without waiting for the writer. Safe from any thread.
+     * @return The version, or nullptr if the owner never published one.
+     */
+    std::shared_ptr<const StateSnapshot> SystemState::LatestSnapshot() const
+    {
+        return m_published.Load();
+    }
+    /**
+     * @brief Publishes pending changes, if versions are being published at all.
+     * Called by the owner at natural boundaries (e.g. after each task file).
+     */
+    void SystemState::PublishPending()
+    {
+        if (m_snapshotsEnabled && m_hasPendingChanges)
+            Publish();
+        ReleaseTrimmedMessages();
+    }
+    /**
+     * @brief Gets the epoch of the latest published version (0 before the first one).
+     */
+    uint64_t SystemState::GetEpoch() const
+    {
+        return m_epoch;
     }
 
+    void SystemState::MarkUserChanged(std::string_view username)
+    {
+        m_hasPendingChanges = true;
+        if (!m_snapshotsEnabled || (!m_changedUsers.empty() && m_changedUsers.back() == username))
+            return;
+        m_changedUsers.emplace_back(username);
+        if (m_changedUsers.size() > std::max(MIN_PENDING_CHANGES, m_userMap.size() / 4))
+            Publish();
+    }
 
+    void SystemState::MarkGroupChanged(std::string_view groupName)
+    {
+        m_hasPendingChanges = true;
+        if (!m_snapshotsEnabled)
+            return;
+        m_changedGroups.emplace_back(groupName);
+        if (m_changedGroups.size() > std::max(MIN_PENDING_CHANGES, m_groupMap.size() / 4))
+            Publish();
+    }
+    /**
+     * @brief Builds the next version from the previous one and the changed users and groups,
+     * then makes it visible to readers. Old versions are freed by their last reader.
+     */
+    void SystemState::Publish()
+    {
+        auto next = m_current ? std::make_shared<StateSnapshot>(*m_current) : std::make_shared<StateSnapshot>();
+
+        auto userEntry = [this](std::string_view name) -> std::optional<StateSnapshot::UserEntry>
+        {
+            auto it = m_userMap.find(name);
+            if (it == m_userMap.end())
+                return std::nullopt;
+            return StateSnapshot::UserEntry{it->second, it->second->isDisabled(), it->second->getMessages().FirstIndex()};
+        };
+        auto groupEntry = [this](std::string_view name) -> std::optional<StateSnapshot::GroupEntry>
+        {
+            auto it = m_groupMap.find(name);
+            if (it == m_groupMap.end())
+                return std::nullopt;
+            return StateSnapshot::GroupEntry{it->second, it->second->getMemberCount()};
+        };
+        auto userName = [](const StateSnapshot::UserEntry& entry) { return entry.GetName(); };
+        auto groupName = [](const StateSnapshot::GroupEntry& entry) { return entry.GetName(); };
+
+        if (!m_current || !m_changedUsers.empty())
+            next->m_usernames = m_usernameIndex.Freeze();
+        if (!m_current)
+        {
+            BuildShards(next->m_userShards, m_userMap, userEntry, userName);
+            BuildShards(next->m_groupShards, m_groupMap, groupEntry, groupName);
+        }
+        else
+        {
+            ApplyChanges(next->m_userShards, m_changedUsers, userEntry, userName);
+            ApplyChanges(next->m_groupShards, m_changedGroups, groupEntry, groupName);
+        }
+
+        next->m_epoch = ++m_epoch;
+        next->m_userCount = m_userMap.size();
+        next->m_groupCount = m_groupMap.size();
+        if (m_current)
+        {
+            std::erase_if(m_olderVersions, [](const auto& version) { return version.second.expired(); });
+            m_olderVersions.emplace_back(m_current->GetEpoch(), m_current);
+        }
+        m_current = std::move(next);
+        if (m_inTransaction)
+            m_publishHeldBack = true;
+        else
+            m_published.Store(m_current);
+
+        m_snapshotsEnabled = true;
+        m_hasPendingChanges = false;
+        m_changedUsers.clear();
+        m_changedGroups.clear();
+    }
+    /**
+     * @brief Starts recording the inverse of every mutation in the undo log, so the changes made
+     * until CommitTransaction can be undone with RollbackTransaction in time proportional to them.
+     * Versions published meanwhile stay private to the owner thread until the transaction ends.
+     * @throws std::runtime_error if a transaction is already open.
+     */
+    void SystemState::BeginTransaction()
+    {
+        if (m_inTransaction)
+            throw std::runtime_error("[SystemState] A transaction is already open");
+        m_inTransaction = true;
+    }
+    /**
+     * @brief Keeps the changes of the open transaction and forgets its undo log.
+     */
+    void SystemState::CommitTransaction()
+    {
+        m_undoLog.clear();
+        EndTransaction();
+    }
+    /**
+     * @brief Undoes every change of the open transaction, latest first.
+     * @return The number of changes undone.
+     */
+    size_t SystemState::RollbackTransaction()
+    {
+        const size_t undone = m_undoLog.size();
+        for (auto it = m_undoLog.rbegin(); it != m_undoLog.rend(); ++it)
+            Undo(*it);
+        m_undoLog.clear();
+        EndTransaction();
+        return undone;
+    }
+    /**
+     * @brief Checks whether changes are being recorded in the undo log.
+     */
+    bool SystemState::InTransaction() const
+    {
+        return m_inTransaction;
+    }
+
+    void SystemState::Undo(const UndoEntry& entry)
+    {
+        switch (entry.action)
+        {
+            case UndoAction::RemoveUser:
+                AccountUser(*entry.user, false);
+                m_userMap.erase(entry.user->getUsername());
+                m_usernameIndex.Erase(entry.user->getUsername());
+                MarkUserChanged(entry.user->getUsername());
+                break;
+            case UndoAction::RestoreUser:
+                m_userMap.try_emplace(entry.user->getUsername(), entry.user);
+                m_usernameIndex.Insert(entry.user->getUsername());
+                AccountUser(*entry.user, true);
+                MarkUserChanged(entry.user->getUsername());
+                break;
+            case UndoAction::EnableUser:
+                entry.user->enable();
+                MarkUserChanged(entry.user->getUsername());
+                break;
+            case UndoAction::RemoveMessage:
+                if (m_messageIndex)
+                {
+                    const auto& messages = entry.user->getMessages();
+                    m_messageIndex->RemoveLast(MessageIndex::Tokenize(messages[messages.size() - 1].getContent()));
+                }
+                AccountUser(*entry.user, false);
+                entry.user->RemoveLastMessage();
+                AccountUser(*entry.user, true);
+                m_hasPendingChanges = true;
+                break;
+            case UndoAction::RestoreMessages:
+                AccountUser(*entry.user, false);
+                entry.user->RestoreMessages(entry.value);
+                AccountUser(*entry.user, true);
+                MarkUserChanged(entry.user->getUsername());
+                break;
+            case UndoAction::LeaveGroup:
+                AccountUser(*entry.user, false);
+                AccountGroup(*entry.group, false);
+                entry.group->RemoveMember(entry.user);
+                AccountUser(*entry.user, true);
+                if (entry.group->getMemberCount() == 0)
+                    m_groupMap.erase(entry.group->getGroupName());
+                else
+                    AccountGroup(*entry.group, true);
+                MarkGroupChanged(entry.group->getGroupName());
+                break;
+            case UndoAction::RejoinGroup:
+                if (!m_groupMap.try_emplace(entry.group->getGroupName(), entry.group).second)
+                    AccountGroup(*entry.group, false);
+                AccountUser(*entry.user, false);
+                entry.group->RestoreMember(entry.user, entry.value);
+                AccountUser(*entry.user, true);
+                AccountGroup(*entry.group, true);
+                MarkGroupChanged(entry.group->getGroupName());
+                break;
+            case UndoAction::RemovePings:
+                m_pingsSent -= entry.value;
+                if (entry.user)
+                    entry.user->RemovePings(entry.value);
+                else
+                    m_pingsToUnknownUsers -= entry.value;
+                break;
+        }
+    }
+    /**
+     * @brief Closes the transaction and makes a version held back during it visible to readers.
+     * After a rollback the held-back version may show undone changes, so it is rebuilt first.
+     * Then frees the trimmed blocks and compacts the message index, both deferred while it was open.
+     */
+    void SystemState::EndTransaction()
+    {
+        m_inTransaction = false;
+        if (m_publishHeldBack)
+        {
+            m_publishHeldBack = false;
+            if (m_hasPendingChanges)
+                Publish();
+            else
+                m_published.Store(m_current);
+        }
+        ReleaseTrimmedMessages();
+        CompactMessageIndex();
+    }
 }
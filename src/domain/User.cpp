@@ -8,13 +8,16 @@ namespace Domain
     /**
     * @brief Constructs a User with the given username.
     * @param username_ The username for the user.
+    * @param resource The memory resource for the name, the group list and the message history;
+    * it must outlive the user.
     */
-    User::User(std::string username_):m_userName(std::move(username_)){}
+    User::User(std::string_view username_, std::pmr::memory_resource* resource)
+        :m_userName(username_, resource), m_groups(resource), m_messages(resource){}
     /**
     * @brief Retrieves the username of the user.
-    * @return A const reference to the username string.
+    * @return A view of the username, valid while the user lives.
     */
-    const std::string& User::getUsername() const
+    std::string_view User::getUsername() const
     {
         return m_userName;
     }
@@ -34,18 +37,25 @@ namespace Domain
         m_disable = true;
     }
     /**
+    * @brief Enables the user again (used to undo a DisableUser).
+    */
+    void User::enable()
+    {
+        m_disable = false;
+    }
+    /**
     * @brief Gets the list of groups the user is a member of.
     * @return A const reference to a vector of weak pointers to groups.
     */
-    const std::vector<std::weak_ptr<Group>>& User::getGroups()const
+    const std::pmr::vector<std::weak_ptr<Group>>& User::getGroups()const
     {
         return m_groups;
     }
     /**
     * @brief Gets the list of messages received by the user.
-    * @return A const reference to a vector of unique pointers to messages.
+    * @return A const reference to the append-only message log.
     */
-    const std::vector<std::unique_ptr<Message>>& User::getMessages()const
+    const MessageLog& User::getMessages()const
     {
         return m_messages;
     }
@@ -76,7 +86,7 @@ namespace Domain
     * @param group The name of the group to check.
     * @return True if the user is in the group, false otherwise.
     */
-    bool User::isInGroup(const std::string& groupName) const
+    bool User::isInGroup(std::string_view groupName) const
     {
         return std::any_of(m_groups.begin(), m_groups.end(), [&](const std::weak_ptr<Group>& g)
                 {
@@ -89,10 +99,69 @@ namespace Domain
     }
     /**
     * @brief Adds a message to the user's message list.
-    * @param message A unique pointer to the message to add.
+    * @param message The message to add; its body may be shared with other users.
+    * @param epoch The state epoch the message becomes visible in (see SystemState::Snapshot).
+    */
+    void User::AddMessage(Message message, uint64_t epoch)
+    {
+        m_messages.Append(std::move(message), epoch);
+    }
+    /**
+    * @brief Removes the latest message of the user (used to undo a SendMessage).
+    */
+    void User::RemoveLastMessage()
+    {
+        m_messages.PopBack();
+    }
+    /**
+    * @brief Drops the user's oldest messages until the history fits a retention policy.
+    * @param policy The bounds to enforce.
+    * @param epoch The state epoch the trim becomes visible in.
+    * @return The number of messages dropped.
+    */
+    size_t User::TrimMessages(const RetentionPolicy& policy, uint64_t epoch)
+    {
+        return m_messages.Trim(policy, epoch);
+    }
+    /**
+    * @brief Makes trimmed messages visible again (used to undo a TrimMessages).
+    * @param first The first retained position to go back to.
+    */
+    void User::RestoreMessages(size_t first)
+    {
+        m_messages.RestoreFirst(first);
+    }
+    /**
+    * @brief Frees the storage of trimmed messages that no readable version can see any more.
+    * @param oldestVisibleEpoch The epoch of the oldest version that may still be read.
+    */
+    void User::ReleaseTrimmedMessages(uint64_t oldestVisibleEpoch)
+    {
+        m_messages.ReleaseTrimmed(oldestVisibleEpoch);
+    }
+    /**
+    * @brief Gets how many pings the user has received.
+    */
+    uint64_t User::getPingsReceived() const
+    {
+        return m_pingsReceived;
+    }
+    /**
+    * @brief Adds received pings to the user's counter.
+    * @param count The number of pings received.
+    * @return The total number of pings received so far.
+    */
+    uint64_t User::AddPings(uint64_t count)
+    {
+        m_pingsReceived += count;
+        return m_pingsReceived;
+    }
+    /**
+    * @brief Takes back received pings (used to undo a PING).
+    * @param count The number of pings to take back.
     */
-    void User::AddMessage(std::unique_ptr<Message> message)
+    void User::RemovePings(uint64_t count)
     {
-        m_messages.push_back(std::move(message));
+        m_pingsReceived -= count;
     }
 }
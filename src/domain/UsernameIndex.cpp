@@ -0,0 +1,239 @@
+#include "domain/UsernameIndex.h"
+
+#include <iterator>
+
+namespace Domain
+{
+    /**
+     * @brief Adds a name.
+     * @return false if the name was already present.
+     */
+    bool UsernameIndex::Insert(std::string_view name)
+    {
+        if (Contains(name))
+            return false;
+
+        if (!m_root)
+            m_root = NewNode();
+        if (auto split = InsertInto(m_root, name))
+        {
+            auto root = NewNode();
+            root->keys.push_back(std::move(split->separator));
+            root->children.push_back(std::move(m_root));
+            root->children.push_back(std::move(split->right));
+            m_root = std::move(root);
+        }
+        ++m_size;
+        return true;
+    }
+    /**
+     * @brief Removes a name.
+     * @return false if the name was not present.
+     */
+    bool UsernameIndex::Erase(std::string_view name)
+    {
+        if (!Contains(name))
+            return false;
+
+        EraseFrom(m_root, name);
+        if (!m_root->isLeaf() && m_root->keys.empty())
+        {
+            m_root = m_root->children.front();
+            --m_nodeCount;
+        }
+        else if (m_root->isLeaf() && m_root->keys.empty())
+        {
+            m_root.reset();
+            --m_nodeCount;
+        }
+        --m_size;
+        return true;
+    }
+    /**
+     * @brief Checks whether a name is present.
+     */
+    bool UsernameIndex::Contains(std::string_view name) const
+    {
+        const Node* node = m_root.get();
+        while (node && !node->isLeaf())
+            node = node->children[ChildFor(*node, name)].get();
+        return node && std::binary_search(node->keys.begin(), node->keys.end(), name);
+    }
+    /**
+     * @brief Gets an immutable version of the current names, sharing every node with this index.
+     * Nodes reachable from the version are copied before this index modifies them.
+     */
+    std::shared_ptr<const UsernameIndex> UsernameIndex::Freeze()
+    {
+        auto frozen = std::allocate_shared<UsernameIndex>(std::pmr::polymorphic_allocator<UsernameIndex>(m_resource), m_resource);
+        frozen->m_root = m_root;
+        frozen->m_size = m_size;
+        frozen->m_nodeCount = m_nodeCount;
+        ++m_generation;
+        return frozen;
+    }
+    /**
+     * @brief Approximates the heap bytes of the nodes of this version, without the text of the
+     * names themselves. Nodes shared with frozen versions are counted in each of them.
+     */
+    size_t UsernameIndex::MemoryUsage() const
+    {
+        constexpr size_t nodeBytes = sizeof(Node) + 2 * sizeof(void*) + (MAX_KEYS + 1) * sizeof(std::pmr::string) + sizeof(std::shared_ptr<Node>);
+        return m_nodeCount * nodeBytes;
+    }
+    /**
+     * @brief Gets the child of an inner node whose range holds a name.
+     */
+    size_t UsernameIndex::ChildFor(const Node& node, std::string_view name)
+    {
+        return static_cast<size_t>(std::upper_bound(node.keys.begin(), node.keys.end(), name) - node.keys.begin());
+    }
+
+    std::shared_ptr<UsernameIndex::Node> UsernameIndex::NewNode()
+    {
+        auto node = std::allocate_shared<Node>(std::pmr::polymorphic_allocator<Node>(m_resource), m_resource);
+        node->generation = m_generation;
+        node->keys.reserve(MAX_KEYS + 1);
+        ++m_nodeCount;
+        return node;
+    }
+    /**
+     * @brief Gets a node that may be modified in place, copying it first if a frozen version can reach it.
+     */
+    UsernameIndex::Node& UsernameIndex::Mutable(std::shared_ptr<Node>& slot)
+    {
+        if (slot->generation != m_generation)
+        {
+            auto copy = std::allocate_shared<Node>(std::pmr::polymorphic_allocator<Node>(m_resource), *slot, m_resource);
+            copy->generation = m_generation;
+            slot = std::move(copy);
+        }
+        return *slot;
+    }
+    /**
+     * @brief Inserts a name that is not present under a node.
+     * @return The new right sibling if the node overflowed and was split.
+     */
+    std::optional<UsernameIndex::Split> UsernameIndex::InsertInto(std::shared_ptr<Node>& slot, std::string_view name)
+    {
+        Node& node = Mutable(slot);
+        if (node.isLeaf())
+        {
+            node.keys.emplace(std::lower_bound(node.keys.begin(), node.keys.end(), name), name);
+        }
+        else
+        {
+            const size_t child = ChildFor(node, name);
+            auto split = InsertInto(node.children[child], name);
+            if (!split)
+                return std::nullopt;
+            node.keys.insert(node.keys.begin() + static_cast<std::ptrdiff_t>(child), std::move(split->separator));
+            node.children.insert(node.children.begin() + static_cast<std::ptrdiff_t>(child) + 1, std::move(split->right));
+        }
+
+        if (node.keys.size() <= MAX_KEYS)
+            return std::nullopt;
+        return SplitNode(node);
+    }
+    /**
+     * @brief Moves the upper half of an overflowing node into a new right sibling.
+     */
+    UsernameIndex::Split UsernameIndex::SplitNode(Node& node)
+    {
+        auto right = NewNode();
+        const auto middle = static_cast<std::ptrdiff_t>(node.keys.size() / 2);
+        std::pmr::string separator(m_resource);
+        if (node.isLeaf())
+        {
+            right->keys.assign(std::make_move_iterator(node.keys.begin() + middle), std::make_move_iterator(node.keys.end()));
+            separator = right->keys.front();
+            node.keys.erase(node.keys.begin() + middle, node.keys.end());
+        }
+        else
+        {
+            separator = std::move(node.keys[static_cast<size_t>(middle)]);
+            right->keys.assign(std::make_move_iterator(node.keys.begin() + middle + 1), std::make_move_iterator(node.keys.end()));
+            right->children.assign(std::make_move_iterator(node.children.begin() + middle + 1), std::make_move_iterator(node.children.end()));
+            node.keys.erase(node.keys.begin() + middle, node.keys.end());
+            node.children.erase(node.children.begin() + middle + 1, node.children.end());
+        }
+        return {std::move(separator), std::move(right)};
+    }
+    /**
+     * @brief Removes a name that is present under a node, rebalancing children that underflow.
+     */
+    void UsernameIndex::EraseFrom(std::shared_ptr<Node>& slot, std::string_view name)
+    {
+        Node& node = Mutable(slot);
+        if (node.isLeaf())
+        {
+            node.keys.erase(std::lower_bound(node.keys.begin(), node.keys.end(), name));
+            return;
+        }
+
+        const size_t child = ChildFor(node, name);
+        EraseFrom(node.children[child], name);
+        if (node.children[child]->keys.size() < MIN_KEYS)
+            Rebalance(node, child);
+    }
+    /**
+     * @brief Refills an underflowing child from a sibling, or merges the two when they fit in one node.
+     */
+    void UsernameIndex::Rebalance(Node& parent, size_t child)
+    {
+        const size_t leftIndex = child > 0 ? child - 1 : child;
+        Node& left = Mutable(parent.children[leftIndex]);
+        Node& right = Mutable(parent.children[leftIndex + 1]);
+        std::pmr::string& separator = parent.keys[leftIndex];
+        const bool leaf = left.isLeaf();
+
+        if (left.keys.size() + right.keys.size() + (leaf ? 0 : 1) <= MAX_KEYS)
+        {
+            if (!leaf)
+                left.keys.push_back(std::move(separator));
+            left.keys.insert(left.keys.end(), std::make_move_iterator(right.keys.begin()), std::make_move_iterator(right.keys.end()));
+            left.children.insert(left.children.end(), std::make_move_iterator(right.children.begin()), std::make_move_iterator(right.children.end()));
+            parent.keys.erase(parent.keys.begin() + static_cast<std::ptrdiff_t>(leftIndex));
+            parent.children.erase(parent.children.begin() + static_cast<std::ptrdiff_t>(leftIndex) + 1);
+            --m_nodeCount;
+            return;
+        }
+
+        if (child == leftIndex)
+        {
+            // Borrow the smallest entry of the right sibling.
+            if (leaf)
+            {
+                left.keys.push_back(std::move(right.keys.front()));
+                right.keys.erase(right.keys.begin());
+                separator = right.keys.front();
+            }
+            else
+            {
+                left.keys.push_back(std::move(separator));
+                left.children.push_back(std::move(right.children.front()));
+                separator = std::move(right.keys.front());
+                right.keys.erase(right.keys.begin());
+                right.children.erase(right.children.begin());
+            }
+        }
+        else
+        {
+            // Borrow the largest entry of the left sibling.
+            if (leaf)
+            {
+                right.keys.insert(right.keys.begin(), std::move(left.keys.back()));
+                left.keys.pop_back();
+                separator = right.keys.front();
+            }
+            else
+            {
+                right.keys.insert(right.keys.begin(), std::move(separator));
+                right.children.insert(right.children.begin(), std::move(left.children.back()));
+                separator = std::move(left.keys.back());
+                left.keys.pop_back();
+                left.children.pop_back();
+            }
+        }
+    }
+}
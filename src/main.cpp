@@ -1,11 +1,20 @@
 #include "app/TaskManager.h"
+#include "app/TaskDirectoryWatcher.h"
+#include "app/BatchRunner.h"
+#include "errorhandling/ErrorHandler.h"
 #include "utils/Symbols.h"
 #include <iostream>
 #include <filesystem>
 #include <string>
 #include <map>
 #include <functional>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <csignal>
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 namespace fs = std::filesystem;
 using namespace Symbols;
@@ -16,13 +25,68 @@ void showMenu()
             << SYMBOL_OPTION << " 1. Run tasks from files\n"
             << SYMBOL_OPTION << " 2. Show task directory path\n"
             << SYMBOL_OPTION << " 3. Update task directory path\n"
-            << SYMBOL_OPTION << " 4. Exit\n"
+            << SYMBOL_OPTION << " 4. Compile task files\n"
+            << SYMBOL_OPTION << " 5. Watch task directory\n"
+            << SYMBOL_OPTION << " 6. Exit\n"
             << "Select an option: ";
         }
 
-int main()
+namespace
 {
+    std::atomic<bool> g_stopRequested{false};
+
+    void requestStop(int)
+    {
+        g_stopRequested = true;
+    }
+}
+
+int runHeadless(const std::vector<std::string>& arguments)
+{
+    App::BatchOptions options;
+    try
+    {
+        options = App::BatchRunner::ParseArguments(arguments);
+    }
+    catch (const ErrorHandling::Exceptions::BaseException& e)
+    {
+        std::cerr << "❌ " << e.GetCommandLine() << ": " << e.GetFailureReason() << "\n\n";
+        App::BatchRunner::PrintUsage(std::cerr);
+        return App::BatchRunner::EXIT_USAGE_ERROR;
+    }
+
+    if (options.help)
+    {
+        App::BatchRunner::PrintUsage(std::cout);
+        return EXIT_SUCCESS;
+    }
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+    App::BatchRunner runner(options);
+    int exitCode = runner.Run(g_stopRequested);
+    App::BatchRunner::PrintSummary(std::cerr, runner.GetSummary());
+    return exitCode;
+}
+
+int main(int argc, char* argv[])
+{
+#ifdef _WIN32
     SetConsoleOutputCP(CP_UTF8);
+#endif
+    if (argc > 1)
+    {
+        try
+        {
+            return runHeadless(std::vector<std::string>(argv + 1, argv + argc));
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "❌ Error al cargar tareas: " << e.what() << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
     try
     {
         std::string relativePath = "../tasks";
@@ -61,6 +125,26 @@ int main()
                 }
             }},
             {'4', [&]() {
+                std::cout << "🛠️ Compiling task files...\n";
+                auto compiled = taskMan->CompileTaskFiles();
+                std::cout << "✅ " << compiled << " task file(s) compiled.\n";
+            }},
+            {'5', [&]() {
+                App::TaskDirectoryWatcher watcher(*taskMan, tasksPath);
+                if (!watcher.Start()) {
+                    std::cout << "❌ Cannot watch: " << tasksPath << "\n";
+                    return;
+                }
+                std::cout << "👀 Watching " << tasksPath << " (press Enter to stop)...\n";
+                std::atomic<bool> stopRequested{false};
+                std::thread watchThread([&]() { watcher.Run(stopRequested); });
+                std::string ignored;
+                std::getline(std::cin, ignored);
+                stopRequested = true;
+                watchThread.join();
+                std::cout << "✅ " << watcher.GetReports().size() << " task file(s) applied while watching.\n";
+            }},
+            {'6', [&]() {
                 std::cout << "👋 Exiting program...\n";
                 running = false;
             }}
@@ -0,0 +1,55 @@
+#include "utils/AllocationTracker.h"
+
+// Replaces the global allocation functions only in targets built with USER_MGMT_TRACK_ALLOCATIONS.
+#ifdef USER_MGMT_TRACK_ALLOCATIONS
+
+#include <cstdlib>
+#include <new>
+
+using Utils::AllocationTracker;
+
+namespace
+{
+    void* Allocate(std::size_t size)
+    {
+        void* pointer = std::malloc(size ? size : 1);
+        if (!pointer)
+            throw std::bad_alloc();
+        AllocationTracker::RecordAllocation(size);
+        return pointer;
+    }
+
+    void* AllocateAligned(std::size_t size, std::align_val_t alignment)
+    {
+        const auto align = static_cast<std::size_t>(alignment);
+        void* pointer = std::aligned_alloc(align, (size + align - 1) / align * align);
+        if (!pointer)
+            throw std::bad_alloc();
+        AllocationTracker::RecordAllocation(size);
+        return pointer;
+    }
+
+    void Deallocate(void* pointer) noexcept
+    {
+        if (!pointer)
+            return;
+        AllocationTracker::RecordDeallocation();
+        std::free(pointer);
+    }
+}
+
+void* operator new(std::size_t size) { return Allocate(size); }
+void* operator new[](std::size_t size) { return Allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+
+void operator delete(void* pointer) noexcept { Deallocate(pointer); }
+void operator delete[](void* pointer) noexcept { Deallocate(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { Deallocate(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { Deallocate(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { Deallocate(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { Deallocate(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { Deallocate(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { Deallocate(pointer); }
+
+#endif
@@ -0,0 +1,214 @@
+#include "utils/AllocationTracker.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace Utils
+{
+    namespace
+    {
+        constexpr size_t PHASE_COUNT = static_cast<size_t>(AllocationPhase::Count);
+
+        struct AtomicCounters
+        {
+            std::atomic<uint64_t> allocations{0};
+            std::atomic<uint64_t> bytes{0};
+            std::atomic<uint64_t> deallocations{0};
+        };
+
+        // Only the owning thread writes its counters, so a relaxed load/store pair is enough
+        // and avoids a locked instruction on every allocation.
+        void Bump(std::atomic<uint64_t>& counter, uint64_t value)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        void AddTo(AllocationCounters& total, const AtomicCounters& counters)
+        {
+            total.allocations += counters.allocations.load(std::memory_order_relaxed);
+            total.bytes += counters.bytes.load(std::memory_order_relaxed);
+            total.deallocations += counters.deallocations.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Counters of one thread, linked into a global list so Snapshot can read them.
+         * The list is intrusive because registering must not allocate.
+         */
+        struct ThreadCounters
+        {
+            ThreadCounters();
+            ~ThreadCounters();
+
+            AllocationPhase phase = AllocationPhase::Other;
+            size_t commandType = AllocationTracker::NO_COMMAND_TYPE;
+            std::array<AtomicCounters, PHASE_COUNT> phases;
+            std::array<AtomicCounters, AllocationReport::MAX_COMMAND_TYPES> commandTypes;
+            ThreadCounters* previous = nullptr;
+            ThreadCounters* next = nullptr;
+        };
+
+        constinit std::mutex g_registryMutex;
+        constinit ThreadCounters* g_threads = nullptr;
+        constinit AllocationReport g_exitedThreads{};
+        thread_local bool t_countersDestroyed = false;
+
+        ThreadCounters::ThreadCounters()
+        {
+            std::lock_guard lock(g_registryMutex);
+            next = g_threads;
+            if (g_threads)
+                g_threads->previous = this;
+            g_threads = this;
+        }
+
+        ThreadCounters::~ThreadCounters()
+        {
+            std::lock_guard lock(g_registryMutex);
+            for (size_t i = 0; i < PHASE_COUNT; ++i)
+                AddTo(g_exitedThreads.phases[i], phases[i]);
+            for (size_t i = 0; i < commandTypes.size(); ++i)
+                AddTo(g_exitedThreads.commandTypes[i], commandTypes[i]);
+
+            if (previous)
+                previous->next = next;
+            else
+                g_threads = next;
+            if (next)
+                next->previous = previous;
+            t_countersDestroyed = true;
+        }
+
+        ThreadCounters* Local()
+        {
+            if (t_countersDestroyed)
+                return nullptr;
+            thread_local ThreadCounters counters;
+            return &counters;
+        }
+    }
+    /**
+     * @brief Sums the counters of every phase.
+     */
+    AllocationCounters AllocationReport::Total() const
+    {
+        AllocationCounters total;
+        for (const auto& phase : phases)
+        {
+            total.allocations += phase.allocations;
+            total.bytes += phase.bytes;
+            total.deallocations += phase.deallocations;
+        }
+        return total;
+    }
+    /**
+     * @brief Gets what was counted between an earlier snapshot and this one.
+     */
+    AllocationReport AllocationReport::operator-(const AllocationReport& earlier) const
+    {
+        auto subtract = [](const AllocationCounters& later, const AllocationCounters& before)
+        {
+            return AllocationCounters{later.allocations - before.allocations, later.bytes - before.bytes,
+                                      later.deallocations - before.deallocations};
+        };
+
+        AllocationReport difference;
+        for (size_t i = 0; i < phases.size(); ++i)
+            difference.phases[i] = subtract(phases[i], earlier.phases[i]);
+        for (size_t i = 0; i < commandTypes.size(); ++i)
+            difference.commandTypes[i] = subtract(commandTypes[i], earlier.commandTypes[i]);
+        return difference;
+    }
+    /**
+     * @brief Sums the counters of every live and finished thread. Reports are cumulative since
+     * process start; subtract two snapshots to measure a section.
+     */
+    AllocationReport AllocationTracker::Snapshot()
+    {
+        std::lock_guard lock(g_registryMutex);
+        AllocationReport report = g_exitedThreads;
+        for (const ThreadCounters* thread = g_threads; thread; thread = thread->next)
+        {
+            for (size_t i = 0; i < PHASE_COUNT; ++i)
+                AddTo(report.phases[i], thread->phases[i]);
+            for (size_t i = 0; i < thread->commandTypes.size(); ++i)
+                AddTo(report.commandTypes[i], thread->commandTypes[i]);
+        }
+        return report;
+    }
+    /**
+     * @brief Gets the display name of a phase.
+     */
+    const char* AllocationTracker::PhaseName(AllocationPhase phase)
+    {
+        switch (phase)
+        {
+            case AllocationPhase::Load:          return "load";
+            case AllocationPhase::Parse:         return "parse";
+            case AllocationPhase::CreateCommand: return "create-command";
+            case AllocationPhase::Execute:       return "execute";
+            case AllocationPhase::Print:         return "print";
+            default:                             return "other";
+        }
+    }
+    /**
+     * @brief Sets the phase of the current thread.
+     * @return The previous phase, to restore it afterwards.
+     */
+    AllocationPhase AllocationTracker::SetPhase(AllocationPhase phase)
+    {
+        ThreadCounters* counters = Local();
+        if (!counters)
+            return AllocationPhase::Other;
+
+        AllocationPhase previous = counters->phase;
+        counters->phase = phase;
+        return previous;
+    }
+    /**
+     * @brief Sets the command type of the current thread (e.g. CommandRecord::index()).
+     * @param commandType Below AllocationReport::MAX_COMMAND_TYPES, or NO_COMMAND_TYPE.
+     * @return The previous command type, to restore it afterwards.
+     */
+    size_t AllocationTracker::SetCommandType(size_t commandType)
+    {
+        ThreadCounters* counters = Local();
+        if (!counters)
+            return NO_COMMAND_TYPE;
+
+        size_t previous = counters->commandType;
+        counters->commandType = commandType;
+        return previous;
+    }
+    /**
+     * @brief Counts one allocation of the current thread. Called by the operator new hooks.
+     */
+    void AllocationTracker::RecordAllocation(size_t bytes)
+    {
+        ThreadCounters* counters = Local();
+        if (!counters)
+            return;
+
+        auto& phase = counters->phases[static_cast<size_t>(counters->phase)];
+        Bump(phase.allocations, 1);
+        Bump(phase.bytes, bytes);
+        if (counters->commandType < AllocationReport::MAX_COMMAND_TYPES)
+        {
+            auto& command = counters->commandTypes[counters->commandType];
+            Bump(command.allocations, 1);
+            Bump(command.bytes, bytes);
+        }
+    }
+    /**
+     * @brief Counts one deallocation of the current thread. Called by the operator delete hooks.
+     */
+    void AllocationTracker::RecordDeallocation()
+    {
+        ThreadCounters* counters = Local();
+        if (!counters)
+            return;
+
+        Bump(counters->phases[static_cast<size_t>(counters->phase)].deallocations, 1);
+        if (counters->commandType < AllocationReport::MAX_COMMAND_TYPES)
+            Bump(counters->commandTypes[counters->commandType].deallocations, 1);
+    }
+}
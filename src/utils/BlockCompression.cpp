@@ -0,0 +1,38 @@
+#include "utils/BlockCompression.h"
+
+#include <lz4.h>
+
+#include <limits>
+#include <stdexcept>
+
+namespace Utils
+{
+    std::vector<uint8_t> CompressBlock(std::string_view input)
+    {
+        if (input.size() > LZ4_MAX_INPUT_SIZE)
+            throw std::runtime_error("Block too large to compress");
+
+        const int inputSize = static_cast<int>(input.size());
+        std::vector<uint8_t> out(static_cast<size_t>(LZ4_compressBound(inputSize)));
+        const int written = LZ4_compress_default(input.data(), reinterpret_cast<char*>(out.data()), inputSize, static_cast<int>(out.size()));
+        if (written <= 0)
+            throw std::runtime_error("Block compression failed");
+        out.resize(static_cast<size_t>(written));
+        out.shrink_to_fit();
+        return out;
+    }
+
+    std::string DecompressBlock(std::span<const uint8_t> input, size_t originalSize)
+    {
+        constexpr size_t MAX_SIZE = std::numeric_limits<int>::max();
+        if (input.size() > MAX_SIZE || originalSize > MAX_SIZE)
+            throw std::runtime_error("Corrupt compressed block");
+
+        std::string out(originalSize, '\0');
+        const int restored = LZ4_decompress_safe(reinterpret_cast<const char*>(input.data()), out.data(),
+                                                 static_cast<int>(input.size()), static_cast<int>(originalSize));
+        if (restored < 0 || static_cast<size_t>(restored) != originalSize)
+            throw std::runtime_error("Corrupt compressed block");
+        return out;
+    }
+}
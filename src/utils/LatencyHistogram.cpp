@@ -0,0 +1,114 @@
+#include "utils/LatencyHistogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace Utils
+{
+    /**
+     * @brief Gets the bucket a value falls in.
+     * @param nanoseconds The value; values beyond the last bucket are clamped into it.
+     */
+    size_t LatencyHistogram::BucketIndex(uint64_t nanoseconds)
+    {
+        if (nanoseconds < SUB_BUCKETS)
+            return static_cast<size_t>(nanoseconds);
+
+        const unsigned shift = static_cast<unsigned>(std::bit_width(nanoseconds)) - 1 - SUB_BUCKET_BITS;
+        if (shift > MAX_SHIFT)
+            return BUCKET_COUNT - 1;
+
+        const uint64_t subBucket = (nanoseconds >> shift) - SUB_BUCKETS;
+        return static_cast<size_t>(SUB_BUCKETS + shift * SUB_BUCKETS + subBucket);
+    }
+    /**
+     * @brief Gets the largest value that falls in a bucket.
+     */
+    uint64_t LatencyHistogram::BucketUpperBound(size_t index)
+    {
+        if (index < SUB_BUCKETS)
+            return index;
+
+        const uint64_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+        const uint64_t subBucket = (index - SUB_BUCKETS) % SUB_BUCKETS;
+        return ((SUB_BUCKETS + subBucket + 1) << shift) - 1;
+    }
+    /**
+     * @brief Records one latency.
+     */
+    void LatencyHistogram::Record(uint64_t nanoseconds)
+    {
+        ++m_buckets[BucketIndex(nanoseconds)];
+        ++m_count;
+        m_max = std::max(m_max, nanoseconds);
+    }
+    /**
+     * @brief Records one latency.
+     */
+    void LatencyHistogram::Record(std::chrono::nanoseconds latency)
+    {
+        Record(static_cast<uint64_t>(std::max<std::chrono::nanoseconds::rep>(latency.count(), 0)));
+    }
+    /**
+     * @brief Adds the values recorded by another histogram.
+     */
+    void LatencyHistogram::Merge(const LatencyHistogram& other)
+    {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i)
+            m_buckets[i] += other.m_buckets[i];
+        m_count += other.m_count;
+        m_max = std::max(m_max, other.m_max);
+    }
+    /**
+     * @brief Forgets every recorded value.
+     */
+    void LatencyHistogram::Reset()
+    {
+        m_buckets.fill(0);
+        m_count = 0;
+        m_max = 0;
+    }
+    /**
+     * @brief Gets the number of recorded values.
+     */
+    uint64_t LatencyHistogram::Count() const
+    {
+        return m_count;
+    }
+    /**
+     * @brief Gets the largest recorded value (exact, not bucketed).
+     */
+    uint64_t LatencyHistogram::Max() const
+    {
+        return m_max;
+    }
+    /**
+     * @brief Gets the value below which the given share of the recorded values fall.
+     * @param percentile Between 0 and 100.
+     * @return The upper bound of the bucket holding that rank (never above Max), or 0 if empty.
+     */
+    uint64_t LatencyHistogram::Percentile(double percentile) const
+    {
+        if (m_count == 0)
+            return 0;
+
+        const double clamped = std::clamp(percentile, 0.0, 100.0);
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(m_count))));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i)
+        {
+            seen += m_buckets[i];
+            if (seen >= rank)
+                return std::min(BucketUpperBound(i), m_max);
+        }
+        return m_max;
+    }
+    /**
+     * @brief Gets count, p50, p90, p99 and max.
+     */
+    LatencySummary LatencyHistogram::Summarize() const
+    {
+        return {m_count, Percentile(50), Percentile(90), Percentile(99), m_max};
+    }
+}
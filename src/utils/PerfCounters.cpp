@@ -0,0 +1,191 @@
+#include "utils/PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Utils
+{
+    namespace
+    {
+#ifdef __linux__
+        int OpenCounter(PerfEvent event)
+        {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            switch (event)
+            {
+                case PerfEvent::Cycles:       attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+                case PerfEvent::Instructions: attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+                case PerfEvent::CacheMisses:  attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+                default:                      attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+            }
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            const long descriptor = syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+            return static_cast<int>(descriptor);
+        }
+
+        // Scales the value up when the kernel multiplexed the counter with others.
+        bool ReadCounter(int descriptor, uint64_t& value)
+        {
+            uint64_t data[3] = {};
+            if (read(descriptor, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)))
+                return false;
+
+            const uint64_t enabled = data[1];
+            const uint64_t running = data[2];
+            if (running == 0)
+                value = 0;
+            else if (running < enabled)
+                value = static_cast<uint64_t>(static_cast<double>(data[0]) * static_cast<double>(enabled) / static_cast<double>(running));
+            else
+                value = data[0];
+            return true;
+        }
+#endif
+    }
+    /**
+     * @brief Tells whether at least one counter is available.
+     */
+    bool PerfCounts::Any() const
+    {
+        for (bool counter : available)
+        {
+            if (counter)
+                return true;
+        }
+        return false;
+    }
+    /**
+     * @brief Gets instructions per cycle, or 0 if either counter is missing.
+     */
+    double PerfCounts::InstructionsPerCycle() const
+    {
+        if (!Has(PerfEvent::Cycles) || !Has(PerfEvent::Instructions) || (*this)[PerfEvent::Cycles] == 0)
+            return 0.0;
+        return static_cast<double>((*this)[PerfEvent::Instructions]) / static_cast<double>((*this)[PerfEvent::Cycles]);
+    }
+    /**
+     * @brief Gets what was counted between an earlier reading and this one.
+     */
+    PerfCounts PerfCounts::operator-(const PerfCounts& earlier) const
+    {
+        PerfCounts difference;
+        for (size_t i = 0; i < EVENT_COUNT; ++i)
+        {
+            difference.available[i] = available[i] && earlier.available[i];
+            difference.values[i] = difference.available[i] && values[i] > earlier.values[i] ? values[i] - earlier.values[i] : 0;
+        }
+        return difference;
+    }
+    /**
+     * @brief Accumulates another measurement; a counter is available if either side has it.
+     */
+    PerfCounts& PerfCounts::operator+=(const PerfCounts& other)
+    {
+        for (size_t i = 0; i < EVENT_COUNT; ++i)
+        {
+            values[i] += other.values[i];
+            available[i] = available[i] || other.available[i];
+        }
+        return *this;
+    }
+    /**
+     * @brief Accumulates the counters of every phase.
+     */
+    PerfReport& PerfReport::operator+=(const PerfReport& other)
+    {
+        for (size_t i = 0; i < phases.size(); ++i)
+            phases[i] += other.phases[i];
+        return *this;
+    }
+    /**
+     * @brief Opens every counter for the calling thread (user space only).
+     */
+    PerfCounterGroup::PerfCounterGroup()
+    {
+        m_descriptors.fill(-1);
+#ifdef __linux__
+        for (size_t i = 0; i < m_descriptors.size(); ++i)
+            m_descriptors[i] = OpenCounter(static_cast<PerfEvent>(i));
+#endif
+    }
+
+    PerfCounterGroup::~PerfCounterGroup()
+    {
+#ifdef __linux__
+        for (int descriptor : m_descriptors)
+        {
+            if (descriptor >= 0)
+                close(descriptor);
+        }
+#endif
+    }
+    /**
+     * @brief Tells whether at least one counter could be opened.
+     */
+    bool PerfCounterGroup::IsAvailable() const
+    {
+        for (int descriptor : m_descriptors)
+        {
+            if (descriptor >= 0)
+                return true;
+        }
+        return false;
+    }
+    /**
+     * @brief Reads the cumulative counters of the thread that opened them.
+     */
+    PerfCounts PerfCounterGroup::Read() const
+    {
+        PerfCounts counts;
+#ifdef __linux__
+        for (size_t i = 0; i < m_descriptors.size(); ++i)
+        {
+            if (m_descriptors[i] >= 0)
+                counts.available[i] = ReadCounter(m_descriptors[i], counts.values[i]);
+        }
+#endif
+        return counts;
+    }
+    /**
+     * @brief Gets the counters of the calling thread, opened on first use and closed when the thread exits.
+     */
+    PerfCounterGroup& PerfCounterGroup::ForCurrentThread()
+    {
+        thread_local PerfCounterGroup counters;
+        return counters;
+    }
+    /**
+     * @brief Gets the display name of a counter.
+     */
+    const char* PerfCounterGroup::EventName(PerfEvent event)
+    {
+        switch (event)
+        {
+            case PerfEvent::Cycles:       return "cycles";
+            case PerfEvent::Instructions: return "instructions";
+            case PerfEvent::CacheMisses:  return "cache-misses";
+            default:                      return "branch-misses";
+        }
+    }
+    /**
+     * @brief Gets the display name of a phase.
+     */
+    const char* PerfCounterGroup::PhaseName(PerfPhase phase)
+    {
+        switch (phase)
+        {
+            case PerfPhase::Load:  return "load";
+            case PerfPhase::Parse: return "parse";
+            default:               return "execute";
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#include "utils/ProcessStats.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#include <fstream>
+#endif
+
+namespace Utils
+{
+    /**
+     * @brief Gets the peak resident set size of the process.
+     * @return The peak RSS in bytes, or 0 where it cannot be measured.
+     */
+    size_t PeakResidentBytes()
+    {
+#if defined(__linux__) || defined(__APPLE__)
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+#if defined(__APPLE__)
+        return static_cast<size_t>(usage.ru_maxrss);
+#else
+        return static_cast<size_t>(usage.ru_maxrss) * 1024u;
+#endif
+#else
+        return 0;
+#endif
+    }
+    /**
+     * @brief Gets the current resident set size of the process.
+     * @return The RSS in bytes, or 0 where it cannot be measured.
+     */
+    size_t CurrentResidentBytes()
+    {
+#if defined(__linux__)
+        std::ifstream statm("/proc/self/statm");
+        size_t totalPages = 0;
+        size_t residentPages = 0;
+        if (!(statm >> totalPages >> residentPages))
+            return 0;
+        return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+        return 0;
+#endif
+    }
+}
@@ -0,0 +1,260 @@
+#include "utils/Tracer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Utils
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+        constexpr size_t DETAIL_CAPACITY = 48;
+        constexpr size_t CHUNK_EVENTS = 1024;
+
+        struct TraceEvent
+        {
+            const char* name;
+            const char* category;
+            int64_t startNs;
+            int64_t durationNs;
+            std::array<char, DETAIL_CAPACITY> detail;
+        };
+
+        struct Chunk
+        {
+            std::array<TraceEvent, CHUNK_EVENTS> events;
+            std::atomic<size_t> count{0};
+            std::atomic<Chunk*> next{nullptr};
+        };
+
+        /**
+         * @brief Events of one thread. Only the owning thread appends; readers follow the
+         * published counts and links with acquire loads.
+         */
+        struct ThreadBuffer
+        {
+            explicit ThreadBuffer(uint32_t threadId) : id(threadId), head(std::make_unique<Chunk>()), tail(head.get()) {}
+            ~ThreadBuffer() { Truncate(); }
+
+            void Truncate()
+            {
+                Chunk* chunk = head->next.exchange(nullptr);
+                while (chunk)
+                {
+                    Chunk* next = chunk->next.load();
+                    delete chunk;
+                    chunk = next;
+                }
+                head->count.store(0);
+                tail = head.get();
+                recorded = 0;
+            }
+
+            uint32_t id;
+            std::unique_ptr<Chunk> head;
+            Chunk* tail;
+            size_t recorded = 0;
+            bool inUse = false; ///< Guarded by g_registryMutex.
+        };
+
+        std::mutex g_registryMutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+        std::atomic<size_t> g_maxEventsPerThread{Tracer::DEFAULT_MAX_EVENTS_PER_THREAD};
+        std::atomic<size_t> g_dropped{0};
+        Clock::time_point g_epoch = Clock::now();
+
+        /**
+         * @brief Holds a buffer for the lifetime of a thread. A thread takes the buffer of a thread
+         * that exited, if any, and keeps appending to it, so there are as many buffers as threads
+         * ever alive at once, however many worker pools come and go. Events already recorded stay
+         * until the next Start.
+         */
+        class BufferLease
+        {
+            public:
+                BufferLease()
+                {
+                    std::lock_guard lock(g_registryMutex);
+                    auto free = std::find_if(g_buffers.begin(), g_buffers.end(), [](const auto& buffer) { return !buffer->inUse; });
+                    if (free == g_buffers.end())
+                    {
+                        g_buffers.push_back(std::make_unique<ThreadBuffer>(static_cast<uint32_t>(g_buffers.size() + 1)));
+                        free = std::prev(g_buffers.end());
+                    }
+                    m_buffer = free->get();
+                    m_buffer->inUse = true;
+                }
+                ~BufferLease()
+                {
+                    std::lock_guard lock(g_registryMutex);
+                    m_buffer->inUse = false;
+                }
+                BufferLease(const BufferLease&) = delete;
+                BufferLease& operator=(const BufferLease&) = delete;
+
+                ThreadBuffer& Get() const { return *m_buffer; }
+
+            private:
+                ThreadBuffer* m_buffer;
+        };
+
+        ThreadBuffer& LocalBuffer()
+        {
+            thread_local BufferLease lease;
+            return lease.Get();
+        }
+
+        template <typename Visit>
+        void ForEachEvent(const ThreadBuffer& buffer, Visit&& visit)
+        {
+            for (const Chunk* chunk = buffer.head.get(); chunk; chunk = chunk->next.load(std::memory_order_acquire))
+            {
+                const size_t count = chunk->count.load(std::memory_order_acquire);
+                for (size_t i = 0; i < count; ++i)
+                    visit(chunk->events[i]);
+            }
+        }
+
+        void WriteJsonString(std::ostream& out, std::string_view value)
+        {
+            out << '"';
+            for (char c : value)
+            {
+                if (c == '"' || c == '\\')
+                    out << '\\' << c;
+                else if (static_cast<unsigned char>(c) >= 0x20)
+                    out << c;
+            }
+            out << '"';
+        }
+    }
+    /**
+     * @brief Discards previous events and starts recording.
+     * @param maxEventsPerThread Events kept per thread; later ones are counted as dropped.
+     */
+    void Tracer::Start(size_t maxEventsPerThread)
+    {
+        {
+            std::lock_guard lock(g_registryMutex);
+            for (auto& buffer : g_buffers)
+                buffer->Truncate();
+        }
+        g_maxEventsPerThread = maxEventsPerThread;
+        g_dropped = 0;
+        g_epoch = Clock::now();
+        s_enabled.store(true, std::memory_order_release);
+    }
+    /**
+     * @brief Stops recording; recorded events are kept until the next Start.
+     */
+    void Tracer::Stop()
+    {
+        s_enabled.store(false, std::memory_order_release);
+    }
+    /**
+     * @brief Appends a complete event to the calling thread's buffer.
+     */
+    void Tracer::Record(const char* name, const char* category, std::string_view detail,
+                        Clock::time_point start, Clock::time_point end)
+    {
+        ThreadBuffer& buffer = LocalBuffer();
+        if (buffer.recorded >= g_maxEventsPerThread.load(std::memory_order_relaxed))
+        {
+            g_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        Chunk* chunk = buffer.tail;
+        size_t index = chunk->count.load(std::memory_order_relaxed);
+        if (index == CHUNK_EVENTS)
+        {
+            auto* next = new Chunk();
+            chunk->next.store(next, std::memory_order_release);
+            buffer.tail = chunk = next;
+            index = 0;
+        }
+
+        TraceEvent& event = chunk->events[index];
+        event.name = name;
+        event.category = category;
+        event.startNs = std::chrono::duration_cast<std::chrono::nanoseconds>(start - g_epoch).count();
+        event.durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        const size_t length = std::min(detail.size(), DETAIL_CAPACITY - 1);
+        std::memcpy(event.detail.data(), detail.data(), length);
+        event.detail[length] = '\0';
+
+        chunk->count.store(index + 1, std::memory_order_release);
+        ++buffer.recorded;
+    }
+    /**
+     * @brief Gets the number of events recorded since Start, over every thread.
+     */
+    size_t Tracer::EventCount()
+    {
+        std::lock_guard lock(g_registryMutex);
+        size_t count = 0;
+        for (const auto& buffer : g_buffers)
+            ForEachEvent(*buffer, [&](const TraceEvent&) { ++count; });
+        return count;
+    }
+    /**
+     * @brief Gets the number of events dropped because a thread reached its limit.
+     */
+    size_t Tracer::DroppedEvents()
+    {
+        return g_dropped.load();
+    }
+    /**
+     * @brief Writes every recorded event in Chrome trace-event JSON format.
+     */
+    void Tracer::WriteChromeTrace(std::ostream& out)
+    {
+        std::lock_guard lock(g_registryMutex);
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        for (const auto& buffer : g_buffers)
+        {
+            out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+                << ",\"args\":{\"name\":\"" << (buffer->id == 1 ? "main" : "worker-" + std::to_string(buffer->id)) << "\"}}";
+            first = false;
+
+            ForEachEvent(*buffer, [&](const TraceEvent& event)
+            {
+                out << ",\n{\"name\":";
+                WriteJsonString(out, event.name);
+                out << ",\"cat\":";
+                WriteJsonString(out, event.category);
+                out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id
+                    << ",\"ts\":" << event.startNs / 1000 << '.' << std::to_string(1000 + event.startNs % 1000).substr(1)
+                    << ",\"dur\":" << event.durationNs / 1000 << '.' << std::to_string(1000 + event.durationNs % 1000).substr(1);
+                if (event.detail[0] != '\0')
+                {
+                    out << ",\"args\":{\"detail\":";
+                    WriteJsonString(out, event.detail.data());
+                    out << '}';
+                }
+                out << '}';
+            });
+        }
+        out << "\n]}\n";
+    }
+    /**
+     * @brief Writes every recorded event to a file.
+     * @return false if the file cannot be written.
+     */
+    bool Tracer::WriteChromeTrace(const std::string_view& path)
+    {
+        std::ofstream out{std::string(path), std::ios::binary | std::ios::trunc};
+        if (!out)
+            return false;
+        WriteChromeTrace(out);
+        return static_cast<bool>(out);
+    }
+}
@@ -0,0 +1,385 @@
+#include "workload/WorkloadGenerator.h"
+#include "utils/CommandStrings.h"
+#include "utils/Hash.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace Workload
+{
+    namespace
+    {
+        /**
+         * @brief SplitMix64 generator: tiny, fast and identical on every platform (unlike std:: distributions).
+         */
+        class Random
+        {
+            public:
+                explicit Random(uint64_t seed) : m_state(seed) {}
+
+                uint64_t Next()
+                {
+                    uint64_t z = (m_state += 0x9e3779b97f4a7c15ull);
+                    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+                    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+                    return z ^ (z >> 31);
+                }
+                double Uniform() { return static_cast<double>(Next() >> 11) * 0x1.0p-53; }
+                bool Chance(double probability) { return probability > 0 && Uniform() < probability; }
+                size_t Below(size_t bound) { return bound ? static_cast<size_t>(Next() % bound) : 0; }
+
+            private:
+                uint64_t m_state;
+        };
+
+        constexpr std::array<const char*, 24> WORDS = {
+            "hello", "meeting", "at", "noon", "please", "review", "the", "report", "deploy", "finished",
+            "lunch", "today", "thanks", "for", "update", "server", "restart", "scheduled", "tomorrow",
+            "ok", "see", "you", "ticket", "closed"};
+
+        enum class Kind { CreateUser, DeleteUser, DisableUser, SendMessage, AddUserToGroup, RemoveUserFromGroup,
+                          Ping, GetMessageHistory, GetUsers, GetGroups };
+
+        uint64_t MembershipKey(size_t user, size_t group)
+        {
+            return (static_cast<uint64_t>(user) << 32) | static_cast<uint64_t>(group);
+        }
+
+        std::string MessageBody(Random& random, const WorkloadSpec& spec)
+        {
+            const double mean = static_cast<double>(std::max<size_t>(spec.meanMessageLength, 1));
+            const size_t target = std::clamp<size_t>(static_cast<size_t>(-mean * std::log(1.0 - random.Uniform())) + 1,
+                                                     1, std::max<size_t>(spec.maxMessageLength, 1));
+            const bool quoted = random.Chance(spec.quotedMessageDensity);
+
+            std::string body;
+            while (body.size() < target)
+            {
+                if (!body.empty())
+                    body += quoted ? ' ' : '_';
+                body += WORDS[random.Below(WORDS.size())];
+            }
+            body.resize(target);
+            if (!quoted)
+                return body;
+
+            return "\"" + body + "\"";
+        }
+    }
+    /**
+     * @brief Builds the cumulative distribution of a Zipf law over n ranks.
+     * @param n Number of ranks (at least 1).
+     * @param exponent Skew; 0 is uniform, 1 is the classic Zipf law.
+     */
+    ZipfDistribution::ZipfDistribution(size_t n, double exponent)
+    {
+        m_cdf.reserve(std::max<size_t>(n, 1));
+        double total = 0;
+        for (size_t rank = 0; rank < std::max<size_t>(n, 1); ++rank)
+        {
+            total += 1.0 / std::pow(static_cast<double>(rank + 1), exponent);
+            m_cdf.push_back(total);
+        }
+        for (auto& value : m_cdf)
+            value /= total;
+    }
+    /**
+     * @brief Maps 64 random bits to a rank.
+     */
+    size_t ZipfDistribution::operator()(uint64_t randomBits) const
+    {
+        const double u = static_cast<double>(randomBits >> 11) * 0x1.0p-53;
+        auto itr = std::upper_bound(m_cdf.begin(), m_cdf.end(), u);
+        return std::min<size_t>(static_cast<size_t>(itr - m_cdf.begin()), m_cdf.size() - 1);
+    }
+    /**
+     * @brief Gets the number of ranks.
+     */
+    size_t ZipfDistribution::size() const
+    {
+        return m_cdf.size();
+    }
+    /**
+     * @brief Constructs a generator for the given workload shape.
+     * @throws std::invalid_argument If there are no users or groups, or the command mix is empty.
+     */
+    WorkloadGenerator::WorkloadGenerator(WorkloadSpec spec)
+        : m_spec(std::move(spec)),
+          m_userPopularity(m_spec.users, m_spec.userZipfExponent),
+          m_groupPopularity(m_spec.groups, m_spec.groupZipfExponent)
+    {
+        if (m_spec.users == 0 || m_spec.groups == 0)
+            throw std::invalid_argument("A workload needs at least one user and one group");
+
+        const CommandMix& mix = m_spec.mix;
+        const std::array<double, 10> weights = {mix.createUser, mix.deleteUser, mix.disableUser, mix.sendMessage,
+                                                mix.addUserToGroup, mix.removeUserFromGroup, mix.ping,
+                                                mix.getMessageHistory, mix.getUsers, mix.getGroups};
+        double total = 0;
+        for (double weight : weights)
+        {
+            total += std::max(weight, 0.0);
+            m_mixCdf.push_back(total);
+        }
+        if (total <= 0)
+            throw std::invalid_argument("The command mix has no positive weight");
+        for (auto& value : m_mixCdf)
+            value /= total;
+    }
+    /**
+     * @brief Gets the name of the n-th file of the directory (0 is the bootstrap file).
+     */
+    std::string WorkloadGenerator::FileName(size_t fileIndex)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "task_%06zu.txt", fileIndex);
+        return name;
+    }
+    /**
+     * @brief Gets the name of a bootstrap user. Popularity decreases with the id.
+     */
+    std::string WorkloadGenerator::UserName(size_t userId)
+    {
+        return "user" + std::to_string(userId);
+    }
+    /**
+     * @brief Gets the name of a group. Size decreases with the id.
+     */
+    std::string WorkloadGenerator::GroupName(size_t groupId)
+    {
+        return "group" + std::to_string(groupId);
+    }
+    /**
+     * @brief Writes the bootstrap file and every command file into a directory, replacing files with the same names.
+     *
+     * Files are streamed line by line, so directories much larger than memory can be generated.
+     * @return The totals of the generated workload.
+     * @throws std::runtime_error If a file cannot be written.
+     */
+    WorkloadStats WorkloadGenerator::WriteDirectory(const fs::path& directory)
+    {
+        fs::create_directories(directory);
+        for (size_t fileIndex = 0; fileIndex <= m_spec.files; ++fileIndex)
+        {
+            const fs::path path = directory / FileName(fileIndex);
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out)
+                throw std::runtime_error("Cannot write " + path.string());
+
+            GenerateInto(fileIndex, [&](const std::string& line) { out << line << '\n'; });
+            if (!out)
+                throw std::runtime_error("Cannot write " + path.string());
+        }
+        return m_stats;
+    }
+    /**
+     * @brief Generates the lines of one file in memory. Files must be generated in order starting at 0.
+     * @param fileIndex 0 for the bootstrap file, 1..files for the command files.
+     */
+    std::vector<std::string> WorkloadGenerator::GenerateFile(size_t fileIndex)
+    {
+        std::vector<std::string> lines;
+        GenerateInto(fileIndex, [&](const std::string& line) { lines.push_back(line); });
+        return lines;
+    }
+    /**
+     * @brief Gets the spec the generator was built with.
+     */
+    const WorkloadSpec& WorkloadGenerator::GetSpec() const
+    {
+        return m_spec;
+    }
+    /**
+     * @brief Gets the totals of the files generated so far.
+     */
+    const WorkloadStats& WorkloadGenerator::GetStats() const
+    {
+        return m_stats;
+    }
+
+    template <typename Emit>
+    void WorkloadGenerator::GenerateInto(size_t fileIndex, Emit&& emit)
+    {
+        auto counted = [&](const std::string& line)
+        {
+            ++m_stats.lines;
+            m_stats.bytes += line.size() + 1;
+            emit(line);
+        };
+
+        if (fileIndex == 0)
+        {
+            m_stats = {};
+            m_memberships.clear();
+            GenerateBootstrap(counted);
+        }
+        else
+        {
+            GenerateCommands(fileIndex, counted);
+        }
+        ++m_stats.files;
+    }
+    /**
+     * @brief Creates every user, then gives each of them `groupsPerUser` groups drawn from the group
+     * popularity, so group sizes follow the same Zipf law.
+     */
+    template <typename Emit>
+    void WorkloadGenerator::GenerateBootstrap(Emit&& emit)
+    {
+        using namespace CMD;
+        Random random(Utils::Fnv1a64("bootstrap", m_spec.seed));
+        emit("# Bootstrap: " + std::to_string(m_spec.users) + " users, " + std::to_string(m_spec.groups) + " groups");
+
+        for (size_t user = 0; user < m_spec.users; ++user)
+        {
+            emit(std::string(CMD_CREATE_USER) + " " + UserName(user));
+            ++m_stats.commands;
+        }
+
+        const size_t groupsPerUser = std::min(m_spec.groupsPerUser, m_spec.groups);
+        for (size_t user = 0; user < m_spec.users; ++user)
+        {
+            for (size_t joined = 0, attempts = 0; joined < groupsPerUser && attempts < groupsPerUser * 8; ++attempts)
+            {
+                const size_t group = m_groupPopularity(random.Next());
+                if (!m_memberships.insert(MembershipKey(user, group)).second)
+                    continue;
+
+                emit("ADD USER " + UserName(user) + " TO GROUP " + GroupName(group));
+                ++m_stats.commands;
+                ++joined;
+            }
+        }
+    }
+    /**
+     * @brief Writes `linesPerFile` lines drawn from the command mix.
+     *
+     * Deletes and disables only target users created earlier in the same file, and removals only
+     * target memberships added earlier in the same file, so a file runs without errors unless a
+     * failure is injected. An injected failure is the last line of its file: running it stops the
+     * file, so the users and memberships tracked as applied are exactly those of the lines run.
+     */
+    template <typename Emit>
+    void WorkloadGenerator::GenerateCommands(size_t fileIndex, Emit&& emit)
+    {
+        using namespace CMD;
+        Random random(Utils::Fnv1a64(std::to_string(fileIndex), m_spec.seed));
+        std::vector<std::string> freshUsers;
+        std::vector<uint64_t> addedMemberships;
+        size_t freshCount = 0;
+
+        auto popularUser = [&]() { return UserName(m_userPopularity(random.Next())); };
+        auto createFresh = [&]()
+        {
+            freshUsers.push_back("f" + std::to_string(fileIndex) + "_" + std::to_string(freshCount++));
+            return std::string(CMD_CREATE_USER) + " " + freshUsers.back();
+        };
+        auto takeFresh = [&]()
+        {
+            const size_t index = random.Below(freshUsers.size());
+            std::string name = std::move(freshUsers[index]);
+            freshUsers[index] = std::move(freshUsers.back());
+            freshUsers.pop_back();
+            return name;
+        };
+        auto addMembership = [&]() -> std::string
+        {
+            for (int attempt = 0; attempt < 4; ++attempt)
+            {
+                const size_t user = m_userPopularity(random.Next());
+                const size_t group = m_groupPopularity(random.Next());
+                if (!m_memberships.insert(MembershipKey(user, group)).second)
+                    continue;
+
+                addedMemberships.push_back(MembershipKey(user, group));
+                return "ADD USER " + UserName(user) + " TO GROUP " + GroupName(group);
+            }
+            return std::string(CMD_GET_MESSAGE_HISTORY) + " " + popularUser();
+        };
+
+        for (size_t lineIndex = 0; lineIndex < m_spec.linesPerFile; ++lineIndex)
+        {
+            if (random.Chance(m_spec.commentLineDensity))
+            {
+                emit("# step " + std::to_string(lineIndex) + ": " + WORDS[random.Below(WORDS.size())]);
+                continue;
+            }
+
+            std::string line;
+            if (random.Chance(m_spec.failureRate))
+            {
+                ++m_stats.injectedFailures;
+                ++m_stats.commands;
+                emit(random.Below(2) ? std::string(CMD_SEND_MESSAGE) + " ghost" + std::to_string(lineIndex) + " \"lost\""
+                                     : std::string(CMD_CREATE_USER) + " " + popularUser());
+                return;
+            }
+            else
+            {
+                const double pick = random.Uniform();
+                const auto kind = static_cast<Kind>(std::min<size_t>(
+                    static_cast<size_t>(std::upper_bound(m_mixCdf.begin(), m_mixCdf.end(), pick) - m_mixCdf.begin()),
+                    m_mixCdf.size() - 1));
+
+                switch (kind)
+                {
+                    case Kind::CreateUser:
+                        line = createFresh();
+                        break;
+                    case Kind::DeleteUser:
+                        line = freshUsers.empty() ? createFresh() : std::string(CMD_DELETE_USER) + " " + takeFresh();
+                        break;
+                    case Kind::DisableUser:
+                        line = freshUsers.empty() ? createFresh() : std::string(CMD_DISABLE_USER) + " " + takeFresh();
+                        break;
+                    case Kind::SendMessage:
+                        line = std::string(CMD_SEND_MESSAGE) + " " + popularUser() + " " + MessageBody(random, m_spec);
+                        break;
+                    case Kind::AddUserToGroup:
+                        line = addMembership();
+                        break;
+                    case Kind::RemoveUserFromGroup:
+                        if (addedMemberships.empty())
+                        {
+                            line = addMembership();
+                            break;
+                        }
+                        else
+                        {
+                            const size_t index = random.Below(addedMemberships.size());
+                            const uint64_t key = addedMemberships[index];
+                            addedMemberships[index] = addedMemberships.back();
+                            addedMemberships.pop_back();
+                            m_memberships.erase(key);
+                            line = "REMOVE USER " + UserName(key >> 32) + " FROM GROUP " + GroupName(key & 0xffffffffu);
+                        }
+                        break;
+                    case Kind::Ping:
+                        line = std::string(CMD_PING) + " " + popularUser() + " " + std::to_string(1 + random.Below(3));
+                        break;
+                    case Kind::GetMessageHistory:
+                        line = std::string(CMD_GET_MESSAGE_HISTORY) + " " + popularUser();
+                        break;
+                    case Kind::GetUsers:
+                        line = CMD_GET_USERS;
+                        break;
+                    case Kind::GetGroups:
+                        line = CMD_GET_GROUPS;
+                        break;
+                }
+            }
+
+            if (random.Chance(m_spec.trailingCommentDensity))
+                line += " # " + std::string(WORDS[random.Below(WORDS.size())]);
+
+            emit(line);
+            ++m_stats.commands;
+        }
+    }
+}
@@ -29,7 +29,7 @@ TEST(CommandRegistryTest, CanParseMultipleCommandsFromSingleTaskFile)
     EXPECT_EQ(parsedTasks[0].first, "Tasks_test");
 
 
-    const TasksTypes::CommandList& commandsInFile = parsedTasks[0].second;
+    const auto& commandsInFile = parsedTasks[0].second.commands;
 
 
     ASSERT_EQ(commandsInFile.size(), 3);
@@ -53,4 +53,48 @@ TEST(CommandRegistryTest, TaskFailsIfAnyCommandFails)
     auto parsedTasks = m_parser->ParseTasks("Tasks_test_with_error", lines);
 
     ASSERT_EQ(parsedTasks.size(), 0);
-}
\ No newline at end of file
+}
+
+TEST(CommandRegistryTest, ParseProgramStoresBuiltinCommandsByValue)
+{
+    App::CommandRegistry registry;
+    App::TasksParser parser(registry);
+    std::vector<std::string> lines = {
+        "CREATE USER alice",
+        "SEND MESSAGE alice \"Hello, alice!\""
+    };
+
+    auto parsed = parser.ParseProgram("Tasks_test", lines);
+
+    ASSERT_EQ(parsed.size(), 1);
+    const auto& program = parsed[0].second.records;
+    ASSERT_EQ(program.size(), 2);
+    EXPECT_TRUE(std::holds_alternative<Commands::CreateUserCommand>(program[0]));
+    EXPECT_TRUE(std::holds_alternative<Commands::SendMessageCommand>(program[1]));
+}
+
+TEST(CommandRegistryTest, ExtensionCommandsKeepUsingICommand)
+{
+    class CountingCommand : public Commands::ICommand
+    {
+        public:
+            explicit CountingCommand(int& counter) : m_counter(counter) {}
+            void execute(Domain::SystemState&) override { ++m_counter; }
+        private:
+            int& m_counter;
+    };
+
+    int executed = 0;
+    App::CommandRegistry registry;
+    registry.registerCommand("COUNT", [&executed](App::CommandArgs)
+                {
+                    return std::make_unique<CountingCommand>(executed);
+                });
+
+    auto record = registry.createRecord("COUNT", {});
+    ASSERT_TRUE(std::holds_alternative<std::unique_ptr<Commands::ICommand>>(record));
+
+    Domain::SystemState state;
+    Commands::ExecuteRecord(record, state);
+    EXPECT_EQ(executed, 1);
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include "app/BatchRunner.h"
+#include "app/TaskManager.h"
+#include "errorhandling/exceptions/InvalidArgumentException.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace App;
+using namespace ErrorHandling::Exceptions;
+namespace fs = std::filesystem;
+
+namespace
+{
+    fs::path MakeTaskDirectory(const std::string& name, size_t files)
+    {
+        auto dir = fs::temp_directory_path() / name;
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        for (size_t i = 0; i < files; ++i)
+        {
+            std::ofstream out(dir / ("task" + std::to_string(i) + ".txt"));
+            out << "CREATE USER user" << i << "\n"
+                << "CREATE USER friend" << i << "\n"
+                << "ADD USER user" << i << " TO GROUP group" << i << "\n";
+        }
+        return dir;
+    }
+}
+
+TEST(BatchRunnerTest, ParsesOptions)
+{
+    auto options = BatchRunner::ParseArguments({"--tasks", "dir", "--output", "null", "--threads", "4",
+                                                "--repeat", "3", "--no-cache", "--compile", "--trace", "run.json", "--verbose-ping",
+                                                "--atomic-files", "--index-messages", "--compress-messages", "--retain-messages", "100",
+                                                "--retain-bytes", "4096"});
+    EXPECT_EQ(options.tasksPath, "dir");
+    EXPECT_EQ(options.tracePath, "run.json");
+    EXPECT_TRUE(options.verbosePing);
+    EXPECT_TRUE(options.atomicFiles);
+    EXPECT_TRUE(options.indexMessages);
+    EXPECT_TRUE(options.compressMessages);
+    EXPECT_EQ(options.retainMessages, 100u);
+    EXPECT_EQ(options.retainBytes, 4096u);
+    EXPECT_EQ(options.output, "null");
+    EXPECT_EQ(options.threads, 4u);
+    EXPECT_EQ(options.repeat, 3u);
+    EXPECT_FALSE(options.useCache);
+    EXPECT_TRUE(options.compile);
+    EXPECT_FALSE(options.watch);
+}
+
+TEST(BatchRunnerTest, RejectsInvalidOptions)
+{
+    EXPECT_THROW(BatchRunner::ParseArguments({"--threads", "0"}), InvalidArgumentException);
+    EXPECT_THROW(BatchRunner::ParseArguments({"--repeat", "-2"}), InvalidArgumentException);
+    EXPECT_THROW(BatchRunner::ParseArguments({"--repeat", "3x"}), InvalidArgumentException);
+    EXPECT_THROW(BatchRunner::ParseArguments({"--tasks"}), InvalidArgumentException);
+    EXPECT_THROW(BatchRunner::ParseArguments({"--verbose"}), InvalidArgumentException);
+}
+
+TEST(BatchRunnerTest, RunsEveryRepetitionOnAFreshState)
+{
+    auto dir = MakeTaskDirectory("umts_batch", 5);
+    BatchOptions options;
+    options.tasksPath = dir.string();
+    options.output = "null";
+    options.threads = 3;
+    options.repeat = 2;
+
+    BatchRunner runner(options);
+    std::atomic<bool> stop{false};
+    EXPECT_EQ(runner.Run(stop), EXIT_SUCCESS);
+    EXPECT_EQ(runner.GetSummary().files, 10u);
+    EXPECT_EQ(runner.GetSummary().failedFiles, 0u);
+    EXPECT_EQ(runner.GetSummary().commands, 30u);
+
+    options.tasksPath = (dir / "missing").string();
+    EXPECT_EQ(BatchRunner(options).Run(stop), BatchRunner::EXIT_USAGE_ERROR);
+    fs::remove_all(dir);
+}
+
+TEST(BatchRunnerTest, ParallelPreparationKeepsDirectoryOrder)
+{
+    auto dir = MakeTaskDirectory("umts_batch_order", 8);
+    {
+        std::ofstream out(dir / "task3.txt", std::ios::app);
+        out << "UNKNOWN COMMAND\n";
+    }
+
+    auto runWith = [&](unsigned threads)
+    {
+        std::stringstream output;
+        auto* original = std::cout.rdbuf(output.rdbuf());
+        TaskManager manager(dir.string());
+        manager.SetState(std::make_shared<Domain::SystemState>());
+        manager.SetWorkerThreads(threads);
+        manager.RunTasksFromFiles();
+        std::cout.rdbuf(original);
+        EXPECT_EQ(manager.GetLastRunStats().failedFiles, 1u);
+        return output.str();
+    };
+
+    EXPECT_EQ(runWith(1), runWith(4));
+    fs::remove_all(dir);
+}
+
+TEST(BatchRunnerTest, AtomicFilesUndoTheFailedFile)
+{
+    auto dir = MakeTaskDirectory("umts_batch_atomic", 2);
+    {
+        std::ofstream out(dir / "task1.txt", std::ios::app);
+        out << "SEND MESSAGE user1 \"hi\"\n"
+            << "DELETE USER nobody\n";
+    }
+
+    auto runWith = [&](bool atomic)
+    {
+        auto state = std::make_shared<Domain::SystemState>();
+        std::stringstream output;
+        auto* original = std::cout.rdbuf(output.rdbuf());
+        TaskManager manager(dir.string());
+        manager.SetState(state);
+        manager.SetAtomicFiles(atomic);
+        manager.RunTasksFromFiles();
+        std::cout.rdbuf(original);
+        EXPECT_EQ(manager.GetLastRunStats().failedFiles, 1u);
+        EXPECT_EQ(manager.GetLastRunStats().rolledBackFiles, atomic ? 1u : 0u);
+        return state;
+    };
+
+    auto partial = runWith(false);
+    EXPECT_TRUE(partial->isUserExists("user1"));
+    EXPECT_EQ(partial->getGroups().size(), 2u);
+
+    auto atomic = runWith(true);
+    EXPECT_TRUE(atomic->isUserExists("user0"));
+    EXPECT_FALSE(atomic->isUserExists("user1"));
+    EXPECT_FALSE(atomic->isUserExists("friend1"));
+    EXPECT_EQ(atomic->getGroups().size(), 1u);
+    EXPECT_EQ(atomic->Snapshot()->GetUserCount(), 2u);
+    fs::remove_all(dir);
+}
+
+TEST(BatchRunnerTest, AtomicFilesFreeTrimmedMessages)
+{
+    auto dir = MakeTaskDirectory("umts_batch_atomic_retention", 4);
+    for (size_t file = 0; file < 4; ++file)
+    {
+        std::ofstream out(dir / ("task" + std::to_string(file) + ".txt"), std::ios::app);
+        for (size_t i = 0; i < 1000; ++i)
+            out << "SEND MESSAGE user" << file << " \"message " << i << "\"\n";
+    }
+
+    auto state = std::make_shared<Domain::SystemState>();
+    state->SetMessageIndexEnabled(true);
+    state->SetRetentionPolicy({100, 0});
+    std::stringstream output;
+    auto* original = std::cout.rdbuf(output.rdbuf());
+    TaskManager manager(dir.string());
+    manager.SetState(state);
+    manager.SetAtomicFiles(true);
+    manager.RunTasksFromFiles();
+    std::cout.rdbuf(original);
+
+    EXPECT_EQ(manager.GetLastRunStats().failedFiles, 0u);
+    for (const auto& user : state->getUsers())
+    {
+        EXPECT_LE(user->getMessages().size() - user->getMessages().FirstIndex(), 100u);
+        EXPECT_LE(user->getMessages().StorageBytes(), 8192u);
+    }
+    EXPECT_LE(state->GetMessageIndex()->GetDocumentCount(), 800u);
+    fs::remove_all(dir);
+}
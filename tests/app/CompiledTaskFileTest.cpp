@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "app/CompiledTaskFormat.h"
+#include "app/CommandRegistry.h"
+#include "app/TaskFileCompiler.h"
+#include "app/TaskFileLoader.h"
+#include "app/TasksParser.h"
+#include "domain/SystemState.h"
+#include "errorhandling/exceptions/AllExceptions.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace App;
+using namespace ErrorHandling::Exceptions;
+namespace fs = std::filesystem;
+
+namespace
+{
+    fs::path MakeTaskDirectory(const std::string& name)
+    {
+        auto dir = fs::temp_directory_path() / name;
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        return dir;
+    }
+
+    void WriteFile(const fs::path& path, const std::string& content)
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << content;
+    }
+
+    TasksTypes::CompiledCommands ToCommands(const TasksTypes::CompiledTasks& compiled)
+    {
+        TasksTypes::CompiledCommands commands;
+        for (const auto& command : compiled.commands)
+        {
+            const auto args = compiled.Arguments(command);
+            commands.emplace_back(std::string(compiled.Name(command)), std::vector<std::string>(args.begin(), args.end()));
+        }
+        return commands;
+    }
+}
+
+TEST(CompiledTaskFormatTest, RoundTripsCommandsAndChecksum)
+{
+    TasksTypes::CompiledCommands commands = {
+        {"CREATE USER", {"alice"}},
+        {"SEND MESSAGE", {"alice", "hello alice"}},
+        {"GET USERS", {}},
+        {"CREATE USER", {"bob"}}
+    };
+
+    auto bytes = CompiledTaskFormat::Serialize(commands, 42);
+    auto compiled = CompiledTaskFormat::Deserialize(bytes);
+
+    EXPECT_EQ(compiled.sourceChecksum, 42u);
+    EXPECT_EQ(ToCommands(compiled), commands);
+    EXPECT_EQ(compiled.strings.size(), 6u);
+    for (auto arg : compiled.arguments)
+    {
+        EXPECT_GE(arg.data(), bytes.data());
+        EXPECT_LE(arg.data() + arg.size(), bytes.data() + bytes.size());
+    }
+}
+
+TEST(CompiledTaskFormatTest, ProgramsOutliveTheCompiledBytes)
+{
+    auto bytes = CompiledTaskFormat::Serialize({{"CREATE USER", {"alice"}}, {"SEND MESSAGE", {"alice", "hello alice"}}}, 0);
+    CommandRegistry registry;
+    TasksTypes::CommandProgram program;
+    {
+        auto compiled = CompiledTaskFormat::Deserialize(bytes);
+        program = TasksParser(registry).CreateProgram(compiled);
+    }
+    bytes.assign(bytes.size(), '\0');
+
+    auto state = std::make_shared<Domain::SystemState>();
+    for (auto& record : program.records)
+        Commands::ExecuteRecord(record, *state);
+    ASSERT_TRUE(state->isUserExists("alice"));
+    EXPECT_EQ(program.arguments->GetBytes(), std::string_view("CREATE USERaliceSEND MESSAGEhello alice").size());
+}
+
+TEST(CompiledTaskFormatTest, RejectsTruncatedFiles)
+{
+    auto bytes = CompiledTaskFormat::Serialize({{"CREATE USER", {"alice"}}}, 7);
+    bytes.pop_back();
+
+    EXPECT_THROW(CompiledTaskFormat::Deserialize(bytes), CommandExecutionException);
+    EXPECT_THROW(CompiledTaskFormat::Deserialize("not a compiled file"), CommandExecutionException);
+}
+
+TEST(TaskFileCompilerTest, LoaderUsesCompiledFileWhenSourceIsUnchanged)
+{
+    auto dir = MakeTaskDirectory("umts_compiled_fresh");
+    WriteFile(dir / "task.txt", "# comment\nCREATE USER alice\nSEND MESSAGE alice \"hi there\" # note\n");
+
+    CommandRegistry registry;
+    ASSERT_EQ(TaskFileCompiler(registry).CompileDirectory(dir.string()), 1u);
+    ASSERT_TRUE(fs::exists(dir / "task.umtb"));
+
+    auto sources = TaskFileLoader(dir.string()).LoadAllSources();
+    ASSERT_EQ(sources.size(), 1u);
+    EXPECT_EQ(sources[0].fileName, "task.txt");
+    ASSERT_TRUE(sources[0].compiled.has_value());
+    EXPECT_TRUE(sources[0].lines.empty());
+    const auto commands = ToCommands(*sources[0].compiled);
+    ASSERT_EQ(commands.size(), 2u);
+    EXPECT_EQ(commands[1].second, (std::vector<std::string>{"alice", "hi there"}));
+
+    fs::remove_all(dir);
+}
+
+TEST(TaskFileCompilerTest, LoaderFallsBackToTextWhenSourceChanged)
+{
+    auto dir = MakeTaskDirectory("umts_compiled_stale");
+    WriteFile(dir / "task.txt", "CREATE USER alice\n");
+
+    CommandRegistry registry;
+    ASSERT_TRUE(TaskFileCompiler(registry).CompileFile(dir / "task.txt"));
+    WriteFile(dir / "task.txt", "CREATE USER bob\n");
+
+    auto sources = TaskFileLoader(dir.string()).LoadAllSources();
+    ASSERT_EQ(sources.size(), 1u);
+    EXPECT_FALSE(sources[0].compiled.has_value());
+    ASSERT_TRUE(sources[0].arena);
+    auto moved = std::move(sources[0]);
+    EXPECT_EQ(std::vector<std::string_view>(moved.lines.begin(), moved.lines.end()), (std::vector<std::string_view>{"CREATE USER bob"}));
+
+    fs::remove_all(dir);
+}
+
+TEST(TaskFileCompilerTest, InvalidFilesAreNotCompiled)
+{
+    auto dir = MakeTaskDirectory("umts_compiled_invalid");
+    WriteFile(dir / "task.txt", "CREATE USER alice\nTHIS IS NOT A COMMAND\n");
+
+    CommandRegistry registry;
+    EXPECT_FALSE(TaskFileCompiler(registry).CompileFile(dir / "task.txt"));
+    EXPECT_FALSE(fs::exists(dir / "task.umtb"));
+
+    fs::remove_all(dir);
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "app/TaskDirectoryWatcher.h"
+
+#include <filesystem>
+#include <fstream>
+
+#ifdef __linux__
+
+using namespace App;
+namespace fs = std::filesystem;
+
+namespace
+{
+    void WriteTask(const fs::path& path, const std::string& content)
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << content;
+    }
+}
+
+TEST(TaskDirectoryWatcherTest, ExecutesNewFilesOnceAndSkipsTheOnesAlreadyRun)
+{
+    auto dir = fs::temp_directory_path() / "umts_watch";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    WriteTask(dir / "existing.txt", "CREATE USER bob\n");
+
+    std::stringstream output;
+    auto* original = std::cout.rdbuf(output.rdbuf());
+
+    auto state = std::make_shared<Domain::SystemState>();
+    TaskManager manager(dir.string());
+    manager.SetState(state);
+    TaskDirectoryWatcher watcher(manager, dir.string());
+    ASSERT_TRUE(watcher.Start());
+    manager.RunTasksFromFiles();
+    watcher.MarkProcessed(manager.GetLastRunFiles());
+    state->DeleteUser("bob");
+
+    WriteTask(dir / "existing.txt", "CREATE USER bob\n");
+    WriteTask(dir / "new.txt", "CREATE USER alice\n");
+    WriteTask(dir / "notes.md", "CREATE USER carol\n");
+    size_t processed = 0;
+    for (int attempt = 0; attempt < 10 && processed == 0; ++attempt)
+        processed = watcher.PollOnce(100);
+
+    WriteTask(dir / "new.txt", "CREATE USER alice\n");
+    watcher.PollOnce(100);
+
+    std::cout.rdbuf(original);
+
+    EXPECT_EQ(processed, 1u);
+    EXPECT_TRUE(state->isUserExists("alice"));
+    EXPECT_FALSE(state->isUserExists("bob"));
+    EXPECT_FALSE(state->isUserExists("carol"));
+    ASSERT_EQ(watcher.GetReports().size(), 1u);
+    EXPECT_EQ(watcher.GetReports()[0].fileName, "new.txt");
+    EXPECT_EQ(watcher.GetReports()[0].stats.commands, 1u);
+    EXPECT_NE(output.str().find("[Watch: new.txt applied"), std::string::npos);
+
+    fs::remove_all(dir);
+}
+
+TEST(TaskDirectoryWatcherTest, ExecutesFilesThatArriveBeforeTheFirstRunIsMarked)
+{
+    auto dir = fs::temp_directory_path() / "umts_watch_late";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    std::stringstream output;
+    auto* original = std::cout.rdbuf(output.rdbuf());
+
+    auto state = std::make_shared<Domain::SystemState>();
+    TaskManager manager(dir.string());
+    manager.SetState(state);
+    TaskDirectoryWatcher watcher(manager, dir.string());
+    ASSERT_TRUE(watcher.Start());
+    manager.RunTasksFromFiles();
+    WriteTask(dir / "late.txt", "CREATE USER dave\n");
+    watcher.MarkProcessed(manager.GetLastRunFiles());
+
+    size_t processed = 0;
+    for (int attempt = 0; attempt < 10 && processed == 0; ++attempt)
+        processed = watcher.PollOnce(100);
+
+    std::cout.rdbuf(original);
+
+    EXPECT_EQ(processed, 1u);
+    EXPECT_TRUE(state->isUserExists("dave"));
+
+    fs::remove_all(dir);
+}
+
+#endif
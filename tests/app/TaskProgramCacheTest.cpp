@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "app/TaskManager.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace App;
+namespace fs = std::filesystem;
+
+namespace
+{
+    class TaskProgramCacheTest : public ::testing::Test
+    {
+        protected:
+            void SetUp() override
+            {
+                m_dir = fs::temp_directory_path() / "umts_program_cache";
+                fs::remove_all(m_dir);
+                fs::create_directories(m_dir);
+                WriteTask("a.txt", "PING alice 1\n");
+                WriteTask("b.txt", "PING bob 1\n");
+
+                m_original = std::cout.rdbuf(m_output.rdbuf());
+                m_manager = std::make_unique<TaskManager>(m_dir.string());
+                m_manager->SetState(std::make_shared<Domain::SystemState>());
+            }
+
+            void TearDown() override
+            {
+                std::cout.rdbuf(m_original);
+                fs::remove_all(m_dir);
+            }
+
+            void WriteTask(const std::string& name, const std::string& content)
+            {
+                std::ofstream out(m_dir / name, std::ios::binary);
+                out << content;
+            }
+
+            fs::path m_dir;
+            std::stringstream m_output;
+            std::streambuf* m_original = nullptr;
+            std::unique_ptr<TaskManager> m_manager;
+    };
+}
+
+TEST_F(TaskProgramCacheTest, SecondRunReusesParsedPrograms)
+{
+    m_manager->RunTasksFromFiles();
+    auto first = m_manager->GetProgramCacheStats();
+    EXPECT_EQ(first.entries, 2u);
+    EXPECT_EQ(first.misses, 2u);
+    EXPECT_EQ(first.hits, 0u);
+    EXPECT_GT(first.bytes, 0u);
+
+    m_manager->RunTasksFromFiles();
+    auto second = m_manager->GetProgramCacheStats();
+    EXPECT_EQ(second.hits, 2u);
+    EXPECT_EQ(second.misses, 2u);
+}
+
+TEST_F(TaskProgramCacheTest, ChangedFilesAreParsedAgain)
+{
+    m_manager->RunTasksFromFiles();
+    WriteTask("b.txt", "PING bob 2\nPING carol 1\n");
+    fs::last_write_time(m_dir / "b.txt", fs::last_write_time(m_dir / "b.txt") + std::chrono::seconds(5));
+
+    m_manager->RunTasksFromFiles();
+    auto stats = m_manager->GetProgramCacheStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_NE(m_output.str().find("carol"), std::string::npos);
+}
+
+TEST_F(TaskProgramCacheTest, DeletedFilesAreDroppedAndZeroCapacityDisablesCaching)
+{
+    m_manager->RunTasksFromFiles();
+    fs::remove(m_dir / "a.txt");
+    m_manager->RunTasksFromFiles();
+    EXPECT_EQ(m_manager->GetProgramCacheStats().entries, 1u);
+
+    m_manager->SetProgramCacheCapacity(0);
+    auto stats = m_manager->GetProgramCacheStats();
+    EXPECT_EQ(stats.entries, 0u);
+    EXPECT_EQ(stats.bytes, 0u);
+
+    m_manager->RunTasksFromFiles();
+    EXPECT_EQ(m_manager->GetProgramCacheStats().entries, 0u);
+}
@@ -4,10 +4,14 @@
 #include "commands/DelateUserCommand.h"
 #include "commands/DisableUserCommand.h"
 #include "commands/GetGroupsCommand.h"
+#include "commands/GetPingStatsCommand.h"
+#include "commands/GetStatsCommand.h"
 #include "commands/GetUsersCommand.h"
 #include "commands/PingCommand.h"
 #include "commands/RemoveUserFromGroupCommand.h"
+#include "commands/SearchMessagesCommand.h"
 #include "commands/SendMessageCommand.h"
+#include "commands/SendGroupMessageCommand.h"
 #include "domain/SystemState.h"
 #include "domain/User.h"
 #include "domain/Group.h"
@@ -97,7 +101,43 @@ TEST(SendMessageCommandTest, SendsMessageSuccessfully)
 
     const auto& messages = user->getMessages();
     ASSERT_EQ(messages.size(), 1);
-    EXPECT_EQ(messages[0]->getContent(), "Hello there!");
+    EXPECT_EQ(messages[0].getContent(), "Hello there!");
+}
+
+TEST(SendGroupMessageCommandTest, SharesOneBodyAcrossEnabledMembers)
+{
+    SystemState state;
+    for (const char* name : {"alice", "bob", "carol"})
+    {
+        state.AddUser(std::make_shared<User>(name));
+        state.AddUserToGroup(name, "team");
+    }
+    state.DisableUser("carol");
+
+    SendGroupMessageCommand cmd("team", "Standup moved to 10:30 because of the all-hands meeting");
+    cmd.execute(state);
+
+    const auto& alice = state.getMessageHistory("alice");
+    const auto& bob = state.getMessageHistory("bob");
+    ASSERT_EQ(alice.size(), 1u);
+    ASSERT_EQ(bob.size(), 1u);
+    EXPECT_TRUE(state.getMessageHistory("carol").empty());
+    EXPECT_EQ(alice[0].getContent(), "Standup moved to 10:30 because of the all-hands meeting");
+    EXPECT_EQ(alice[0].getBody(), bob[0].getBody());
+}
+
+TEST(SendGroupMessageCommandTest, SkipsDeletedMembersAndThrowsForUnknownGroup)
+{
+    SystemState state;
+    state.AddUser(std::make_shared<User>("alice"));
+    state.AddUser(std::make_shared<User>("bob"));
+    state.AddUserToGroup("alice", "team");
+    state.AddUserToGroup("bob", "team");
+    state.DeleteUser("bob");
+
+    EXPECT_EQ(state.SendMessageToGroup("team", Message("hi")), 1u);
+    SendGroupMessageCommand cmd("ghosts", "hi");
+    EXPECT_THROW(cmd.execute(state), CommandExecutionException);
 }
 
 TEST(SendMessageCommandTest, ThrowsIfUserDoesNotExist)
@@ -285,6 +325,62 @@ TEST(GetUsersCommandTest, PrintsUserListToOutput)
     EXPECT_NE(output.find("bob"), std::string::npos);
 }
 
+TEST(GetUsersCommandTest, ListsInOrderByPrefixAndByPage)
+{
+    SystemState state;
+    for (const char* name : {"carol", "alice", "albert", "bob", "alfred", "dave"})
+        state.AddUser(std::make_shared<User>(name));
+    state.DeleteUser("bob");
+
+    auto run = [&](GetUsersCommand cmd)
+    {
+        std::stringstream buffer;
+        std::streambuf* original_cout = std::cout.rdbuf(buffer.rdbuf());
+        cmd.execute(state);
+        std::cout.rdbuf(original_cout);
+
+        std::vector<std::string> names;
+        std::string line;
+        std::getline(buffer, line);
+        while (std::getline(buffer, line))
+            names.push_back(line.substr(line.find_first_not_of(' ')));
+        return names;
+    };
+
+    using Names = std::vector<std::string>;
+    EXPECT_EQ(run(GetUsersCommand()), (Names{"albert", "alfred", "alice", "carol", "dave"}));
+    EXPECT_EQ(run(GetUsersCommand(UserQuery::Prefix, "al")), (Names{"albert", "alfred", "alice"}));
+    EXPECT_EQ(run(GetUsersCommand(UserQuery::Prefix, "al", "2")), (Names{"albert", "alfred"}));
+    EXPECT_EQ(run(GetUsersCommand(UserQuery::Prefix, "zed")), Names{});
+    EXPECT_EQ(run(GetUsersCommand(UserQuery::After, "alfred", "2")), (Names{"alice", "carol"}));
+    EXPECT_EQ(run(GetUsersCommand(UserQuery::After, "bob")), (Names{"carol", "dave"}));
+    EXPECT_THROW(GetUsersCommand(UserQuery::After, "bob", "0"), InvalidArgumentException);
+    EXPECT_THROW(GetUsersCommand(UserQuery::After, "bob", "ten"), InvalidArgumentException);
+}
+
+TEST(SearchMessagesCommandTest, PrintsEveryMatchingMessage)
+{
+    SystemState state;
+    state.SetMessageIndexEnabled(true);
+    state.AddUser(std::make_shared<User>("alice"));
+    state.AddUser(std::make_shared<User>("bob"));
+    state.SendMessage("alice", Message("Quarterly report is due"));
+    state.SendMessage("bob", Message("Report the outage"));
+    state.SendMessage("bob", Message("lunch?"));
+
+    std::stringstream buffer;
+    std::streambuf* original_cout = std::cout.rdbuf(buffer.rdbuf());
+    SearchMessagesCommand cmd("report");
+    cmd.execute(state);
+    std::cout.rdbuf(original_cout);
+
+    const std::string output = buffer.str();
+    EXPECT_NE(output.find("SEARCH MESSAGES \"report\" (2 found)"), std::string::npos);
+    EXPECT_NE(output.find("alice: Quarterly report is due"), std::string::npos);
+    EXPECT_NE(output.find("bob: Report the outage"), std::string::npos);
+    EXPECT_EQ(output.find("lunch"), std::string::npos);
+}
+
 TEST(GetGroupsCommandTest, PrintsAllGroups)
 {
     SystemState state;
@@ -331,8 +427,10 @@ TEST(PingCommandTest, PrintsCorrectlyToExistingUser)
     std::streambuf* original = std::cout.rdbuf();
     std::cout.rdbuf(buffer.rdbuf());
 
+    PingCommand::SetOutputMode(PingOutputMode::Verbose);
     PingCommand cmd("javi", "2");
     cmd.execute(state);
+    PingCommand::SetOutputMode(PingOutputMode::Summary);
 
     std::cout.rdbuf(original);
 
@@ -350,8 +448,10 @@ TEST(PingCommandTest, PrintsCorrectlyToNonExistentUser)
     std::streambuf* original = std::cout.rdbuf();
     std::cout.rdbuf(buffer.rdbuf());
 
+    PingCommand::SetOutputMode(PingOutputMode::Verbose);
     PingCommand cmd("ghost", "3");
     cmd.execute(state);
+    PingCommand::SetOutputMode(PingOutputMode::Summary);
 
     std::cout.rdbuf(original);
 
@@ -364,4 +464,84 @@ TEST(PingCommandTest, PrintsCorrectlyToNonExistentUser)
 TEST(PingCommandTest, ThrowsWhenArgumentIsInvalid)
 {
     EXPECT_THROW(PingCommand("javi", "invalid"), InvalidArgumentException);
+    EXPECT_THROW(PingCommand("javi", "-1"), InvalidArgumentException);
+    EXPECT_THROW(PingCommand("javi", "3x"), InvalidArgumentException);
+    EXPECT_THROW(PingCommand("javi", ""), InvalidArgumentException);
+    EXPECT_THROW(PingCommand("javi", "99999999999999999999999"), InvalidArgumentException);
+}
+
+TEST(PingCommandTest, PrintsOneSummaryLineAndCountsPings)
+{
+    SystemState state;
+    state.AddUser(std::make_shared<User>("javi"));
+
+    std::stringstream buffer;
+    std::streambuf* original = std::cout.rdbuf();
+    std::cout.rdbuf(buffer.rdbuf());
+
+    PingCommand("javi", "1000000").execute(state);
+    PingCommand("javi", "2").execute(state);
+    PingCommand("ghost", "3").execute(state);
+
+    std::cout.rdbuf(original);
+
+    std::string output = buffer.str();
+    EXPECT_EQ(std::count(output.begin(), output.end(), '\n'), 6);
+    EXPECT_NE(output.find("javi received 2 pings (1000002 in total)"), std::string::npos);
+    EXPECT_NE(output.find("Sent 3 pings to ghost, user does not exist"), std::string::npos);
+
+    const auto stats = state.GetPingStats();
+    EXPECT_EQ(stats.pingsSent, 1000005u);
+    EXPECT_EQ(stats.pingsToUnknownUsers, 3u);
+    ASSERT_EQ(stats.receivedByUser.size(), 1u);
+    EXPECT_EQ(stats.receivedByUser[0], std::make_pair(std::string("javi"), uint64_t{1000002}));
+}
+
+TEST(GetPingStatsCommandTest, PrintsReceivedPingsPerUser)
+{
+    SystemState state;
+    state.AddUser(std::make_shared<User>("alice"));
+    state.AddUser(std::make_shared<User>("bob"));
+    state.AddUser(std::make_shared<User>("carol"));
+    state.RecordPing("bob", 4);
+    state.RecordPing("alice", 1);
+
+    std::stringstream buffer;
+    std::streambuf* original = std::cout.rdbuf();
+    std::cout.rdbuf(buffer.rdbuf());
+
+    GetPingStatsCommand cmd;
+    cmd.execute(state);
+
+    std::cout.rdbuf(original);
+
+    std::string output = buffer.str();
+    EXPECT_NE(output.find("GET PING STATS"), std::string::npos);
+    EXPECT_LT(output.find("alice: 1"), output.find("bob: 4"));
+    EXPECT_EQ(output.find("carol"), std::string::npos);
+    EXPECT_NE(output.find("Total sent: 5 (0 to unknown users)"), std::string::npos);
+}
+
+TEST(GetStatsCommandTest, PrintsCountsAndBytesPerComponent)
+{
+    SystemState state;
+    state.AddUser(std::make_shared<User>("alice"));
+    state.AddUser(std::make_shared<User>("bob"));
+    state.AddUserToGroup("bob", "team");
+    state.SendMessage("alice", Message("hi"));
+
+    std::stringstream buffer;
+    std::streambuf* original = std::cout.rdbuf();
+    std::cout.rdbuf(buffer.rdbuf());
+
+    GetStatsCommand cmd;
+    cmd.execute(state);
+
+    std::cout.rdbuf(original);
+
+    std::string output = buffer.str();
+    EXPECT_NE(output.find("GET STATS"), std::string::npos);
+    EXPECT_NE(output.find("users: 2, groups: 1, memberships: 1, messages: 1"), std::string::npos);
+    EXPECT_NE(output.find("message bodies: "), std::string::npos);
+    EXPECT_NE(output.find("Total: " + std::to_string(state.GetMemoryStats().TotalBytes()) + " bytes"), std::string::npos);
 }
\ No newline at end of file
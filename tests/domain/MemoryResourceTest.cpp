@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "domain/SystemState.h"
+
+#include <memory_resource>
+#include <string>
+
+using namespace Domain;
+
+namespace
+{
+    /**
+     * @brief Forwards to the global heap and counts what is still allocated.
+     */
+    class CountingResource : public std::pmr::memory_resource
+    {
+        public:
+            size_t allocations = 0;
+            size_t liveBytes = 0;
+
+        private:
+            void* do_allocate(size_t bytes, size_t alignment) override
+            {
+                ++allocations;
+                liveBytes += bytes;
+                return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            }
+
+            void do_deallocate(void* pointer, size_t bytes, size_t alignment) override
+            {
+                liveBytes -= bytes;
+                std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+            {
+                return this == &other;
+            }
+    };
+
+    /**
+     * @brief Makes every allocation from the default resource throw while alive, so a container
+     * that was not given the state's resource fails loudly.
+     */
+    class NoDefaultResource
+    {
+        public:
+            NoDefaultResource() : m_previous(std::pmr::set_default_resource(std::pmr::null_memory_resource())) {}
+            ~NoDefaultResource() { std::pmr::set_default_resource(m_previous); }
+
+        private:
+            std::pmr::memory_resource* m_previous;
+    };
+
+    /**
+     * @brief Runs every kind of change: enough users to split and merge index nodes, groups,
+     * sealed and trimmed message blocks, snapshots and a rolled back transaction.
+     */
+    void Exercise(SystemState& state)
+    {
+        state.SetRetentionPolicy({3 * MessageLog::BLOCK_SIZE, 0});
+        state.SetGroupRetentionPolicy("team", {2 * MessageLog::BLOCK_SIZE, 0});
+        for (int i = 0; i < 300; ++i)
+            state.AddUser(state.NewUser("user_with_a_long_enough_name_" + std::to_string(i)));
+        const auto before = state.Snapshot();
+        for (int i = 0; i < 300; i += 3)
+            state.AddUserToGroup("user_with_a_long_enough_name_" + std::to_string(i), "team");
+        for (int i = 0; i < 10 * static_cast<int>(MessageLog::BLOCK_SIZE); ++i)
+            state.SendMessage("user_with_a_long_enough_name_1", Message("direct message " + std::to_string(i)));
+        for (int i = 0; i < 3 * static_cast<int>(MessageLog::BLOCK_SIZE); ++i)
+            state.SendMessageToGroup("team", Message("group message " + std::to_string(i)));
+
+        state.BeginTransaction();
+        state.DeleteUser("user_with_a_long_enough_name_2");
+        state.RemoveUserFromGroup("user_with_a_long_enough_name_3", "team");
+        state.SendMessage("user_with_a_long_enough_name_1", Message("undone"));
+        state.RollbackTransaction();
+
+        const auto after = state.Snapshot();
+        for (int i = 0; i < 300; i += 2)
+            state.DeleteUser("user_with_a_long_enough_name_" + std::to_string(i));
+        state.Snapshot();
+    }
+}
+
+TEST(MemoryResourceTest, EveryNestedContainerUsesTheStateResource)
+{
+    CountingResource resource;
+    {
+        SystemState state(&resource);
+        EXPECT_EQ(state.GetMemoryResource(), &resource);
+        {
+            NoDefaultResource guard;
+            Exercise(state);
+        }
+        EXPECT_GT(resource.allocations, 0u);
+        EXPECT_GT(resource.liveBytes, 0u);
+        EXPECT_EQ(state.getMessageHistory("user_with_a_long_enough_name_1").size(), 3 * MessageLog::BLOCK_SIZE);
+    }
+    EXPECT_EQ(resource.liveBytes, 0u);
+}
+
+TEST(MemoryResourceTest, RunsOnAPoolResource)
+{
+    std::pmr::unsynchronized_pool_resource pool;
+    SystemState state(&pool);
+    Exercise(state);
+    EXPECT_EQ(state.getUsers().size(), 150u);
+    EXPECT_TRUE(state.isUserExists("user_with_a_long_enough_name_1"));
+    EXPECT_FALSE(state.isUserExists("user_with_a_long_enough_name_2"));
+    EXPECT_EQ(state.LatestSnapshot()->GetUsernameIndex().size(), 150u);
+}
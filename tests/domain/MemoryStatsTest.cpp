@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "domain/SystemState.h"
+
+#include <string>
+
+using namespace Domain;
+
+namespace
+{
+    /**
+     * @brief Recomputes from scratch the stats that SystemState maintains incrementally.
+     */
+    void ExpectMatchesRecount(const SystemState& state)
+    {
+        MemoryStats expected;
+        for (const auto& user : state.getUsers())
+        {
+            const auto& messages = user->getMessages();
+            ++expected.users;
+            expected.nameBytes += 3 * MemoryStats::HeapBytes(user->getUsername());
+            expected.membershipBytes += user->getGroups().capacity() * sizeof(std::weak_ptr<Group>);
+            expected.messages += messages.size() - messages.FirstIndex();
+            expected.messageBodyBytes += messages.BodyBytes();
+            expected.messageStorageBytes += messages.StorageBytes();
+        }
+        for (const auto& group : state.getGroups())
+        {
+            ++expected.groups;
+            expected.nameBytes += 2 * MemoryStats::HeapBytes(group->getGroupName());
+            expected.memberships += static_cast<size_t>(group->getMemberCount());
+            expected.membershipBytes += group->getMembers().capacity() * sizeof(std::shared_ptr<User>);
+        }
+
+        const MemoryStats actual = state.GetMemoryStats();
+        EXPECT_EQ(actual.users, expected.users);
+        EXPECT_EQ(actual.groups, expected.groups);
+        EXPECT_EQ(actual.memberships, expected.memberships);
+        EXPECT_EQ(actual.messages, expected.messages);
+        EXPECT_EQ(actual.nameBytes, expected.nameBytes);
+        EXPECT_EQ(actual.membershipBytes, expected.membershipBytes);
+        EXPECT_EQ(actual.messageBodyBytes, expected.messageBodyBytes);
+        EXPECT_EQ(actual.messageStorageBytes, expected.messageStorageBytes);
+    }
+}
+
+TEST(MemoryStatsTest, FollowsUsersGroupsAndMessages)
+{
+    SystemState state;
+    const MemoryStats empty = state.GetMemoryStats();
+    EXPECT_EQ(empty.users, 0u);
+    EXPECT_EQ(empty.messageBodyBytes + empty.messageStorageBytes + empty.nameBytes, 0u);
+
+    state.AddUser(std::make_shared<User>("alice"));
+    state.AddUser(std::make_shared<User>("a_rather_long_username_that_needs_the_heap"));
+    state.AddUserToGroup("alice", "team");
+    state.AddUserToGroup("a_rather_long_username_that_needs_the_heap", "team");
+    for (int i = 0; i < 10; ++i)
+        state.SendMessage("alice", Message("hello number " + std::to_string(i) + " with some padding text"));
+    state.SendMessageToGroup("team", Message("to everyone"));
+
+    ExpectMatchesRecount(state);
+    const MemoryStats stats = state.GetMemoryStats();
+    EXPECT_EQ(stats.users, 2u);
+    EXPECT_EQ(stats.groups, 1u);
+    EXPECT_EQ(stats.memberships, 2u);
+    EXPECT_EQ(stats.messages, 12u);
+    EXPECT_GT(stats.nameBytes, 0u);
+    EXPECT_GT(stats.messageBodyBytes, 0u);
+    EXPECT_GT(stats.messageStorageBytes, 0u);
+    EXPECT_GT(stats.hashTableBytes, 0u);
+    EXPECT_GT(stats.indexBytes, 0u);
+    EXPECT_EQ(stats.TotalBytes(), stats.nameBytes + stats.userObjectBytes + stats.groupObjectBytes + stats.membershipBytes
+                                  + stats.messageBodyBytes + stats.messageStorageBytes + stats.hashTableBytes + stats.indexBytes);
+
+    state.RemoveUserFromGroup("alice", "team");
+    state.RemoveUserFromGroup("a_rather_long_username_that_needs_the_heap", "team");
+    state.DeleteUser("alice");
+    state.DeleteUser("a_rather_long_username_that_needs_the_heap");
+    const MemoryStats deleted = state.GetMemoryStats();
+    EXPECT_EQ(deleted.users + deleted.groups + deleted.memberships + deleted.messages, 0u);
+    EXPECT_EQ(deleted.nameBytes + deleted.userObjectBytes + deleted.groupObjectBytes + deleted.membershipBytes, 0u);
+    EXPECT_EQ(deleted.messageBodyBytes + deleted.messageStorageBytes, 0u);
+}
+
+TEST(MemoryStatsTest, StaysInStepThroughTransactions)
+{
+    SystemState state;
+    state.AddUser(std::make_shared<User>("alice"));
+    state.AddUser(std::make_shared<User>("bob"));
+    state.AddUserToGroup("bob", "team");
+    state.SetRetentionPolicy({100, 0});
+    for (int i = 0; i < 150; ++i)
+        state.SendMessage("alice", Message("before " + std::to_string(i)));
+    ExpectMatchesRecount(state);
+    const MemoryStats before = state.GetMemoryStats();
+
+    state.BeginTransaction();
+    state.AddUser(std::make_shared<User>("carol"));
+    state.AddUserToGroup("alice", "team");
+    state.AddUserToGroup("carol", "others");
+    for (int i = 0; i < 300; ++i)
+        state.SendMessageToGroup("team", Message("during " + std::to_string(i)));
+    state.RemoveUserFromGroup("bob", "team");
+    state.DeleteUser("bob");
+    ExpectMatchesRecount(state);
+    state.RollbackTransaction();
+
+    ExpectMatchesRecount(state);
+    const MemoryStats after = state.GetMemoryStats();
+    EXPECT_EQ(after.users, before.users);
+    EXPECT_EQ(after.groups, before.groups);
+    EXPECT_EQ(after.memberships, before.memberships);
+    EXPECT_EQ(after.messages, before.messages);
+}
+
+TEST(MemoryStatsTest, SealingAndReleasingShrinkMessageBytes)
+{
+    MessageLog::SetCompressionEnabled(true);
+    SystemState state;
+    state.AddUser(std::make_shared<User>("alice"));
+    const std::string text(200, 'x');
+    for (size_t i = 0; i < 2 * MessageLog::BLOCK_SIZE; ++i)
+        state.SendMessage("alice", Message(text));
+    const MemoryStats hot = state.GetMemoryStats();
+
+    // Starting a third block seals the first one; its repetitive texts compress to almost nothing.
+    state.SendMessage("alice", Message(text));
+    const MemoryStats sealed = state.GetMemoryStats();
+    EXPECT_LT(sealed.messageBodyBytes + sealed.messageStorageBytes, hot.messageBodyBytes + hot.messageStorageBytes);
+
+    state.SetRetentionPolicy({1, 0});
+    state.SendMessage("alice", Message(text));
+    const MemoryStats trimmed = state.GetMemoryStats();
+    EXPECT_EQ(trimmed.messages, 1u);
+    EXPECT_LT(trimmed.messageStorageBytes, sealed.messageStorageBytes);
+    MessageLog::SetCompressionEnabled(false);
+}
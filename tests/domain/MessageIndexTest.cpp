@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include "domain/SystemState.h"
+
+#include <random>
+
+using namespace Domain;
+
+namespace
+{
+    using Found = std::vector<std::pair<std::string, size_t>>;
+
+    Found Search(const SystemState& state, std::string_view query)
+    {
+        Found found;
+        for (const auto& match : state.SearchMessages(query))
+            found.emplace_back(match.user->getUsername(), match.messageIndex);
+        return found;
+    }
+}
+
+TEST(MessageIndexTest, TokenizesIntoDistinctLowercaseTerms)
+{
+    EXPECT_EQ(MessageIndex::Tokenize("Server restart at 10:30, RESTART server!"),
+              (std::vector<std::string>{"10", "30", "at", "restart", "server"}));
+    EXPECT_TRUE(MessageIndex::Tokenize(" ,.! ").empty());
+    EXPECT_EQ(MessageIndex::Tokenize("caf\xc3\xa9"), std::vector<std::string>{"caf\xc3\xa9"});
+}
+
+TEST(MessageIndexTest, FindsMessagesWithEveryTerm)
+{
+    SystemState state;
+    state.SetMessageIndexEnabled(true);
+    for (const char* name : {"alice", "bob", "carol"})
+        state.AddUser(std::make_shared<User>(name));
+    state.AddUserToGroup("alice", "ops");
+    state.AddUserToGroup("carol", "ops");
+
+    state.SendMessage("bob", Message("Maintenance window tonight"));
+    state.SendMessageToGroup("ops", Message("maintenance done"));
+    state.SendMessage("alice", Message("Window cleaning tonight"));
+
+    EXPECT_EQ(Search(state, "MAINTENANCE"), (Found{{"alice", 0}, {"bob", 0}, {"carol", 0}}));
+    EXPECT_EQ(Search(state, "tonight window"), (Found{{"alice", 1}, {"bob", 0}}));
+    EXPECT_EQ(Search(state, "maintenance cleaning"), Found{});
+    EXPECT_EQ(Search(state, "unknown"), Found{});
+    EXPECT_EQ(Search(state, "!!"), Found{});
+
+    state.DeleteUser("bob");
+    EXPECT_EQ(Search(state, "tonight"), (Found{{"alice", 1}}));
+}
+
+TEST(MessageIndexTest, MatchesAFullScanUnderChurnAndRollback)
+{
+    const std::vector<std::string> words = {"alpha", "beta", "gamma", "delta", "omega"};
+    std::mt19937 random(7);
+
+    SystemState indexed;
+    SystemState scanned;
+    indexed.SetMessageIndexEnabled(true);
+    for (int step = 0; step < 3000; ++step)
+    {
+        const std::string name = "user" + std::to_string(random() % 40);
+        const unsigned action = random() % 10;
+        const std::string text = words[random() % 5] + " " + words[random() % 5] + " " + words[random() % 5];
+        for (SystemState* state : {&indexed, &scanned})
+        {
+            if (step % 100 == 0)
+                state->BeginTransaction();
+
+            if (!state->isUserExists(name))
+                state->AddUser(std::make_shared<User>(name));
+            else if (action == 0)
+                state->DeleteUser(name);
+            else if (action == 1 && !state->getGroups().empty())
+                state->SendMessageToGroup("all", Message(text));
+            else if (action == 2)
+            {
+                try { state->AddUserToGroup(name, "all"); } catch (...) {}
+            }
+            else
+                state->SendMessage(name, Message(text));
+
+            if (step % 100 == 60)
+                state->RollbackTransaction();
+            else if (step % 100 == 99)
+                state->CommitTransaction();
+        }
+    }
+
+    for (const auto& word : words)
+        EXPECT_EQ(Search(indexed, word), Search(scanned, word)) << word;
+    EXPECT_EQ(Search(indexed, "alpha omega"), Search(scanned, "alpha omega"));
+    EXPECT_FALSE(Search(indexed, "alpha").empty());
+    EXPECT_EQ(scanned.GetMessageIndex(), nullptr);
+}
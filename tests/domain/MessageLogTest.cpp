@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "domain/MessageLog.h"
+
+#include <string>
+#include <vector>
+
+using namespace Domain;
+
+namespace
+{
+    std::vector<std::string> Contents(const MessageLog& log)
+    {
+        std::vector<std::string> contents;
+        for (const Message& message : log)
+            contents.push_back(message.getContent());
+        return contents;
+    }
+}
+
+/**
+ * @brief Seals cold blocks, which is off by default.
+ */
+class MessageLogTest : public ::testing::Test
+{
+    protected:
+        void SetUp() override { MessageLog::SetCompressionEnabled(true); }
+        void TearDown() override { MessageLog::SetCompressionEnabled(false); }
+};
+
+TEST_F(MessageLogTest, SealsColdBlocksAndReadsThemBack)
+{
+    MessageLog log;
+    std::vector<std::string> expected;
+    const Message shared("sent to the whole group");
+    for (size_t i = 0; i < 10 * MessageLog::BLOCK_SIZE + 5; ++i)
+    {
+        if (i % 10 == 0)
+        {
+            log.Append(shared, i / 3);
+            expected.push_back(shared.getContent());
+        }
+        else
+        {
+            expected.push_back("message number " + std::to_string(i));
+            log.Append(Message(expected.back()), i / 3);
+        }
+    }
+
+    EXPECT_EQ(log.SealedBlockCount(), 10 - MessageLog::HOT_BLOCKS + 1);
+    EXPECT_EQ(Contents(log), expected);
+    EXPECT_EQ(log[3].getContent(), expected[3]);
+    EXPECT_EQ(log[130].getContent(), expected[130]);
+    for (size_t i = expected.size(); i-- > 0;)
+        EXPECT_EQ(log[i].getContent(), expected[i]) << i;
+    // Sealed blocks copy the shared body; only the 7 copies in the hot blocks keep a handle.
+    EXPECT_EQ(shared.getBody().use_count(), 8);
+    for (uint64_t epoch : {0u, 1u, 100u, 101u, 213u, 300u})
+        EXPECT_EQ(log.CountUpTo(epoch), std::min<size_t>(3 * epoch + 3, expected.size())) << epoch;
+}
+
+TEST_F(MessageLogTest, PopBackUnsealsAndKeepsAppending)
+{
+    MessageLog log;
+    std::vector<std::string> expected;
+    for (size_t i = 0; i < 4 * MessageLog::BLOCK_SIZE; ++i)
+    {
+        expected.push_back("m" + std::to_string(i));
+        log.Append(Message(expected.back()), i);
+    }
+    ASSERT_EQ(log.SealedBlockCount(), 2u);
+
+    for (size_t i = 0; i < 3 * MessageLog::BLOCK_SIZE + 1; ++i)
+    {
+        log.PopBack();
+        expected.pop_back();
+    }
+    EXPECT_EQ(log.SealedBlockCount(), 0u);
+    EXPECT_EQ(Contents(log), expected);
+
+    for (size_t i = 0; i < 2 * MessageLog::BLOCK_SIZE; ++i)
+    {
+        expected.push_back("again " + std::to_string(i));
+        log.Append(Message(expected.back()), 1000 + i);
+    }
+    EXPECT_EQ(Contents(log), expected);
+    EXPECT_EQ(log.CountUpTo(999), MessageLog::BLOCK_SIZE - 1);
+}
+
+TEST_F(MessageLogTest, KeepsEverythingHotWhenCompressionIsDisabled)
+{
+    MessageLog::SetCompressionEnabled(false);
+    MessageLog log;
+    for (size_t i = 0; i < 8 * MessageLog::BLOCK_SIZE; ++i)
+        log.Append(Message("text"), i);
+
+    EXPECT_EQ(log.SealedBlockCount(), 0u);
+    EXPECT_EQ(log.size(), 8 * MessageLog::BLOCK_SIZE);
+    EXPECT_EQ(log[8 * MessageLog::BLOCK_SIZE - 1].getContent(), "text");
+}
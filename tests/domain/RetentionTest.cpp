@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+#include "domain/SystemState.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Domain;
+
+namespace
+{
+    std::vector<std::string> Contents(const MessageHistoryView& history)
+    {
+        std::vector<std::string> contents;
+        for (const Message& message : history)
+            contents.push_back(message.getContent());
+        return contents;
+    }
+
+    std::vector<std::string> Numbered(size_t first, size_t last)
+    {
+        std::vector<std::string> texts;
+        for (size_t i = first; i < last; ++i)
+            texts.push_back("message " + std::to_string(i));
+        return texts;
+    }
+}
+
+/**
+ * @brief Seals cold blocks, so trimmed blocks show in SealedBlockCount() until released.
+ */
+class RetentionTest : public ::testing::Test
+{
+    protected:
+        void SetUp() override { MessageLog::SetCompressionEnabled(true); }
+        void TearDown() override { MessageLog::SetCompressionEnabled(false); }
+};
+
+TEST_F(RetentionTest, KeepsTheNewestMessagesAndFreesTrimmedBlocks)
+{
+    SystemState state;
+    auto alice = std::make_shared<User>("alice");
+    state.AddUser(alice);
+    state.SetRetentionPolicy({100, 0});
+    for (size_t i = 0; i < 10000; ++i)
+        state.SendMessage("alice", Message("message " + std::to_string(i)));
+
+    EXPECT_EQ(Contents(state.getMessageHistory("alice")), Numbered(9900, 10000));
+    EXPECT_EQ(state.getMessageHistory("alice")[0].getContent(), "message 9900");
+    EXPECT_EQ(alice->getMessages().FirstIndex(), 9900u);
+    EXPECT_LE(alice->getMessages().SealedBlockCount(), 1u);
+
+    uint64_t bytes = 0;
+    for (const auto& text : Numbered(9900, 10000))
+        bytes += text.size();
+    EXPECT_EQ(alice->getMessages().RetainedBytes(), bytes);
+}
+
+TEST_F(RetentionTest, EnforcesByteAndGroupPolicies)
+{
+    SystemState state;
+    for (const char* name : {"alice", "bob"})
+    {
+        state.AddUser(std::make_shared<User>(name));
+        state.AddUserToGroup(name, "team");
+    }
+    state.SetRetentionPolicy({0, 50});
+    for (int i = 0; i < 20; ++i)
+        state.SendMessage("alice", Message("0123456789"));
+    EXPECT_EQ(state.getMessageHistory("alice").size(), 5u);
+
+    state.SetGroupRetentionPolicy("team", {3, 0});
+    for (int i = 0; i < 10; ++i)
+        state.SendMessageToGroup("team", Message("g" + std::to_string(i)));
+    EXPECT_EQ(Contents(state.getMessageHistory("bob")), (std::vector<std::string>{"g7", "g8", "g9"}));
+
+    state.SendMessage("bob", Message("direct"));
+    EXPECT_EQ(state.getMessageHistory("bob").size(), 4u);
+}
+
+TEST_F(RetentionTest, OlderVersionsKeepReadingTheirMessages)
+{
+    SystemState state;
+    auto alice = std::make_shared<User>("alice");
+    state.AddUser(alice);
+    for (size_t i = 0; i < 1000; ++i)
+        state.SendMessage("alice", Message("message " + std::to_string(i)));
+
+    auto view = std::make_unique<MessageHistoryView>(state.Snapshot()->getMessageHistory("alice"));
+    state.SetRetentionPolicy({10, 0});
+    for (size_t i = 1000; i < 5000; ++i)
+        state.SendMessage("alice", Message("message " + std::to_string(i)));
+    state.PublishPending();
+    state.SendMessage("alice", Message("message 5000"));
+
+    EXPECT_EQ(Contents(*view), Numbered(0, 1000));
+    EXPECT_EQ(state.Snapshot()->getMessageHistory("alice").size(), 10u);
+    EXPECT_GT(alice->getMessages().SealedBlockCount(), 10u);
+
+    view.reset();
+    state.PublishPending();
+    state.SendMessage("alice", Message("message 5001"));
+    EXPECT_LE(alice->getMessages().SealedBlockCount(), 1u);
+    EXPECT_EQ(Contents(state.getMessageHistory("alice")), Numbered(4992, 5002));
+}
+
+TEST_F(RetentionTest, RollbackRestoresTrimmedMessages)
+{
+    SystemState state;
+    state.AddUser(std::make_shared<User>("alice"));
+    state.SetMessageIndexEnabled(true);
+    for (size_t i = 0; i < 300; ++i)
+        state.SendMessage("alice", Message("message " + std::to_string(i)));
+
+    state.SetRetentionPolicy({50, 0});
+    state.BeginTransaction();
+    for (size_t i = 300; i < 400; ++i)
+        state.SendMessage("alice", Message("message " + std::to_string(i)));
+    EXPECT_EQ(state.getMessageHistory("alice").size(), 50u);
+    state.RollbackTransaction();
+
+    EXPECT_EQ(Contents(state.getMessageHistory("alice")), Numbered(0, 300));
+    EXPECT_EQ(state.SearchMessages("message 7").size(), 1u);
+
+    for (size_t i = 300; i < 2000; ++i)
+        state.SendMessage("alice", Message("message " + std::to_string(i)));
+    EXPECT_EQ(Contents(state.getMessageHistory("alice")), Numbered(1950, 2000));
+    EXPECT_TRUE(state.SearchMessages("message 7").empty());
+    EXPECT_EQ(state.SearchMessages("message 1999").size(), 1u);
+    EXPECT_LE(state.GetMessageIndex()->GetDocumentCount(), 150u);
+}
+
+TEST_F(RetentionTest, ReadersOfPublishedVersionsRaceWithTrimming)
+{
+    SystemState state;
+    state.AddUser(std::make_shared<User>("alice"));
+    state.SetRetentionPolicy({200, 0});
+    state.Snapshot();
+    std::atomic<bool> done{false};
+
+    std::thread reader([&]()
+    {
+        while (!done.load())
+        {
+            const auto history = state.LatestSnapshot()->getMessageHistory("alice");
+            size_t previous = 0;
+            bool first = true;
+            for (const Message& message : history)
+            {
+                const size_t number = std::stoul(message.getContent().substr(8));
+                ASSERT_TRUE(first || number == previous + 1);
+                previous = number;
+                first = false;
+            }
+        }
+    });
+
+    for (size_t i = 0; i < 50000; ++i)
+    {
+        state.SendMessage("alice", Message("message " + std::to_string(i)));
+        if (i % 100 == 0)
+            state.PublishPending();
+    }
+    done = true;
+    reader.join();
+    EXPECT_EQ(state.getMessageHistory("alice").size(), 200u);
+}
+
+TEST_F(RetentionTest, SnapshotsKeepTheFirstMessageOfTheirEpoch)
+{
+    SystemState state;
+    state.AddUser(std::make_shared<User>("alice"));
+    for (size_t i = 0; i < 300; ++i)
+        state.SendMessage("alice", Message("message " + std::to_string(i)));
+    const auto before = state.Snapshot();
+
+    state.SetRetentionPolicy({50, 0});
+    state.BeginTransaction();
+    state.SendMessage("alice", Message("message 300"));
+    state.PublishPending();
+    EXPECT_EQ(Contents(state.LatestSnapshot()->getMessageHistory("alice")), Numbered(0, 300));
+    state.RollbackTransaction();
+    EXPECT_EQ(Contents(state.LatestSnapshot()->getMessageHistory("alice")), Numbered(0, 300));
+
+    state.SendMessage("alice", Message("message 300"));
+    const auto trimmed = state.Snapshot();
+    for (size_t i = 301; i < 1000; ++i)
+        state.SendMessage("alice", Message("message " + std::to_string(i)));
+    state.PublishPending();
+
+    EXPECT_EQ(Contents(before->getMessageHistory("alice")), Numbered(0, 300));
+    EXPECT_EQ(Contents(trimmed->getMessageHistory("alice")), Numbered(251, 301));
+    EXPECT_EQ(Contents(state.LatestSnapshot()->getMessageHistory("alice")), Numbered(950, 1000));
+}
+
+TEST_F(RetentionTest, CommittedTransactionsFreeTrimmedBlocks)
+{
+    SystemState state;
+    auto alice = std::make_shared<User>("alice");
+    auto bob = std::make_shared<User>("bob");
+    state.AddUser(alice);
+    state.AddUser(bob);
+    state.SetMessageIndexEnabled(true);
+    state.SetRetentionPolicy({100, 0});
+    state.Snapshot();
+
+    for (size_t batch = 0; batch < 20; ++batch)
+    {
+        state.BeginTransaction();
+        for (size_t i = 0; i < 500; ++i)
+            state.SendMessage("bob", Message("message " + std::to_string(batch * 500 + i)));
+        state.CommitTransaction();
+        state.PublishPending();
+        EXPECT_LE(bob->getMessages().SealedBlockCount(), 1u);
+    }
+    EXPECT_LE(state.GetMessageIndex()->GetDocumentCount(), 1000u);
+
+    auto reader = state.Snapshot();
+    state.BeginTransaction();
+    for (size_t i = 10000; i < 12000; ++i)
+        state.SendMessage("bob", Message("message " + std::to_string(i)));
+    state.CommitTransaction();
+    state.PublishPending();
+    EXPECT_GT(bob->getMessages().SealedBlockCount(), 10u);
+    EXPECT_EQ(reader->getMessageHistory("bob").size(), 100u);
+
+    reader.reset();
+    state.BeginTransaction();
+    state.SendMessage("alice", Message("hi"));
+    state.CommitTransaction();
+    EXPECT_LE(bob->getMessages().SealedBlockCount(), 1u);
+    EXPECT_EQ(Contents(state.getMessageHistory("bob")), Numbered(11900, 12000));
+    EXPECT_EQ(state.GetMemoryStats().messageStorageBytes, alice->getMessages().StorageBytes() + bob->getMessages().StorageBytes());
+}
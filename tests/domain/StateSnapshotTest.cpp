@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "domain/SystemState.h"
+#include "errorhandling/exceptions/AllExceptions.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace Domain;
+using namespace ErrorHandling::Exceptions;
+
+TEST(StateSnapshotTest, KeepsItsVersionWhileTheStateChanges)
+{
+    SystemState state;
+    state.AddUser(std::make_shared<User>("alice"));
+    state.AddUser(std::make_shared<User>("bob"));
+    state.AddUserToGroup("alice", "team");
+    state.SendMessage("alice", Message("first"));
+
+    const auto before = state.Snapshot();
+    state.SendMessage("alice", Message("second"));
+    state.DeleteUser("bob");
+    state.AddUser(std::make_shared<User>("carol"));
+    state.AddUserToGroup("carol", "team");
+    state.DisableUser("alice");
+    const auto after = state.Snapshot();
+
+    EXPECT_LT(before->GetEpoch(), after->GetEpoch());
+    EXPECT_EQ(before->GetUserCount(), 2u);
+    EXPECT_TRUE(before->isUserExists("bob"));
+    EXPECT_FALSE(before->isUserExists("carol"));
+    EXPECT_FALSE(before->FindUser("alice")->disabled);
+    ASSERT_EQ(before->getMessageHistory("alice").size(), 1u);
+    EXPECT_EQ(before->getMessageHistory("alice")[0].getContent(), "first");
+    EXPECT_EQ(before->GetGroupCount(), 1u);
+    ASSERT_NE(before->FindGroup("team"), nullptr);
+    EXPECT_EQ(before->FindGroup("team")->GetName(), "team");
+    EXPECT_EQ(before->FindGroup("team")->memberCount, 1);
+
+    EXPECT_EQ(after->GetUserCount(), 2u);
+    EXPECT_FALSE(after->isUserExists("bob"));
+    EXPECT_TRUE(after->isUserExists("carol"));
+    EXPECT_TRUE(after->FindUser("alice")->disabled);
+    EXPECT_EQ(after->FindUser("alice")->GetName(), "alice");
+    EXPECT_EQ(after->FindGroup("team")->memberCount, 2);
+    EXPECT_EQ(after->getMessageHistory("alice").size(), 2u);
+    EXPECT_THROW(after->getMessageHistory("bob"), UserNotFoundException);
+}
+
+TEST(StateSnapshotTest, DeletingByTheUsersOwnNamePublishesTheDeletion)
+{
+    SystemState state;
+    state.Snapshot();
+    std::weak_ptr<User> first;
+    for (int i = 0; i < 4096; ++i)
+    {
+        auto user = std::make_shared<User>("user_with_a_name_longer_than_sso_" + std::to_string(i));
+        state.AddUser(user);
+        if (i == 0)
+            first = user;
+    }
+
+    // The 4097th change publishes a version while DeleteUser runs, and the name it is given
+    // is owned by the user being deleted.
+    const std::string name(first.lock()->getUsername());
+    const std::string_view ownName = first.lock()->getUsername();
+    state.DeleteUser(ownName);
+    EXPECT_TRUE(first.expired());
+    EXPECT_FALSE(state.isUserExists(name));
+    EXPECT_FALSE(state.LatestSnapshot()->isUserExists(name));
+    EXPECT_EQ(state.LatestSnapshot()->GetUserCount(), 4095u);
+}
+
+TEST(StateSnapshotTest, SharesUnchangedShardsAndFreesOldVersions)
+{
+    SystemState state;
+    for (int i = 0; i < 1000; ++i)
+        state.AddUser(std::make_shared<User>("user" + std::to_string(i)));
+
+    std::weak_ptr<const StateSnapshot> first = state.Snapshot();
+    EXPECT_EQ(state.Snapshot(), first.lock());
+
+    state.DeleteUser("user1");
+    const auto second = state.Snapshot();
+    EXPECT_TRUE(first.expired());
+    EXPECT_EQ(second->GetUserCount(), 999u);
+    EXPECT_EQ(state.LatestSnapshot(), second);
+}
+
+TEST(StateSnapshotTest, ReadersSeeConsistentVersionsWhileAWriterPublishes)
+{
+    SystemState state;
+    state.Snapshot();
+    std::atomic<bool> done{false};
+
+    std::thread reader([&]()
+    {
+        while (!done.load())
+        {
+            const auto snapshot = state.LatestSnapshot();
+            // Every version published below adds exactly one user and one message to "user0".
+            const size_t users = snapshot->GetUserCount();
+            ASSERT_EQ(users, snapshot->GetEpoch() - 1);
+            if (users > 0)
+            {
+                ASSERT_EQ(snapshot->getMessageHistory("user0").size(), users);
+            }
+        }
+    });
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        state.AddUser(std::make_shared<User>("user" + std::to_string(i)));
+        state.SendMessage("user0", Message("message " + std::to_string(i)));
+        state.PublishPending();
+    }
+    done = true;
+    reader.join();
+    EXPECT_EQ(state.LatestSnapshot()->GetUserCount(), 2000u);
+}
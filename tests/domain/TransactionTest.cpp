@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "domain/SystemState.h"
+#include "errorhandling/exceptions/AllExceptions.h"
+
+using namespace Domain;
+using namespace ErrorHandling::Exceptions;
+
+namespace
+{
+    std::vector<std::string> MemberNames(const SystemState& state, const std::string& groupName)
+    {
+        for (const auto& group : state.getGroups())
+        {
+            if (group->getGroupName() != groupName)
+                continue;
+            std::vector<std::string> names;
+            for (const auto& member : group->getMembers())
+                names.emplace_back(member->getUsername());
+            return names;
+        }
+        return {};
+    }
+}
+
+TEST(TransactionTest, RollbackRestoresEveryChange)
+{
+    SystemState state;
+    state.AddUser(std::make_shared<User>("alice"));
+    state.AddUser(std::make_shared<User>("bob"));
+    state.AddUser(std::make_shared<User>("carol"));
+    state.AddUserToGroup("alice", "team");
+    state.AddUserToGroup("bob", "team");
+    state.AddUserToGroup("carol", "team");
+    state.AddUserToGroup("bob", "solo");
+    state.SendMessage("alice", Message("kept"));
+    state.RecordPing("alice", 2);
+
+    state.BeginTransaction();
+    state.AddUser(std::make_shared<User>("dave"));
+    state.AddUserToGroup("dave", "fresh");
+    state.RemoveUserFromGroup("bob", "team");
+    state.RemoveUserFromGroup("bob", "solo");
+    state.SendMessage("alice", Message("undone"));
+    state.SendMessageToGroup("team", Message("undone too"));
+    state.DisableUser("carol");
+    state.DeleteUser("alice");
+    state.RecordPing("bob", 5);
+    state.RecordPing("nobody", 1);
+    EXPECT_EQ(state.RollbackTransaction(), 11u);
+    EXPECT_FALSE(state.InTransaction());
+
+    EXPECT_FALSE(state.isUserExists("dave"));
+    EXPECT_TRUE(state.isUserExists("alice"));
+    EXPECT_EQ(state.getGroups().size(), 2u);
+    EXPECT_EQ(MemberNames(state, "team"), (std::vector<std::string>{"alice", "bob", "carol"}));
+    EXPECT_EQ(MemberNames(state, "solo"), (std::vector<std::string>{"bob"}));
+    ASSERT_EQ(state.getMessageHistory("alice").size(), 1u);
+    EXPECT_EQ(state.getMessageHistory("alice")[0].getContent(), "kept");
+    EXPECT_TRUE(state.getMessageHistory("carol").empty());
+
+    const auto stats = state.GetPingStats();
+    EXPECT_EQ(stats.pingsSent, 2u);
+    EXPECT_EQ(stats.pingsToUnknownUsers, 0u);
+    ASSERT_EQ(stats.receivedByUser.size(), 1u);
+    EXPECT_EQ(stats.receivedByUser[0].first, "alice");
+
+    for (const auto& user : state.getUsers())
+        EXPECT_FALSE(user->isDisabled());
+
+    state.SendMessage("alice", Message("after"));
+    EXPECT_EQ(state.getMessageHistory("alice")[1].getContent(), "after");
+}
+
+TEST(TransactionTest, CommitKeepsChangesAndRejectsNesting)
+{
+    SystemState state;
+    state.BeginTransaction();
+    EXPECT_THROW(state.BeginTransaction(), std::runtime_error);
+    state.AddUser(std::make_shared<User>("alice"));
+    state.CommitTransaction();
+
+    EXPECT_TRUE(state.isUserExists("alice"));
+    state.BeginTransaction();
+    EXPECT_EQ(state.RollbackTransaction(), 0u);
+    EXPECT_TRUE(state.isUserExists("alice"));
+}
+
+TEST(TransactionTest, ReadersNeverSeeChangesOfAnOpenTransaction)
+{
+    SystemState state;
+    state.AddUser(std::make_shared<User>("alice"));
+    const auto before = state.Snapshot();
+
+    state.BeginTransaction();
+    state.AddUser(std::make_shared<User>("bob"));
+    state.SendMessage("alice", Message("draft"));
+    const auto inside = state.Snapshot();
+    EXPECT_TRUE(inside->isUserExists("bob"));
+    EXPECT_EQ(inside->getMessageHistory("alice").size(), 1u);
+    EXPECT_EQ(state.LatestSnapshot(), before);
+
+    state.RollbackTransaction();
+    const auto after = state.LatestSnapshot();
+    EXPECT_GT(after->GetEpoch(), inside->GetEpoch());
+    EXPECT_FALSE(after->isUserExists("bob"));
+    EXPECT_TRUE(after->getMessageHistory("alice").empty());
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include "domain/UsernameIndex.h"
+
+#include <random>
+#include <set>
+
+using namespace Domain;
+
+namespace
+{
+    std::vector<std::string> Names(const UsernameIndex& index, std::string_view first = {})
+    {
+        std::vector<std::string> names;
+        index.ForEachFrom(first, [&](std::string_view name) { names.emplace_back(name); return true; });
+        return names;
+    }
+}
+
+TEST(UsernameIndexTest, MatchesAnOrderedSetUnderRandomChurn)
+{
+    UsernameIndex index;
+    std::set<std::string> expected;
+    std::mt19937 random(42);
+    std::vector<std::pair<std::shared_ptr<const UsernameIndex>, std::vector<std::string>>> versions;
+
+    for (int step = 0; step < 20000; ++step)
+    {
+        const std::string name = "user" + std::to_string(random() % 3000);
+        if (random() % 3 == 0)
+            EXPECT_EQ(index.Erase(name), expected.erase(name) == 1);
+        else
+            EXPECT_EQ(index.Insert(name), expected.insert(name).second);
+
+        if (step % 2500 == 0)
+            versions.emplace_back(index.Freeze(), std::vector<std::string>(expected.begin(), expected.end()));
+    }
+
+    EXPECT_EQ(index.size(), expected.size());
+    EXPECT_EQ(Names(index), std::vector<std::string>(expected.begin(), expected.end()));
+    EXPECT_EQ(Names(index, "user2"), std::vector<std::string>(expected.lower_bound("user2"), expected.end()));
+    for (const auto& [version, names] : versions)
+    {
+        EXPECT_EQ(version->size(), names.size());
+        EXPECT_EQ(Names(*version), names);
+    }
+
+    for (const auto& name : std::vector<std::string>(expected.begin(), expected.end()))
+        EXPECT_TRUE(index.Erase(name));
+    EXPECT_TRUE(index.empty());
+    EXPECT_TRUE(Names(index).empty());
+    EXPECT_EQ(Names(*versions.back().first), versions.back().second);
+}
+
+TEST(UsernameIndexTest, StopsWhenTheVisitorReturnsFalse)
+{
+    UsernameIndex index;
+    for (int i = 0; i < 500; ++i)
+        index.Insert("name" + std::to_string(1000 + i));
+
+    std::vector<std::string> page;
+    index.ForEachFrom("name1100", [&](std::string_view name) {
+        page.emplace_back(name);
+        return page.size() < 3;
+    });
+    EXPECT_EQ(page, (std::vector<std::string>{"name1100", "name1101", "name1102"}));
+    EXPECT_TRUE(index.Contains("name1499"));
+    EXPECT_FALSE(index.Contains("name1500"));
+}
@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 #include "parsec/parsec.hpp"
 #include "app/TaskManager.h"
+
+#include <iostream>
+#include <memory>
+#include <sstream>
 using namespace App;
 using namespace parsec;
 
@@ -244,3 +248,46 @@ TEST(CommandNameParserTest, WhenSendCommandThenSuccess)
     EXPECT_EQ(arguments.front(), "Javi");
     EXPECT_EQ(arguments.back(), "hello world");
 }
+
+TEST(ParserTests, CleanLineReturnsAViewIntoTheLine)
+{
+    const std::string line = "  PING alice 1   # note\r";
+    const auto cleaned = TasksParser::CleanLine(line);
+
+    EXPECT_EQ(cleaned, "PING alice 1");
+    EXPECT_EQ(cleaned.data(), line.data() + 2);
+    EXPECT_TRUE(TasksParser::CleanLine("   # only a comment").empty());
+    EXPECT_TRUE(TasksParser::CleanLine(" \t ").empty());
+}
+
+TEST(ParserTests, CreateProgramKeepsItsArgumentsInItsOwnPool)
+{
+    App::CommandRegistry registry;
+    TasksParser parser(registry);
+    auto lines = std::make_unique<std::vector<std::string>>(std::vector<std::string>{
+        "CREATE USER a_user_name_longer_than_the_small_string_buffer",
+        "ADD USER a_user_name_longer_than_the_small_string_buffer TO GROUP   \"a group, also with a long name\"",
+        "SEND MESSAGE a_user_name_longer_than_the_small_string_buffer \"hello\" # trailing comment",
+    });
+
+    auto program = parser.CreateProgram(*lines);
+    lines.reset();
+    ASSERT_EQ(program.records.size(), 3u);
+    ASSERT_TRUE(program.arguments);
+    EXPECT_EQ(program.arguments->GetBytes(), 3 * 47 + 30 + 5u);
+
+    std::stringstream output;
+    auto* original = std::cout.rdbuf(output.rdbuf());
+    auto state = std::make_shared<Domain::SystemState>();
+    App::TaskManager manager("");
+    manager.SetState(state);
+    const bool completed = manager.ExecuteProgram(program);
+    std::cout.rdbuf(original);
+
+    ASSERT_TRUE(completed);
+    const auto groups = state->getGroups();
+    ASSERT_EQ(groups.size(), 1u);
+    EXPECT_EQ(groups[0]->getGroupName(), "a group, also with a long name");
+    EXPECT_TRUE(groups[0]->hasMember("a_user_name_longer_than_the_small_string_buffer"));
+    EXPECT_EQ(state->getMessageHistory("a_user_name_longer_than_the_small_string_buffer").size(), 1u);
+}
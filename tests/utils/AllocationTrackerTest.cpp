@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "utils/AllocationTracker.h"
+#include "app/TaskManager.h"
+
+#include <memory>
+#include <thread>
+
+using namespace Utils;
+
+#ifdef USER_MGMT_TRACK_ALLOCATIONS
+
+TEST(AllocationTrackerTest, AttributesAllocationsToTheCurrentPhase)
+{
+    const auto before = AllocationTracker::Snapshot();
+    {
+        ScopedAllocationPhase phase(AllocationPhase::Load);
+        auto value = std::make_unique<std::array<char, 1000>>();
+        EXPECT_NE(value, nullptr);
+    }
+    const auto delta = AllocationTracker::Snapshot() - before;
+
+    EXPECT_EQ(delta[AllocationPhase::Load].allocations, 1u);
+    EXPECT_EQ(delta[AllocationPhase::Load].bytes, 1000u);
+    EXPECT_EQ(delta[AllocationPhase::Load].deallocations, 1u);
+}
+
+TEST(AllocationTrackerTest, KeepsCountsOfFinishedThreads)
+{
+    const auto before = AllocationTracker::Snapshot();
+    std::thread worker([]()
+    {
+        ScopedAllocationPhase phase(AllocationPhase::Parse);
+        std::vector<std::unique_ptr<std::string>> values;
+        values.reserve(10);
+        for (int i = 1; i < 10; ++i)
+            values.push_back(std::make_unique<std::string>(i, 'x'));
+    });
+    worker.join();
+    const auto delta = AllocationTracker::Snapshot() - before;
+
+    EXPECT_EQ(delta[AllocationPhase::Parse].allocations, 10u);
+    EXPECT_EQ(delta[AllocationPhase::Parse].deallocations, 10u);
+}
+
+TEST(AllocationTrackerTest, SplitsPipelinePhasesAndCommandTypes)
+{
+    std::stringstream output;
+    auto* original = std::cout.rdbuf(output.rdbuf());
+
+    App::CommandRegistry registry;
+    App::TasksParser parser(registry);
+    App::TaskManager manager("");
+    manager.SetState(std::make_shared<Domain::SystemState>());
+
+    const auto before = AllocationTracker::Snapshot();
+    auto program = parser.CreateProgram(std::vector<std::string>{"CREATE USER alice_with_a_long_name", "SEND MESSAGE alice_with_a_long_name \"a message longer than the small string buffer\""});
+    manager.ExecuteProgram(program);
+    const auto delta = AllocationTracker::Snapshot() - before;
+    std::cout.rdbuf(original);
+
+    EXPECT_GT(delta[AllocationPhase::Parse].allocations, 0u);
+    EXPECT_GT(delta[AllocationPhase::CreateCommand].allocations, 0u);
+    EXPECT_GT(delta[AllocationPhase::Execute].allocations, 0u);
+    EXPECT_GT(delta[AllocationPhase::Print].allocations, 0u);
+    EXPECT_GT(delta.commandTypes[program.records[0].index()].allocations, 0u);
+    EXPECT_GT(delta.commandTypes[program.records[1].index()].allocations, 0u);
+}
+
+TEST(AllocationTrackerTest, ParsedLinesCostNoAllocationsOfTheirOwn)
+{
+    App::CommandRegistry registry;
+    App::TasksParser parser(registry);
+    auto parseAllocations = [&](size_t count)
+    {
+        const std::vector<std::string_view> lines(count, "ADD USER a_user_name_longer_than_the_small_string_buffer TO GROUP \"administrators of the system\"");
+        const auto before = AllocationTracker::Snapshot();
+        auto program = parser.CreateProgram(lines);
+        const auto delta = AllocationTracker::Snapshot() - before;
+        EXPECT_EQ(program.records.size(), count);
+        return delta[AllocationPhase::Parse].allocations + delta[AllocationPhase::CreateCommand].allocations;
+    };
+
+    parseAllocations(1);
+    const size_t fewLines = parseAllocations(16);
+    EXPECT_EQ(parseAllocations(1024), fewLines);
+}
+
+#endif
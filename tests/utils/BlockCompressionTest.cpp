@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include "utils/BlockCompression.h"
+
+#include <random>
+#include <stdexcept>
+
+using namespace Utils;
+
+TEST(BlockCompressionTest, RoundTripsAndShrinksRepetitiveText)
+{
+    std::mt19937 random(7);
+    std::string noise(5000, '\0');
+    for (char& c : noise)
+        c = static_cast<char>(random());
+
+    std::string text;
+    for (int i = 0; i < 200; ++i)
+        text += "Meeting moved to " + std::to_string(i % 12) + ":30, see the agenda in the group chat. ";
+
+    for (const std::string& input : {std::string(), std::string("hi"), std::string(1000, 'a'), noise, text})
+    {
+        const auto compressed = CompressBlock(input);
+        EXPECT_EQ(DecompressBlock(compressed, input.size()), input);
+    }
+    EXPECT_LT(CompressBlock(text).size(), text.size() / 4);
+    EXPECT_LT(CompressBlock(noise).size(), noise.size() + noise.size() / 100 + 16);
+}
+
+TEST(BlockCompressionTest, RejectsCorruptInput)
+{
+    const std::string text(300, 'x');
+    auto compressed = CompressBlock(text);
+    EXPECT_THROW(DecompressBlock(compressed, text.size() + 1), std::runtime_error);
+
+    compressed.resize(compressed.size() - 2);
+    EXPECT_THROW(DecompressBlock(compressed, text.size()), std::runtime_error);
+
+    const std::vector<uint8_t> badOffset{0x10, 'a', 0x05, 0x00};
+    EXPECT_THROW(DecompressBlock(badOffset, 5), std::runtime_error);
+}
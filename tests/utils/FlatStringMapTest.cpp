@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "utils/FlatStringMap.h"
+
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+
+using Utils::FlatStringMap;
+
+TEST(FlatStringMapTest, MatchesAStdMapUnderRandomChurn)
+{
+    FlatStringMap<int> map;
+    std::map<std::string, int> expected;
+    std::mt19937 random(11);
+    for (int step = 0; step < 200000; ++step)
+    {
+        const std::string key = "key" + std::to_string(random() % 5000);
+        switch (random() % 3)
+        {
+            case 0:
+            {
+                const auto [it, inserted] = map.try_emplace(key, step);
+                const bool expectedInserted = expected.try_emplace(key, step).second;
+                ASSERT_EQ(inserted, expectedInserted);
+                ASSERT_EQ(it->second, expected.at(key));
+                break;
+            }
+            case 1:
+                ASSERT_EQ(map.erase(key), expected.erase(key));
+                break;
+            default:
+            {
+                const auto it = map.find(key);
+                ASSERT_EQ(it != map.end(), expected.count(key) == 1);
+                if (it != map.end())
+                {
+                    ASSERT_EQ(it->second, expected.at(key));
+                }
+                break;
+            }
+        }
+        ASSERT_EQ(map.size(), expected.size());
+    }
+
+    std::map<std::string, int> iterated;
+    for (const auto& [key, value] : map)
+        iterated.emplace(key, value);
+    EXPECT_EQ(iterated, expected);
+}
+
+TEST(FlatStringMapTest, LooksUpByViewAndKeepsKeysInItsResource)
+{
+    std::pmr::monotonic_buffer_resource arena;
+    FlatStringMap<std::unique_ptr<int>> map(&arena);
+    map.reserve(100);
+    const size_t capacity = map.capacity();
+    for (int i = 0; i < 100; ++i)
+        map.try_emplace("a key long enough to need the heap " + std::to_string(i), std::make_unique<int>(i));
+    EXPECT_EQ(map.capacity(), capacity);
+
+    const std::string_view view = "a key long enough to need the heap 42";
+    ASSERT_TRUE(map.contains(view));
+    EXPECT_EQ(*map.find(view)->second, 42);
+    EXPECT_EQ(map.find(view)->first.get_allocator().resource(), &arena);
+    EXPECT_FALSE(map.contains("a key long enough to need the heap 100"));
+
+    map.erase(map.find(view));
+    EXPECT_FALSE(map.contains(view));
+    EXPECT_EQ(map.size(), 99u);
+
+    FlatStringMap<std::unique_ptr<int>> moved(std::move(map));
+    EXPECT_EQ(moved.size(), 99u);
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.begin(), map.end());
+    moved.clear();
+    EXPECT_TRUE(moved.empty());
+    EXPECT_EQ(moved.begin(), moved.end());
+}
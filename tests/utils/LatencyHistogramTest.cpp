@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include "utils/LatencyHistogram.h"
+#include "app/TaskManager.h"
+
+using Utils::LatencyHistogram;
+
+TEST(LatencyHistogramTest, PercentilesAreWithinBucketPrecision)
+{
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 100000; ++value)
+        histogram.Record(value);
+
+    auto summary = histogram.Summarize();
+    EXPECT_EQ(summary.count, 100000u);
+    EXPECT_EQ(summary.max, 100000u);
+    EXPECT_NEAR(static_cast<double>(summary.p50), 50000.0, 50000.0 * 0.035);
+    EXPECT_NEAR(static_cast<double>(summary.p90), 90000.0, 90000.0 * 0.035);
+    EXPECT_NEAR(static_cast<double>(summary.p99), 99000.0, 99000.0 * 0.035);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExactAndHugeValuesAreClamped)
+{
+    LatencyHistogram histogram;
+    histogram.Record(uint64_t{7});
+    EXPECT_EQ(histogram.Percentile(100), 7u);
+    EXPECT_EQ(LatencyHistogram::BucketIndex(~uint64_t{0}), LatencyHistogram::BUCKET_COUNT - 1);
+
+    for (uint64_t value : {31ull, 32ull, 33ull, 1000ull, 123456789ull})
+        EXPECT_GE(LatencyHistogram::BucketUpperBound(LatencyHistogram::BucketIndex(value)), value);
+}
+
+TEST(LatencyHistogramTest, MergeAddsCounts)
+{
+    LatencyHistogram first;
+    LatencyHistogram second;
+    first.Record(uint64_t{100});
+    second.Record(uint64_t{5000});
+    first.Merge(second);
+    EXPECT_EQ(first.Count(), 2u);
+    EXPECT_EQ(first.Max(), 5000u);
+    first.Reset();
+    EXPECT_EQ(first.Count(), 0u);
+    EXPECT_EQ(first.Percentile(50), 0u);
+}
+
+#ifdef USER_MGMT_ENABLE_METRICS
+TEST(LatencyHistogramTest, TaskManagerReportsLatencyPerCommandType)
+{
+    std::stringstream output;
+    auto* original = std::cout.rdbuf(output.rdbuf());
+
+    App::CommandRegistry registry;
+    App::TasksParser parser(registry);
+    App::TaskManager manager("");
+    manager.SetState(std::make_shared<Domain::SystemState>());
+    auto parsed = parser.ParseProgram("latency", {"# comment", "CREATE USER alice", "CREATE USER bob", "PING alice 1"});
+    manager.ExecuteProgram(parsed[0].second);
+    std::cout.rdbuf(original);
+
+    auto execute = manager.GetExecuteLatencyReport();
+    ASSERT_EQ(execute.size(), 2u);
+    EXPECT_EQ(execute.at("CREATE USER").count, 2u);
+    EXPECT_EQ(execute.at("PING").count, 1u);
+
+    auto parse = parser.GetParseLatencyReport();
+    EXPECT_EQ(parse.at("COMMENT OR BLANK").count, 1u);
+    EXPECT_EQ(parse.at("CREATE USER").count, 2u);
+
+    manager.ResetLatencyMetrics();
+    EXPECT_TRUE(manager.GetExecuteLatencyReport().empty());
+}
+#endif
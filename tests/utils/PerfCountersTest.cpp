@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include "utils/PerfCounters.h"
+#include "app/TaskManager.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace Utils;
+
+namespace
+{
+    PerfCounts Counts(uint64_t cycles, uint64_t instructions, bool available = true)
+    {
+        PerfCounts counts;
+        counts.values = {cycles, instructions, 0, 0};
+        counts.available = {available, available, available, false};
+        return counts;
+    }
+}
+
+TEST(PerfCountersTest, SubtractsAndAccumulatesOnlyAvailableCounters)
+{
+    const auto delta = Counts(1500, 3000) - Counts(500, 1000);
+    EXPECT_EQ(delta[PerfEvent::Cycles], 1000u);
+    EXPECT_EQ(delta[PerfEvent::Instructions], 2000u);
+    EXPECT_FALSE(delta.Has(PerfEvent::BranchMisses));
+    EXPECT_DOUBLE_EQ(delta.InstructionsPerCycle(), 2.0);
+
+    PerfCounts total;
+    EXPECT_FALSE(total.Any());
+    total += delta;
+    total += delta;
+    EXPECT_TRUE(total.Has(PerfEvent::Cycles));
+    EXPECT_EQ(total[PerfEvent::Instructions], 4000u);
+}
+
+TEST(PerfCountersTest, ReadsZerosWhenCountersAreUnavailable)
+{
+    PerfCounterGroup counters;
+    const PerfCounts reading = counters.Read();
+    for (size_t i = 0; i < PerfCounts::EVENT_COUNT; ++i)
+    {
+        if (!reading.available[i])
+        {
+            EXPECT_EQ(reading.values[i], 0u);
+        }
+    }
+    EXPECT_EQ(counters.IsAvailable(), reading.Any());
+}
+
+TEST(PerfCountersTest, TaskManagerCollectsPerPhaseOnlyWhenEnabled)
+{
+    const auto dir = std::filesystem::temp_directory_path() / "perf_counters_test";
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "task.txt") << "CREATE USER alice\n";
+
+    App::TaskManager manager(dir.string());
+    manager.SetState(std::make_shared<Domain::SystemState>());
+    manager.RunTasksFromFiles();
+    EXPECT_FALSE(manager.GetPerfReport()[PerfPhase::Execute].Any());
+
+    manager.SetPerfCountersEnabled(true);
+    manager.SetState(std::make_shared<Domain::SystemState>());
+    manager.RunTasksFromFiles();
+    const bool available = PerfCounterGroup::ForCurrentThread().IsAvailable();
+    EXPECT_EQ(manager.GetPerfReport()[PerfPhase::Load].Any(), available);
+    EXPECT_EQ(manager.GetPerfReport()[PerfPhase::Execute].Any(), available);
+
+    std::filesystem::remove_all(dir);
+}
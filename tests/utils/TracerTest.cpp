@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "utils/Tracer.h"
+
+#include <sstream>
+#include <thread>
+
+using namespace Utils;
+
+TEST(TracerTest, RecordsNothingWhileStopped)
+{
+    Tracer::Start();
+    Tracer::Stop();
+    {
+        TraceSpan span("ignored", "test");
+    }
+    EXPECT_EQ(Tracer::EventCount(), 0u);
+}
+
+TEST(TracerTest, WritesSpansOfEveryThreadAsChromeTraceEvents)
+{
+    Tracer::Start();
+    {
+        TraceSpan span("load", "load", "task_1.txt");
+    }
+    std::thread worker([]()
+    {
+        TraceSpan span("parse", "parse");
+    });
+    worker.join();
+    Tracer::Stop();
+
+    EXPECT_EQ(Tracer::EventCount(), 2u);
+    std::ostringstream out;
+    Tracer::WriteChromeTrace(out);
+    const std::string json = out.str();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("\"name\":\"load\",\"cat\":\"load\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"detail\":\"task_1.txt\"}"), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"parse\",\"cat\":\"parse\",\"ph\":\"X\""), std::string::npos);
+}
+
+TEST(TracerTest, DropsEventsBeyondThePerThreadLimit)
+{
+    Tracer::Start(3);
+    for (int i = 0; i < 5000; ++i)
+        TraceSpan span("execute", "execute");
+    Tracer::Stop();
+
+    EXPECT_EQ(Tracer::EventCount(), 3u);
+    EXPECT_EQ(Tracer::DroppedEvents(), 4997u);
+}
+
+TEST(TracerTest, GrowsBeyondOneChunk)
+{
+    Tracer::Start();
+    for (int i = 0; i < 5000; ++i)
+        TraceSpan span("execute", "execute");
+    Tracer::Stop();
+
+    EXPECT_EQ(Tracer::EventCount(), 5000u);
+    EXPECT_EQ(Tracer::DroppedEvents(), 0u);
+}
+
+TEST(TracerTest, ReusesTheBuffersOfExitedThreads)
+{
+    auto threadCount = []()
+    {
+        std::ostringstream out;
+        Tracer::WriteChromeTrace(out);
+        const std::string json = out.str();
+        size_t count = 0;
+        for (size_t at = json.find("\"ph\":\"M\""); at != std::string::npos; at = json.find("\"ph\":\"M\"", at + 1))
+            ++count;
+        return count;
+    };
+
+    Tracer::Start();
+    {
+        TraceSpan span("main", "test");
+    }
+    const size_t before = threadCount();
+    for (int i = 0; i < 8; ++i)
+    {
+        std::thread worker([]()
+        {
+            TraceSpan span("parse", "parse");
+        });
+        worker.join();
+    }
+    Tracer::Stop();
+
+    EXPECT_EQ(Tracer::EventCount(), 9u);
+    EXPECT_LE(threadCount(), std::max<size_t>(before, 2));
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "workload/WorkloadGenerator.h"
+#include "app/TaskManager.h"
+
+#include <filesystem>
+#include <map>
+
+using namespace Workload;
+namespace fs = std::filesystem;
+
+namespace
+{
+    WorkloadSpec SmallSpec()
+    {
+        WorkloadSpec spec;
+        spec.seed = 42;
+        spec.files = 4;
+        spec.linesPerFile = 300;
+        spec.users = 200;
+        spec.groups = 8;
+        spec.groupsPerUser = 2;
+        return spec;
+    }
+}
+
+TEST(WorkloadGeneratorTest, SameSeedGivesSameFiles)
+{
+    WorkloadGenerator first(SmallSpec());
+    WorkloadGenerator second(SmallSpec());
+    auto otherSpec = SmallSpec();
+    otherSpec.seed = 7;
+    WorkloadGenerator other(otherSpec);
+
+    for (size_t file = 0; file <= 2; ++file)
+    {
+        auto lines = first.GenerateFile(file);
+        EXPECT_EQ(lines, second.GenerateFile(file));
+        if (file > 0)
+            EXPECT_NE(lines, other.GenerateFile(file));
+        else
+            other.GenerateFile(file);
+    }
+}
+
+TEST(WorkloadGeneratorTest, UserPopularityFollowsZipf)
+{
+    ZipfDistribution zipf(100, 1.0);
+    std::map<size_t, size_t> counts;
+    uint64_t bits = 0x12345678;
+    for (int i = 0; i < 100000; ++i)
+    {
+        bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+        ++counts[zipf(bits)];
+    }
+
+    // With exponent 1, rank 0 is drawn about twice as often as rank 1 and ten times as often as rank 9.
+    EXPECT_NEAR(static_cast<double>(counts[0]) / counts[1], 2.0, 0.2);
+    EXPECT_NEAR(static_cast<double>(counts[0]) / counts[9], 10.0, 1.5);
+}
+
+TEST(WorkloadGeneratorTest, GeneratedDirectoryRunsWithoutErrors)
+{
+    auto dir = fs::temp_directory_path() / "umts_workload";
+    fs::remove_all(dir);
+    WorkloadGenerator generator(SmallSpec());
+    const auto stats = generator.WriteDirectory(dir);
+    EXPECT_EQ(stats.files, 5u);
+    EXPECT_EQ(stats.injectedFailures, 0u);
+
+    std::stringstream output;
+    auto* original = std::cout.rdbuf(output.rdbuf());
+    App::TaskManager manager(dir.string());
+    auto state = std::make_shared<Domain::SystemState>();
+    manager.SetState(state);
+    manager.RunTasksFromFiles();
+    std::cout.rdbuf(original);
+
+    EXPECT_EQ(manager.GetLastRunStats().files, 5u);
+    EXPECT_EQ(manager.GetLastRunStats().failedFiles, 0u);
+    EXPECT_EQ(manager.GetLastRunStats().commands, stats.commands);
+    EXPECT_TRUE(state->isUserExists(WorkloadGenerator::UserName(199)));
+    fs::remove_all(dir);
+}
+
+TEST(WorkloadGeneratorTest, InjectsFailures)
+{
+    auto dir = fs::temp_directory_path() / "umts_workload_failures";
+    fs::remove_all(dir);
+    auto spec = SmallSpec();
+    spec.files = 12;
+    spec.failureRate = 0.002;
+    WorkloadGenerator generator(spec);
+    const auto stats = generator.WriteDirectory(dir);
+    EXPECT_GT(stats.injectedFailures, 0u);
+    EXPECT_LT(stats.injectedFailures, spec.files);
+
+    std::stringstream output;
+    auto* original = std::cout.rdbuf(output.rdbuf());
+    App::TaskManager manager(dir.string());
+    manager.SetState(std::make_shared<Domain::SystemState>());
+    manager.RunTasksFromFiles();
+    std::cout.rdbuf(original);
+
+    // Each failure ends its file, so it is the only error of the file and every line runs.
+    EXPECT_EQ(manager.GetLastRunStats().failedFiles, stats.injectedFailures);
+    EXPECT_EQ(manager.GetLastRunStats().commands, stats.commands);
+    fs::remove_all(dir);
+}
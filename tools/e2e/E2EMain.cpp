@@ -0,0 +1,347 @@
+#include "app/CommandRegistry.h"
+#include "app/TaskFileLoader.h"
+#include "app/TaskManager.h"
+#include "app/TasksParser.h"
+#include "commandresult/OutputPrinter.h"
+#include "errorhandling/ErrorHandler.h"
+#include "utils/AllocationTracker.h"
+#include "utils/ProcessStats.h"
+
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace App;
+using namespace TasksTypes;
+using CommandResult::OutputPrinter;
+using Utils::AllocationTracker;
+using Clock = std::chrono::steady_clock;
+namespace fs = std::filesystem;
+
+namespace
+{
+    /**
+     * @brief Wall time and allocations of one pipeline phase, accumulated over every file.
+     */
+    struct Phase
+    {
+        std::chrono::nanoseconds time{0};
+        size_t allocations = 0;
+        size_t bytes = 0;
+    };
+
+    /**
+     * @brief Adds the time and allocations of a scope to a phase.
+     */
+    class PhaseScope
+    {
+        public:
+            explicit PhaseScope(Phase& phase)
+                : m_phase(phase), m_allocations(AllocationTracker::Snapshot().Total()), m_start(Clock::now()) {}
+            ~PhaseScope()
+            {
+                m_phase.time += Clock::now() - m_start;
+                const auto allocations = AllocationTracker::Snapshot().Total();
+                m_phase.allocations += allocations.allocations - m_allocations.allocations;
+                m_phase.bytes += allocations.bytes - m_allocations.bytes;
+            }
+
+        private:
+            Phase& m_phase;
+            Utils::AllocationCounters m_allocations;
+            Clock::time_point m_start;
+    };
+
+    struct RunResult
+    {
+        Phase load, parse, execute, output;
+        Utils::AllocationReport allocations;
+        size_t files = 0;
+        size_t failedFiles = 0;
+        size_t commands = 0;
+    };
+
+    struct Options
+    {
+        std::string tasksPath = "../tasks";
+        std::string output = "null";
+        std::string json = "-";
+        std::string label;
+        unsigned repeat = 1;
+    };
+
+    /**
+     * @brief Runs the load → parse → execute → output pipeline once over the whole directory.
+     * Command output goes to an in-memory buffer during execution and is written to the sink
+     * afterwards, so printing is measured apart from the engine; "null" skips the buffer entirely.
+     */
+    RunResult RunPipeline(const Options& options, std::ostream* sink)
+    {
+        RunResult result;
+        const auto allocationsBefore = AllocationTracker::Snapshot();
+        TaskFileLoader loader(options.tasksPath);
+        CommandRegistry registry;
+        TasksParser parser(registry);
+        TaskManager manager(options.tasksPath);
+        manager.SetState(std::make_shared<Domain::SystemState>());
+
+        std::ostringstream buffer;
+        OutputPrinter::SetOutputStream(sink ? &buffer : nullptr);
+
+        ListOfTaskFileEntries entries;
+        {
+            PhaseScope scope(result.load);
+            entries = loader.ScanTaskFiles();
+        }
+
+        for (const auto& entry : entries)
+        {
+            std::optional<TaskSource> source;
+            {
+                PhaseScope scope(result.load);
+                source = loader.LoadSource(entry);
+            }
+            if (!source)
+                continue;
+
+            ++result.files;
+            CommandProgram program;
+            bool parsed = true;
+            {
+                PhaseScope scope(result.parse);
+                try
+                {
+                    program = source->compiled ? parser.CreateProgram(*source->compiled) : parser.CreateProgram(source->lines);
+                }
+                catch (const ErrorHandling::Exceptions::BaseException& e)
+                {
+                    OutputPrinter::PrintTaskStart(entry.fileName);
+                    ErrorHandling::Exceptions::ErrorHandler::Handle(e, "CreateCommandFromLine");
+                    OutputPrinter::PrintTaskFailure(entry.fileName);
+                    parsed = false;
+                }
+            }
+
+            bool succeeded = parsed;
+            if (parsed)
+            {
+                PhaseScope scope(result.execute);
+                const size_t executedBefore = manager.GetLastRunStats().commands;
+                OutputPrinter::PrintTaskStart(entry.fileName);
+                succeeded = manager.ExecuteProgram(program);
+                if (succeeded)
+                    OutputPrinter::PrintTaskSuccess(entry.fileName);
+                else
+                    OutputPrinter::PrintTaskFailure(entry.fileName);
+                result.commands += manager.GetLastRunStats().commands - executedBefore;
+            }
+            if (!succeeded)
+                ++result.failedFiles;
+
+            if (sink)
+            {
+                PhaseScope scope(result.output);
+                const std::string text = std::move(buffer).str();
+                sink->write(text.data(), static_cast<std::streamsize>(text.size()));
+                buffer.str({});
+            }
+        }
+
+        if (sink)
+        {
+            PhaseScope scope(result.output);
+            sink->flush();
+        }
+        OutputPrinter::SetOutputStream(&std::cout);
+        result.allocations = AllocationTracker::Snapshot() - allocationsBefore;
+        return result;
+    }
+
+    std::string JsonString(const std::string& value)
+    {
+        std::string escaped = "\"";
+        for (char c : value)
+        {
+            if (c == '"' || c == '\\')
+                escaped += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20)
+                escaped += c;
+        }
+        return escaped + "\"";
+    }
+
+    double Milliseconds(std::chrono::nanoseconds time)
+    {
+        return std::chrono::duration<double, std::milli>(time).count();
+    }
+
+    void WritePhase(std::ostream& out, const char* name, const Phase& phase, bool last = false)
+    {
+        out << "        " << JsonString(name) << ": {\"ms\": " << Milliseconds(phase.time)
+            << ", \"allocations\": " << phase.allocations << ", \"bytes\": " << phase.bytes << "}" << (last ? "\n" : ",\n");
+    }
+
+    void WriteJson(std::ostream& out, const Options& options, const std::vector<RunResult>& runs)
+    {
+        out << "{\n  \"label\": " << JsonString(options.label)
+            << ",\n  \"tasks\": " << JsonString(fs::absolute(options.tasksPath).string())
+            << ",\n  \"output\": " << JsonString(options.output)
+            << ",\n  \"peak_rss_bytes\": " << Utils::PeakResidentBytes()
+            << ",\n  \"runs\": [\n";
+
+        for (size_t i = 0; i < runs.size(); ++i)
+        {
+            const RunResult& run = runs[i];
+            const auto total = run.load.time + run.parse.time + run.execute.time + run.output.time;
+            const size_t allocations = run.load.allocations + run.parse.allocations + run.execute.allocations + run.output.allocations;
+            const double seconds = std::chrono::duration<double>(total).count();
+
+            out << "    {\n      \"files\": " << run.files << ", \"failed_files\": " << run.failedFiles
+                << ", \"commands\": " << run.commands
+                << ",\n      \"total_ms\": " << Milliseconds(total)
+                << ", \"commands_per_sec\": " << (seconds > 0 ? static_cast<double>(run.commands) / seconds : 0.0)
+                << ", \"allocations_per_command\": "
+                << (run.commands ? static_cast<double>(run.parse.allocations + run.execute.allocations) / static_cast<double>(run.commands) : 0.0)
+                << ", \"allocations\": " << allocations
+                << ",\n      \"phases\": {\n";
+            WritePhase(out, "load", run.load);
+            WritePhase(out, "parse", run.parse);
+            WritePhase(out, "execute", run.execute);
+            WritePhase(out, "output", run.output, true);
+            out << "      },\n      \"allocations_by_phase\": {";
+            for (size_t phase = 0; phase < run.allocations.phases.size(); ++phase)
+            {
+                const auto& counters = run.allocations.phases[phase];
+                out << (phase ? ", " : "") << JsonString(AllocationTracker::PhaseName(static_cast<Utils::AllocationPhase>(phase)))
+                    << ": {\"allocations\": " << counters.allocations << ", \"bytes\": " << counters.bytes << "}";
+            }
+            out << "},\n      \"allocations_by_command\": {";
+            bool first = true;
+            for (size_t type = 0; type < Commands::COMMAND_RECORD_NAMES.size(); ++type)
+            {
+                const auto& counters = run.allocations.commandTypes[type];
+                if (counters.allocations == 0)
+                    continue;
+                out << (first ? "" : ", ") << JsonString(Commands::COMMAND_RECORD_NAMES[type])
+                    << ": {\"allocations\": " << counters.allocations << ", \"bytes\": " << counters.bytes << "}";
+                first = false;
+            }
+            out << "}\n    }" << (i + 1 < runs.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+    }
+
+    void PrintUsage()
+    {
+        std::cout << "Usage: user_mgmt_e2e [options]\n\n"
+                  << "  --tasks DIR     Task directory, e.g. written by user_mgmt_taskgen (default: ../tasks)\n"
+                  << "  --output SINK   'null' (default, output discarded), '-' (stdout, needs --json FILE) or a file path\n"
+                  << "  --json FILE     Where to write the JSON report (default: '-', stdout)\n"
+                  << "  --label TEXT    Free text stored in the report, e.g. the commit id\n"
+                  << "  --repeat N      Runs the pipeline N times on fresh state (default: 1)\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    const std::vector<std::string> arguments(argv + 1, argv + argc);
+    for (size_t i = 0; i < arguments.size(); ++i)
+    {
+        const std::string& option = arguments[i];
+        if (option == "--help" || option == "-h")
+        {
+            PrintUsage();
+            return EXIT_SUCCESS;
+        }
+        if (i + 1 >= arguments.size())
+        {
+            std::cerr << "❌ " << option << ": missing value\n\n";
+            PrintUsage();
+            return 2;
+        }
+
+        const std::string& value = arguments[++i];
+        if (option == "--tasks")
+            options.tasksPath = value;
+        else if (option == "--output")
+            options.output = value;
+        else if (option == "--json")
+            options.json = value;
+        else if (option == "--label")
+            options.label = value;
+        else if (option == "--repeat")
+        {
+            auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), options.repeat);
+            if (error != std::errc() || end != value.data() + value.size() || options.repeat == 0)
+            {
+                std::cerr << "❌ --repeat: invalid value '" << value << "'\n";
+                return 2;
+            }
+        }
+        else
+        {
+            std::cerr << "❌ " << option << ": unknown option\n\n";
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    if (!fs::is_directory(options.tasksPath))
+    {
+        std::cerr << "❌ Path does not exist: " << options.tasksPath << "\n";
+        return 2;
+    }
+
+    if (options.output == "-" && options.json == "-")
+    {
+        std::cerr << "❌ --output - and --json - would mix command output and the report on stdout\n";
+        return 2;
+    }
+
+    std::ofstream outputFile;
+    std::ostream* sink = nullptr;
+    if (options.output == "-")
+        sink = &std::cout;
+    else if (options.output != "null")
+    {
+        outputFile.open(options.output, std::ios::binary | std::ios::trunc);
+        if (!outputFile)
+        {
+            std::cerr << "❌ Cannot open output file: " << options.output << "\n";
+            return 2;
+        }
+        sink = &outputFile;
+    }
+
+    std::ofstream jsonFile;
+    if (options.json != "-")
+    {
+        jsonFile.open(options.json, std::ios::trunc);
+        if (!jsonFile)
+        {
+            std::cerr << "❌ Cannot open JSON report file: " << options.json << "\n";
+            return 2;
+        }
+    }
+
+    std::vector<RunResult> runs;
+    for (unsigned run = 0; run < options.repeat; ++run)
+        runs.push_back(RunPipeline(options, sink));
+
+    std::ostream& json = options.json == "-" ? std::cout : jsonFile;
+    WriteJson(json, options, runs);
+    json.flush();
+    if (!json || (outputFile.is_open() && !outputFile.flush()))
+    {
+        std::cerr << "❌ Could not write the results\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
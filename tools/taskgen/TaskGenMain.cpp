@@ -0,0 +1,139 @@
+#include "workload/WorkloadGenerator.h"
+
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Workload;
+
+namespace
+{
+    template <typename T>
+    T ParseNumber(const std::string& option, const std::string& value)
+    {
+        T number{};
+        auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), number);
+        if (error != std::errc() || end != value.data() + value.size() || number < T{})
+            throw std::invalid_argument(option + ": invalid value '" + value + "'");
+        return number;
+    }
+
+    void ParseMix(const std::string& value, CommandMix& mix)
+    {
+        const std::map<std::string, double*> weights = {
+            {"create", &mix.createUser}, {"delete", &mix.deleteUser}, {"disable", &mix.disableUser},
+            {"send", &mix.sendMessage}, {"add", &mix.addUserToGroup}, {"remove", &mix.removeUserFromGroup},
+            {"ping", &mix.ping}, {"history", &mix.getMessageHistory}, {"users", &mix.getUsers},
+            {"groups", &mix.getGroups}};
+
+        for (auto& [name, weight] : weights)
+            *weight = 0;
+
+        std::stringstream items(value);
+        std::string item;
+        while (std::getline(items, item, ','))
+        {
+            const auto separator = item.find('=');
+            auto itr = weights.find(item.substr(0, separator));
+            if (separator == std::string::npos || itr == weights.end())
+                throw std::invalid_argument("--mix: invalid entry '" + item + "'");
+            *itr->second = ParseNumber<double>("--mix", item.substr(separator + 1));
+        }
+    }
+
+    void PrintUsage()
+    {
+        std::cout << "Usage: user_mgmt_taskgen --out DIR [options]\n\n"
+                  << "  --seed N                Random seed (default: 1)\n"
+                  << "  --files N               Command files besides the bootstrap file (default: 10)\n"
+                  << "  --lines N               Lines per command file (default: 1000)\n"
+                  << "  --users N               Users created by the bootstrap file (default: 1000)\n"
+                  << "  --groups N              Groups (default: 32)\n"
+                  << "  --groups-per-user N     Bootstrap memberships per user (default: 1)\n"
+                  << "  --user-zipf S           Zipf exponent of user popularity (default: 1.0)\n"
+                  << "  --group-zipf S          Zipf exponent of group sizes and popularity (default: 1.0)\n"
+                  << "  --message-mean N        Mean message length in characters (default: 32)\n"
+                  << "  --message-max N         Maximum message length (default: 256)\n"
+                  << "  --quoted P              Share of quoted multi-word messages (default: 0.8)\n"
+                  << "  --comments P            Share of comment-only lines (default: 0.05)\n"
+                  << "  --trailing-comments P   Share of commands with a trailing comment (default: 0.05)\n"
+                  << "  --failure-rate P        Chance that a command fails on purpose, ending its file (default: 0)\n"
+                  << "  --mix k=w,...           Command weights; keys: create delete disable send add remove\n"
+                  << "                          ping history users groups (unlisted keys get 0)\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    WorkloadSpec spec;
+    std::string outputDirectory;
+
+    try
+    {
+        const std::vector<std::string> arguments(argv + 1, argv + argc);
+        const std::map<std::string, std::function<void(const std::string&)>> options = {
+            {"--out", [&](const std::string& v) { outputDirectory = v; }},
+            {"--seed", [&](const std::string& v) { spec.seed = ParseNumber<uint64_t>("--seed", v); }},
+            {"--files", [&](const std::string& v) { spec.files = ParseNumber<size_t>("--files", v); }},
+            {"--lines", [&](const std::string& v) { spec.linesPerFile = ParseNumber<size_t>("--lines", v); }},
+            {"--users", [&](const std::string& v) { spec.users = ParseNumber<size_t>("--users", v); }},
+            {"--groups", [&](const std::string& v) { spec.groups = ParseNumber<size_t>("--groups", v); }},
+            {"--groups-per-user", [&](const std::string& v) { spec.groupsPerUser = ParseNumber<size_t>("--groups-per-user", v); }},
+            {"--user-zipf", [&](const std::string& v) { spec.userZipfExponent = ParseNumber<double>("--user-zipf", v); }},
+            {"--group-zipf", [&](const std::string& v) { spec.groupZipfExponent = ParseNumber<double>("--group-zipf", v); }},
+            {"--message-mean", [&](const std::string& v) { spec.meanMessageLength = ParseNumber<size_t>("--message-mean", v); }},
+            {"--message-max", [&](const std::string& v) { spec.maxMessageLength = ParseNumber<size_t>("--message-max", v); }},
+            {"--quoted", [&](const std::string& v) { spec.quotedMessageDensity = ParseNumber<double>("--quoted", v); }},
+            {"--comments", [&](const std::string& v) { spec.commentLineDensity = ParseNumber<double>("--comments", v); }},
+            {"--trailing-comments", [&](const std::string& v) { spec.trailingCommentDensity = ParseNumber<double>("--trailing-comments", v); }},
+            {"--failure-rate", [&](const std::string& v) { spec.failureRate = ParseNumber<double>("--failure-rate", v); }},
+            {"--mix", [&](const std::string& v) { ParseMix(v, spec.mix); }},
+        };
+
+        for (size_t i = 0; i < arguments.size(); ++i)
+        {
+            if (arguments[i] == "--help" || arguments[i] == "-h")
+            {
+                PrintUsage();
+                return EXIT_SUCCESS;
+            }
+            auto itr = options.find(arguments[i]);
+            if (itr == options.end() || i + 1 >= arguments.size())
+                throw std::invalid_argument(arguments[i] + ": unknown option or missing value");
+            itr->second(arguments[++i]);
+        }
+        if (outputDirectory.empty())
+            throw std::invalid_argument("--out is required");
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "❌ " << e.what() << "\n\n";
+        PrintUsage();
+        return 2;
+    }
+
+    try
+    {
+        const auto start = std::chrono::steady_clock::now();
+        WorkloadGenerator generator(spec);
+        const WorkloadStats stats = generator.WriteDirectory(outputDirectory);
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cerr << "[Workload] " << stats.files << " files, " << stats.lines << " lines, " << stats.commands
+                  << " commands (" << stats.injectedFailures << " injected failures), " << stats.bytes
+                  << " bytes written to " << outputDirectory << " in " << elapsed << " s\n";
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "❌ " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}